@@ -1,9 +1,10 @@
 #pragma once
 
+#include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
+#include "InlineFunction.h"
 #include "SlotMap.h"
 #include "TrackedObject.h"
 
@@ -12,7 +13,7 @@ namespace AxiomCommon {
     template<class... Args>
     class Event {
     public:
-        using FuncType = std::function<void(Args...)>;
+        using FuncType = InlineFunction<void(Args...)>;
         using EventId = typename SlotMap<FuncType>::key;
 
     private:
@@ -39,12 +40,15 @@ namespace AxiomCommon {
         };
 
     public:
-        Event() : data(std::make_unique<EventData>()) {}
+        // Most events never have anything connected, so the listener storage is only allocated on the first connect.
+        Event() = default;
 
-        void operator()(const Args &... params) { data->dispatch(params...); }
+        void operator()(const Args &... params) {
+            if (data) data->dispatch(params...);
+        }
 
         // call the provided function when the event is triggered
-        EventId connect(FuncType listener) { return data->connections.insert(std::move(listener)); }
+        EventId connect(FuncType listener) { return getData()->connections.insert(std::move(listener)); }
 
         // call the provided function when the event is triggered, automatically disconnecting when the
         // provided object is destructed
@@ -58,39 +62,46 @@ namespace AxiomCommon {
         template<class TB, class TFB, class TR, class... TA>
         EventId connect(TB *follow, TR (TFB::*listener)(TA...)) {
             return connect(follow, [follow, listener](Args... params) {
-                auto wrapper = std::mem_fn(listener);
-                applyFunc<sizeof...(TA) + 1>(wrapper, follow, std::forward<Args>(params)...);
+                applyFunc<sizeof...(TA) + 1>(listener, follow, std::forward<Args>(params)...);
             });
         }
 
         template<class TB, class TFB, class TR, class... TA>
         EventId connect(TB *follow, TR (TFB::*listener)(TA...) const) {
             return connect(follow, [follow, listener](Args... params) {
-                auto wrapper = std::mem_fn(listener);
-                applyFunc<sizeof...(TA) + 1>(wrapper, follow, std::forward<Args>(params)...);
+                applyFunc<sizeof...(TA) + 1>(listener, follow, std::forward<Args>(params)...);
             });
         }
 
         // trigger the provided event when this event is triggered
         EventId forward(Event *event) {
             // data is guaranteed to not move
-            auto dataPtr = event->data.get();
+            auto dataPtr = event->getData();
             return connect(dataPtr, [dataPtr](Args... params) { dataPtr->dispatch(params...); });
         }
 
-        void disconnect(EventId event) { data->disconnect(event); }
+        void disconnect(EventId event) {
+            if (data) data->disconnect(event);
+        }
 
-        void disconnectAll() { data->connections.clear(); }
+        void disconnectAll() {
+            if (data) data->connections.clear();
+        }
 
     private:
         std::unique_ptr<EventData> data;
 
+        EventData *getData() {
+            if (!data) data = std::make_unique<EventData>();
+            return data.get();
+        }
+
         // Utilities that allow us to call a function with more arguments than it needs
         // e.g. calling void myFunc(int) as myFunc(5, "hello", 2.6);
         // Useful for events, since often the event user doesn't care about some arguments.
         template<class Func, size_t... I, class... PassArgs>
         static void applyFuncIndexed(const Func &func, std::index_sequence<I...>, PassArgs &&... params) {
-            func(std::get<I>(std::make_tuple(std::forward<PassArgs>(params)...))...);
+            std::invoke(func, std::get<I>(std::make_tuple(std::forward<PassArgs>(params)...))...);
         }
 
         template<size_t ArgCount, class Func, class... PassArgs>
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace AxiomCommon {
+
+    template<class Signature, size_t Capacity = 4 * sizeof(void *)>
+    class InlineFunction;
+
+    // A move-only replacement for std::function that stores callables up to Capacity bytes inside the object instead
+    // of on the heap. Member function bindings (an object pointer and a member pointer) always fit, so connecting
+    // and dispatching them doesn't allocate or chase a pointer to find the target.
+    template<class R, class... Args, size_t Capacity>
+    class InlineFunction<R(Args...), Capacity> {
+    public:
+        InlineFunction() = default;
+
+        template<class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineFunction> &&
+                                                   std::is_invocable_r_v<R, std::decay_t<F> &, Args...>>>
+        InlineFunction(F &&func) {
+            using Func = std::decay_t<F>;
+            if constexpr (fitsInline<Func>()) {
+                new (&storage) Func(std::forward<F>(func));
+                table = &inlineTable<Func>;
+            } else {
+                new (&storage) Func *(new Func(std::forward<F>(func)));
+                table = &heapTable<Func>;
+            }
+        }
+
+        InlineFunction(InlineFunction &&other) noexcept : table(other.table) {
+            if (table) {
+                table->move(&storage, &other.storage);
+                other.table = nullptr;
+            }
+        }
+
+        InlineFunction &operator=(InlineFunction &&other) noexcept {
+            if (this != &other) {
+                reset();
+                table = other.table;
+                if (table) {
+                    table->move(&storage, &other.storage);
+                    other.table = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        InlineFunction(const InlineFunction &) = delete;
+
+        InlineFunction &operator=(const InlineFunction &) = delete;
+
+        ~InlineFunction() { reset(); }
+
+        explicit operator bool() const { return table != nullptr; }
+
+        R operator()(Args... args) const { return table->invoke(&storage, std::forward<Args>(args)...); }
+
+    private:
+        struct Table {
+            R (*invoke)(void *storage, Args &&... args);
+            void (*move)(void *dest, void *src);
+            void (*destroy)(void *storage);
+        };
+
+        template<class Func>
+        static constexpr bool fitsInline() {
+            return sizeof(Func) <= Capacity && alignof(Func) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible_v<Func>;
+        }
+
+        template<class Func>
+        static constexpr Table inlineTable = {
+            [](void *storage, Args &&... args) -> R {
+                return (*static_cast<Func *>(storage))(std::forward<Args>(args)...);
+            },
+            [](void *dest, void *src) {
+                new (dest) Func(std::move(*static_cast<Func *>(src)));
+                static_cast<Func *>(src)->~Func();
+            },
+            [](void *storage) { static_cast<Func *>(storage)->~Func(); }};
+
+        template<class Func>
+        static constexpr Table heapTable = {
+            [](void *storage, Args &&... args) -> R {
+                return (**static_cast<Func **>(storage))(std::forward<Args>(args)...);
+            },
+            [](void *dest, void *src) { new (dest) Func *(*static_cast<Func **>(src)); },
+            [](void *storage) { delete *static_cast<Func **>(storage); }};
+
+        mutable std::aligned_storage_t<Capacity, alignof(std::max_align_t)> storage;
+        const Table *table = nullptr;
+
+        void reset() {
+            if (table) {
+                table->destroy(&storage);
+                table = nullptr;
+            }
+        }
+    };
+}
@@ -0,0 +1,257 @@
+#include "ArenaMemoryManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <unordered_set>
+#include <llvm/Support/MathExtras.h>
+#include <llvm/Support/Process.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static uint8_t *mapPages(size_t size) {
+#ifdef _WIN32
+    return (uint8_t *) VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    auto address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return address == MAP_FAILED ? nullptr : (uint8_t *) address;
+#endif
+}
+
+static void unmapPages(uint8_t *address, size_t size) {
+#ifdef _WIN32
+    (void) size;
+    VirtualFree(address, 0, MEM_RELEASE);
+#else
+    munmap(address, size);
+#endif
+}
+
+static bool lockPages(uint8_t *address, size_t size) {
+#ifdef _WIN32
+    return VirtualLock(address, size) != 0;
+#else
+    return mlock(address, size) == 0;
+#endif
+}
+
+// Writes to every page in the range, so they're all backed by real memory. Locking pages does this too, but it can fail
+// if the process is over its limit of locked memory.
+static void prefaultPages(uint8_t *address, size_t size, size_t pageSize) {
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        auto page = (volatile uint8_t *) (address + offset);
+        *page = *page;
+    }
+}
+
+static uint8_t *alignAddress(uint8_t *address, size_t alignment) {
+    return (uint8_t *) (((uintptr_t) address + alignment - 1) & ~(uintptr_t) (alignment - 1));
+}
+
+JitArena::JitArena(size_t chunkSize, bool useHugePages)
+    : pageSize(llvm::sys::Process::getPageSize()), chunkSize(chunkSize), useHugePages(useHugePages) {
+    // map the first chunk up front, so the first modules don't have to wait for it
+    std::lock_guard<std::mutex> lock(mutex);
+    addChunk(0);
+}
+
+JitArena::~JitArena() {
+    for (const auto &chunk : chunks) {
+        unmapPages(chunk.base, chunk.size);
+    }
+}
+
+llvm::sys::MemoryBlock JitArena::allocate(size_t size) {
+    size = llvm::alignTo(size, pageSize);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &chunk : chunks) {
+        auto block = allocateFromChunk(chunk, size);
+        if (block.base()) return block;
+    }
+
+    // nothing fits, so grow the arena by a chunk that's big enough for the block
+    if (!addChunk(size)) return llvm::sys::MemoryBlock();
+    return allocateFromChunk(chunks.back(), size);
+}
+
+void JitArena::release(llvm::sys::MemoryBlock block) {
+    // the block could be used for anything next, so it needs to be writable again
+    llvm::sys::Memory::protectMappedMemory(block, llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_WRITE);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto address = (uint8_t *) block.base();
+    auto chunk = std::find_if(chunks.begin(), chunks.end(), [address](const Chunk &candidate) {
+        return address >= candidate.base && address < candidate.base + candidate.size;
+    });
+    assert(chunk != chunks.end());
+
+    auto offset = (size_t) (address - chunk->base);
+    auto blockSize = block.size();
+    auto &freeRanges = chunk->freeRanges;
+
+    // merge the block with the free ranges on either side of it
+    auto nextRange = freeRanges.lower_bound(offset);
+    if (nextRange != freeRanges.end() && offset + blockSize == nextRange->first) {
+        blockSize += nextRange->second;
+        nextRange = freeRanges.erase(nextRange);
+    }
+    if (nextRange != freeRanges.begin()) {
+        auto lastRange = std::prev(nextRange);
+        if (lastRange->first + lastRange->second == offset) {
+            lastRange->second += blockSize;
+            return;
+        }
+    }
+    freeRanges.emplace(offset, blockSize);
+}
+
+bool JitArena::addChunk(size_t minSize) {
+    auto size = llvm::alignTo(std::max(minSize, chunkSize), pageSize);
+    if (size == 0) return false;
+
+    auto base = mapPages(size);
+    if (!base) return false;
+
+    // Huge pages have to be asked for before anything is faulted in. Protecting part of a huge page splits it, so this
+    // mostly helps the data of large patches.
+#ifdef MADV_HUGEPAGE
+    if (useHugePages) madvise(base, size, MADV_HUGEPAGE);
+#endif
+
+    if (!lockPages(base, size)) prefaultPages(base, size, pageSize);
+    chunks.push_back({base, size, {{0, size}}});
+    return true;
+}
+
+llvm::sys::MemoryBlock JitArena::allocateFromChunk(Chunk &chunk, size_t size) {
+    for (auto range = chunk.freeRanges.begin(); range != chunk.freeRanges.end(); range++) {
+        if (range->second < size) continue;
+
+        auto offset = range->first;
+        auto remainingSize = range->second - size;
+        chunk.freeRanges.erase(range);
+        if (remainingSize) chunk.freeRanges.emplace(offset + size, remainingSize);
+        return llvm::sys::MemoryBlock(chunk.base + offset, size);
+    }
+    return llvm::sys::MemoryBlock();
+}
+
+// Every memory manager that's alive, across all JITs, so sizes can be looked up by address. The mutex also guards the
+// blocks of each manager, since they can be read from other threads here.
+static std::mutex managersMutex;
+static std::unordered_set<const ArenaMemoryManager *> managers;
+
+ArenaMemoryManager::ArenaMemoryManager(std::shared_ptr<JitArena> arena) : arena(std::move(arena)) {
+    std::lock_guard<std::mutex> lock(managersMutex);
+    managers.insert(this);
+}
+
+ArenaMemoryManager::~ArenaMemoryManager() {
+    {
+        std::lock_guard<std::mutex> lock(managersMutex);
+        managers.erase(this);
+    }
+
+    for (auto pool : {&code, &readOnlyData, &readWriteData}) {
+        for (const auto &block : pool->blocks) {
+            arena->release(block);
+        }
+    }
+}
+
+size_t ArenaMemoryManager::getModuleSize(const void *address) {
+    std::lock_guard<std::mutex> lock(managersMutex);
+    for (auto manager : managers) {
+        size_t moduleSize = 0;
+        auto containsAddress = false;
+        for (auto pool : {&manager->code, &manager->readOnlyData, &manager->readWriteData}) {
+            for (const auto &block : pool->blocks) {
+                auto blockBase = (const uint8_t *) block.base();
+                containsAddress |= address >= blockBase && address < blockBase + block.size();
+                moduleSize += block.size();
+            }
+        }
+        if (containsAddress) return moduleSize;
+    }
+    return 0;
+}
+
+void ArenaMemoryManager::reserveAllocationSpace(uintptr_t codeSize, uint32_t codeAlign, uintptr_t readOnlySize,
+                                                uint32_t readOnlyAlign, uintptr_t readWriteSize,
+                                                uint32_t readWriteAlign) {
+    // Each kind of section gets one block that's large enough for all of them, so a module takes as few pages as
+    // possible. If these fail, allocating the sections will try again.
+    if (codeSize) addBlock(code, codeSize + codeAlign);
+    if (readOnlySize) addBlock(readOnlyData, readOnlySize + readOnlyAlign);
+    if (readWriteSize) addBlock(readWriteData, readWriteSize + readWriteAlign);
+}
+
+uint8_t *ArenaMemoryManager::allocateCodeSection(uintptr_t size, unsigned alignment, unsigned /*sectionId*/,
+                                                 llvm::StringRef /*sectionName*/) {
+    return allocateFromPool(code, size, alignment);
+}
+
+uint8_t *ArenaMemoryManager::allocateDataSection(uintptr_t size, unsigned alignment, unsigned /*sectionId*/,
+                                                 llvm::StringRef /*sectionName*/, bool isReadOnly) {
+    return allocateFromPool(isReadOnly ? readOnlyData : readWriteData, size, alignment);
+}
+
+bool ArenaMemoryManager::finalizeMemory(std::string *errorMessage) {
+    // as with SectionMemoryManager, true means there was an error
+    if (!protectPool(code, llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_EXEC, errorMessage)) return true;
+    if (!protectPool(readOnlyData, llvm::sys::Memory::MF_READ, errorMessage)) return true;
+
+    readWriteData.finalizedBlocks = readWriteData.blocks.size();
+    readWriteData.next = readWriteData.end = nullptr;
+    return false;
+}
+
+bool ArenaMemoryManager::addBlock(Pool &pool, size_t size) {
+    auto block = arena->allocate(size);
+    if (!block.base()) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(managersMutex);
+        pool.blocks.push_back(block);
+    }
+    pool.next = (uint8_t *) block.base();
+    pool.end = pool.next + block.size();
+    return true;
+}
+
+uint8_t *ArenaMemoryManager::allocateFromPool(Pool &pool, uintptr_t size, unsigned alignment) {
+    if (!alignment) alignment = 16;
+
+    auto address = alignAddress(pool.next, alignment);
+    if (!pool.next || address + size > pool.end) {
+        if (!addBlock(pool, size + alignment)) return nullptr;
+        address = alignAddress(pool.next, alignment);
+    }
+
+    pool.next = address + size;
+    return address;
+}
+
+bool ArenaMemoryManager::protectPool(Pool &pool, unsigned flags, std::string *errorMessage) {
+    for (auto i = pool.finalizedBlocks; i < pool.blocks.size(); i++) {
+        const auto &block = pool.blocks[i];
+        if (auto error = llvm::sys::Memory::protectMappedMemory(block, flags)) {
+            if (errorMessage) *errorMessage = error.message();
+            return false;
+        }
+
+        if (flags & llvm::sys::Memory::MF_EXEC) {
+            llvm::sys::Memory::InvalidateInstructionCache(block.base(), block.size());
+        }
+    }
+    pool.finalizedBlocks = pool.blocks.size();
+
+    // anything allocated after this goes in a new block, so it isn't protected before it's written
+    pool.next = pool.end = nullptr;
+    return true;
+}
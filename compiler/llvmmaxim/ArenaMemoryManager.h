@@ -0,0 +1,96 @@
+#pragma once
+
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
+#include <llvm/Support/Memory.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Memory that's mapped and locked into RAM in large chunks, which the code and data of JIT compiled modules is
+// allocated from. Memory is handed out in whole pages, so each allocation can be protected separately. The arena starts
+// with one chunk and maps another whenever an allocation doesn't fit in the ones it has, so it only grows as big as the
+// modules that are loaded at once.
+class JitArena {
+public:
+    JitArena(size_t chunkSize, bool useHugePages);
+
+    ~JitArena();
+
+    JitArena(const JitArena &) = delete;
+
+    JitArena &operator=(const JitArena &) = delete;
+
+    // Returns a writable block of at least `size` bytes, with every page already faulted in. The block is empty if no
+    // memory could be mapped.
+    llvm::sys::MemoryBlock allocate(size_t size);
+
+    void release(llvm::sys::MemoryBlock block);
+
+private:
+    struct Chunk {
+        uint8_t *base;
+        size_t size;
+
+        // offset -> size of each unused range in the chunk
+        std::map<size_t, size_t> freeRanges;
+    };
+
+    size_t pageSize;
+    size_t chunkSize;
+    bool useHugePages;
+
+    std::mutex mutex;
+    std::vector<Chunk> chunks;
+
+    bool addChunk(size_t minSize);
+
+    static llvm::sys::MemoryBlock allocateFromChunk(Chunk &chunk, size_t size);
+};
+
+// Allocates the sections of one JIT compiled module from a `JitArena`. Unlike `SectionMemoryManager` which maps fresh
+// memory for each module, nothing here can page fault once the module has been linked, so the first update after a
+// commit doesn't stall the audio thread.
+class ArenaMemoryManager : public llvm::RTDyldMemoryManager {
+public:
+    explicit ArenaMemoryManager(std::shared_ptr<JitArena> arena);
+
+    ~ArenaMemoryManager() override;
+
+    // Returns how many bytes have been allocated for the module that contains the address (e.g of one of its
+    // functions), or 0 if it isn't in a JIT compiled module.
+    static size_t getModuleSize(const void *address);
+
+    bool needsToReserveAllocationSpace() override { return true; }
+
+    void reserveAllocationSpace(uintptr_t codeSize, uint32_t codeAlign, uintptr_t readOnlySize,
+                                uint32_t readOnlyAlign, uintptr_t readWriteSize, uint32_t readWriteAlign) override;
+
+    uint8_t *allocateCodeSection(uintptr_t size, unsigned alignment, unsigned sectionId,
+                                 llvm::StringRef sectionName) override;
+
+    uint8_t *allocateDataSection(uintptr_t size, unsigned alignment, unsigned sectionId, llvm::StringRef sectionName,
+                                 bool isReadOnly) override;
+
+    bool finalizeMemory(std::string *errorMessage) override;
+
+private:
+    struct Pool {
+        std::vector<llvm::sys::MemoryBlock> blocks;
+        size_t finalizedBlocks = 0;
+        uint8_t *next = nullptr;
+        uint8_t *end = nullptr;
+    };
+
+    std::shared_ptr<JitArena> arena;
+    Pool code;
+    Pool readOnlyData;
+    Pool readWriteData;
+
+    bool addBlock(Pool &pool, size_t size);
+
+    uint8_t *allocateFromPool(Pool &pool, uintptr_t size, unsigned alignment);
+
+    bool protectPool(Pool &pool, unsigned flags, std::string *errorMessage);
+};
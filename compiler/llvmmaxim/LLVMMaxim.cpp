@@ -1,8 +1,15 @@
 #include <llvm-c/Core.h>
 #include <llvm-c/OrcBindings.h>
 #include <llvm-c/TargetMachine.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/Triple.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/Host.h>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <vector>
 
 #include "OrcJit.h"
 
@@ -18,8 +25,50 @@ DEFINE_SIMPLE_CONVERSION_FUNCTIONS(llvm::TargetMachine, LLVMTargetMachineRef)
 extern "C" {
 int __umoddi3(int a, int b);
 
+// implemented by the Rust frontend's worker pool
+void maxim_run_parallel_tasks(const void *workerPool, uint64_t surface, uint32_t firstTask, uint32_t taskCount,
+                              void *context);
+
+// implemented by the Rust frontend's convolve histories
+void maxim_convolve_construct(void *histories, void *history);
+
+// implemented by the Rust frontend's sample streamer
+void maxim_sampler_read(const void *const *samples, void *voice, float gate, float slot, float sampleRate);
+void maxim_sampler_release(const void *const *samples, void *voice);
+
+// The CPU that the next call to LLVMAxiomSelectTarget on this thread should generate code for, or empty to use the
+// host CPU. Thread-local so runtimes being created on different threads don't pick up each other's overrides.
+static thread_local std::string targetCpuOverride;
+
+void LLVMAxiomSetTargetCpu(const char *cpu) {
+    targetCpuOverride = cpu ? cpu : "";
+}
+
 LLVMTargetMachineRef LLVMAxiomSelectTarget() {
-    return wrap(llvm::EngineBuilder().selectTarget());
+    llvm::EngineBuilder builder;
+
+    // overrides are x86 CPU names, so other architectures always target the host
+    llvm::Triple processTriple(llvm::sys::getProcessTriple());
+    auto isX86 = processTriple.getArch() == llvm::Triple::x86 || processTriple.getArch() == llvm::Triple::x86_64;
+
+    if (isX86 && !targetCpuOverride.empty()) {
+        builder.setMCPU(targetCpuOverride);
+    } else {
+        // Without a CPU or features LLVM targets the baseline of the architecture (e.g SSE2 on x86-64), so pass in
+        // everything the host supports to let generated code use AVX2, FMA, AVX-512 etc.
+        builder.setMCPU(llvm::sys::getHostCPUName());
+
+        llvm::StringMap<bool> hostFeatures;
+        std::vector<std::string> attributes;
+        if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+            for (const auto &feature : hostFeatures) {
+                attributes.push_back((feature.second ? "+" : "-") + feature.first().str());
+            }
+        }
+        builder.setMAttrs(attributes);
+    }
+
+    return wrap(builder.selectTarget());
 }
 
 // Builder utilities
@@ -44,8 +93,26 @@ void LLVMAxiomSetAllFastMathFlags(LLVMBuilderRef builder) {
 }
 
 // JIT functions
+// The builder can't set the ordering of loads and stores, so generated code calls these for data it shares with the
+// editor.
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomics must have the same layout as the values");
+
+static void maximAtomicStoreReleaseI32(uint32_t *address, uint32_t value) {
+    reinterpret_cast<std::atomic<uint32_t> *>(address)->store(value, std::memory_order_release);
+}
+
+static uint32_t maximAtomicLoadRelaxedI32(uint32_t *address) {
+    return reinterpret_cast<std::atomic<uint32_t> *>(address)->load(std::memory_order_relaxed);
+}
+
+// JIT compiled code and data is allocated from an arena that grows by this much at a time, see JitArena.
+static const size_t jitArenaChunkSize = 8 << 20;
+
 OrcJit *LLVMAxiomOrcCreateInstance(LLVMTargetMachineRef targetMachine) {
-    auto jit = new OrcJit(*unwrap(targetMachine));
+    // AXIOM_JIT_HUGE_PAGES=1 asks for the arena to be backed by huge pages
+    auto hugePagesValue = std::getenv("AXIOM_JIT_HUGE_PAGES");
+    auto useHugePages = hugePagesValue && std::string(hugePagesValue) == "1";
+    auto jit = new OrcJit(*unwrap(targetMachine), std::make_shared<JitArena>(jitArenaChunkSize, useHugePages));
 
     jit->addBuiltin("memcpy", (uint64_t) & ::memcpy);
     jit->addBuiltin("powf", (uint64_t) & ::powf);
@@ -75,6 +142,12 @@ OrcJit *LLVMAxiomOrcCreateInstance(LLVMTargetMachineRef targetMachine) {
     jit->addBuiltin("free", (uint64_t) & ::free);
     jit->addBuiltin("memset", (uint64_t) & ::memset);
     jit->addBuiltin("__umoddi3", (uint64_t) & ::__umoddi3);
+    jit->addBuiltin("maxim_atomic_store_release_i32", (uint64_t) &maximAtomicStoreReleaseI32);
+    jit->addBuiltin("maxim_atomic_load_relaxed_i32", (uint64_t) &maximAtomicLoadRelaxedI32);
+    jit->addBuiltin("maxim_run_parallel_tasks", (uint64_t) & ::maxim_run_parallel_tasks);
+    jit->addBuiltin("maxim_convolve_construct", (uint64_t) & ::maxim_convolve_construct);
+    jit->addBuiltin("maxim_sampler_read", (uint64_t) & ::maxim_sampler_read);
+    jit->addBuiltin("maxim_sampler_release", (uint64_t) & ::maxim_sampler_release);
 
 #ifdef APPLE
     jit->addBuiltin("__sincosf_stret", (uint64_t) & ::__sincosf_stret);
@@ -99,6 +172,10 @@ LLVMOrcTargetAddress LLVMAxiomOrcGetSymbolAddress(OrcJit *jit, const char *name)
     return jit->getSymbolAddress(name);
 }
 
+uint64_t LLVMAxiomOrcGetModuleSize(LLVMOrcTargetAddress address) {
+    return ArenaMemoryManager::getModuleSize((const void *) address);
+}
+
 void LLVMAxiomOrcDisposeInstance(OrcJit *jit) {
     delete jit;
 }
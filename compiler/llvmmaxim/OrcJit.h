@@ -5,10 +5,11 @@
 #include <llvm/ExecutionEngine/Orc/IRTransformLayer.h>
 #include <llvm/ExecutionEngine/Orc/LambdaResolver.h>
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
-#include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/IR/Mangler.h>
 #include <unordered_map>
 
+#include "ArenaMemoryManager.h"
+
 namespace llvm {
     class Module;
 }
@@ -19,9 +20,9 @@ private:
     using CompileLayer = llvm::orc::IRCompileLayer<ObjectLayer, llvm::orc::SimpleCompiler>;
 
 public:
-    explicit OrcJit(llvm::TargetMachine &targetMachine)
-        : dataLayout(targetMachine.createDataLayout()),
-          objectLayer([]() { return std::make_shared<llvm::SectionMemoryManager>(); }),
+    OrcJit(llvm::TargetMachine &targetMachine, std::shared_ptr<JitArena> arena)
+        : dataLayout(targetMachine.createDataLayout()), arena(std::move(arena)),
+          objectLayer([this]() { return std::make_shared<ArenaMemoryManager>(this->arena); }),
           compileLayer(objectLayer, llvm::orc::SimpleCompiler(targetMachine)) {}
 
     using ModuleKey = unsigned;
@@ -67,6 +68,9 @@ public:
 
 private:
     llvm::DataLayout dataLayout;
+
+    // declared before the object layer, so it outlives the memory managers that allocate from it
+    std::shared_ptr<JitArena> arena;
     ObjectLayer objectLayer;
     CompileLayer compileLayer;
     std::unordered_map<std::string, llvm::JITTargetAddress> builtins;
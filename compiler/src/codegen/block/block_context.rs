@@ -1,12 +1,14 @@
 use codegen::data_analyzer::BlockLayout;
 use codegen::BuilderContext;
 use inkwell::values::PointerValue;
+use mir::ConstantValue;
 
 pub struct BlockContext<'a> {
     pub ctx: BuilderContext<'a>,
     pub layout: &'a BlockLayout,
     statement_ptrs: Vec<PointerValue>,
     pointers_ptr: PointerValue,
+    fixed_values: &'a [(usize, ConstantValue)],
 }
 
 pub struct ControlPointers {
@@ -21,15 +23,26 @@ impl<'a> BlockContext<'a> {
         ctx: BuilderContext<'a>,
         layout: &'a BlockLayout,
         pointers_ptr: PointerValue,
+        fixed_values: &'a [(usize, ConstantValue)],
     ) -> Self {
         BlockContext {
             ctx,
             layout,
             statement_ptrs: Vec::new(),
             pointers_ptr,
+            fixed_values,
         }
     }
 
+    /// Returns the constant a control's value is fixed to, if the function being built is
+    /// specialized on it.
+    pub fn get_fixed_value(&self, control: usize) -> Option<&'a ConstantValue> {
+        self.fixed_values
+            .iter()
+            .find(|(fixed_control, _)| *fixed_control == control)
+            .map(|(_, value)| value)
+    }
+
     pub fn push_statement(&mut self, ptr: PointerValue) {
         self.statement_ptrs.push(ptr)
     }
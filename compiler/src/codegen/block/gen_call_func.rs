@@ -13,9 +13,21 @@ pub fn gen_call_func_statement(
     let layout_index = node.layout.statement_index(index).unwrap();
     let func_data = node.get_function_ptr(layout_index);
 
-    // allocate data for the function result
-    let return_type = functions::get_return_type(node.ctx.context, *function);
-    let return_ptr = node.ctx.allocb.build_alloca(&return_type, "func.return");
+    // If the result is only stored to a control, the function can write it there directly.
+    // Otherwise, allocate data for the function result.
+    let direct_control = node
+        .layout
+        .copy_elisions
+        .direct_results
+        .get(&index)
+        .cloned();
+    let return_ptr = match direct_control {
+        Some(control) => node.get_control_ptrs(control, false).value,
+        None => {
+            let return_type = functions::get_return_type(node.ctx.context, *function);
+            node.ctx.allocb.build_alloca(&return_type, "func.return")
+        }
+    };
 
     let arg_ptrs: Vec<_> = args
         .iter()
@@ -1,15 +1,28 @@
+use super::gen_constant::gen_constant_statement;
 use super::BlockContext;
 use ast::ControlField;
-use codegen::controls;
+use codegen::{controls, copy_elision};
 use inkwell::values::PointerValue;
 
 pub fn gen_load_control_statement(
+    index: usize,
     control: usize,
     field: &ControlField,
     node: &mut BlockContext,
 ) -> PointerValue {
+    if copy_elision::is_value_field(field) {
+        if let Some(value) = node.get_fixed_value(control) {
+            return gen_constant_statement(value, node);
+        }
+    }
+
     let ptrs = node.get_control_ptrs(control, false);
 
+    // nothing writes to the value while the result is alive, so it can be read in place
+    if node.layout.copy_elisions.borrowed_loads.contains(&index) {
+        return ptrs.value;
+    }
+
     // allocate data for the field output
     let field_type = controls::get_field_type(node.ctx.context, *field);
     let result_ptr = node.ctx.allocb.build_alloca(&field_type, "control.field");
@@ -0,0 +1,175 @@
+use super::BlockContext;
+use codegen::values::NumValue;
+use codegen::{intrinsics, util};
+use inkwell::module::{Linkage, Module};
+use inkwell::values::{
+    BasicValue, FloatValue, FunctionValue, GlobalValue, PointerValue, VectorValue,
+};
+use mir::block::LookupTable;
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
+
+// Tables are named after their contents, so every node and voice of a block, and every `table`
+// call in it with the same expression and range, reads the same global.
+fn get_table_global(module: &Module, table: &LookupTable) -> GlobalValue {
+    let mut hasher = DefaultHasher::new();
+    table.hash(&mut hasher);
+    let name = format!("maxim.table.{:016x}", hasher.finish());
+    if let Some(global) = module.get_global(&name) {
+        return global;
+    }
+
+    // the channels of each value are interleaved
+    let context = module.get_context();
+    let values: Vec<_> = table
+        .values
+        .iter()
+        .flat_map(|value| {
+            vec![
+                context.f32_type().const_float(value.left as f64),
+                context.f32_type().const_float(value.right as f64),
+            ]
+        }).collect();
+    let table_const = context.f32_type().const_array(&values);
+    let global = module.add_global(&table_const.get_type(), None, &name);
+    global.set_linkage(Linkage::PrivateLinkage);
+    global.set_constant(true);
+    global.set_initializer(&table_const);
+    global
+}
+
+fn build_vec_call(
+    node: &mut BlockContext,
+    func: FunctionValue,
+    args: &[VectorValue],
+    name: &str,
+) -> VectorValue {
+    let arg_refs: Vec<_> = args.iter().map(|arg| arg as &BasicValue).collect();
+    node.ctx
+        .b
+        .build_call(&func, &arg_refs, name, false)
+        .left()
+        .unwrap()
+        .into_vector_value()
+}
+
+pub fn gen_lookup_table_statement(
+    input: usize,
+    table: &LookupTable,
+    node: &mut BlockContext,
+) -> PointerValue {
+    let floor_intrinsic = intrinsics::floor_v2f32(node.ctx.module);
+    let min_intrinsic = intrinsics::minnum_v2f32(node.ctx.module);
+    let max_intrinsic = intrinsics::maxnum_v2f32(node.ctx.module);
+    let table_ptr = get_table_global(node.ctx.module, table).as_pointer_value();
+
+    let input_num = NumValue::new(node.get_statement(input));
+    let result_num = NumValue::new_undef(node.ctx.context, node.ctx.allocb);
+    let result_form = match table.form {
+        Some(form) => node.ctx.context.i8_type().const_int(form as u64, false),
+        None => input_num.get_form(node.ctx.b),
+    };
+    result_num.set_form(node.ctx.b, &result_form);
+
+    // Find the position of the input in the table, clamped to the ends. Clamping with
+    // minnum/maxnum also turns NaNs into the first value.
+    let last_index = (table.values.len() - 1) as f32;
+    let input_vec = input_num.get_vec(node.ctx.b);
+    let offset_vec = node.ctx.b.build_float_sub(
+        input_vec,
+        util::get_const_vec(node.ctx.context, table.lo.left, table.lo.right),
+        "",
+    );
+    let position = node.ctx.b.build_float_mul(
+        offset_vec,
+        util::get_const_vec(
+            node.ctx.context,
+            last_index / (table.hi.left - table.lo.left),
+            last_index / (table.hi.right - table.lo.right),
+        ),
+        "",
+    );
+    let zero_vec = util::get_vec_spread(node.ctx.context, 0.);
+    let position = build_vec_call(node, max_intrinsic, &[position, zero_vec], "");
+    let last_vec = util::get_vec_spread(node.ctx.context, last_index);
+    let position = build_vec_call(node, min_intrinsic, &[position, last_vec], "position");
+
+    // the last value is only ever read as the end of the last interval
+    let position_floor = build_vec_call(node, floor_intrinsic, &[position], "");
+    let start_index_vec = util::get_vec_spread(node.ctx.context, last_index - 1.);
+    let position_floor = build_vec_call(
+        node,
+        min_intrinsic,
+        &[position_floor, start_index_vec],
+        "positionfloor",
+    );
+    let position_frac = node
+        .ctx
+        .b
+        .build_float_sub(position, position_floor, "positionfrac");
+
+    let mut start_vec = zero_vec;
+    let mut end_vec = zero_vec;
+    for channel in 0..2 {
+        let channel_index = node.ctx.context.i32_type().const_int(channel, false);
+        let channel_position = node
+            .ctx
+            .b
+            .build_extract_element(&position_floor, &channel_index, "")
+            .into_float_value();
+        let value_index = node.ctx.b.build_float_to_unsigned_int(
+            channel_position,
+            node.ctx.context.i32_type(),
+            "",
+        );
+        let start_index = node.ctx.b.build_int_add(
+            node.ctx.b.build_int_mul(
+                value_index,
+                node.ctx.context.i32_type().const_int(2, false),
+                "",
+            ),
+            channel_index,
+            "startindex",
+        );
+        let end_index = node.ctx.b.build_int_add(
+            start_index,
+            node.ctx.context.i32_type().const_int(2, false),
+            "endindex",
+        );
+
+        let load_value = |node: &mut BlockContext, index| -> FloatValue {
+            let value_ptr = unsafe {
+                node.ctx.b.build_in_bounds_gep(
+                    &table_ptr,
+                    &[node.ctx.context.i32_type().const_int(0, false), index],
+                    "value.ptr",
+                )
+            };
+            node.ctx
+                .b
+                .build_load(&value_ptr, "value")
+                .into_float_value()
+        };
+        let start_value = load_value(node, start_index);
+        let end_value = load_value(node, end_index);
+        start_vec = node
+            .ctx
+            .b
+            .build_insert_element(&start_vec, &start_value, &channel_index, "")
+            .into_vector_value();
+        end_vec = node
+            .ctx
+            .b
+            .build_insert_element(&end_vec, &end_value, &channel_index, "")
+            .into_vector_value();
+    }
+
+    let value_diff = node.ctx.b.build_float_sub(end_vec, start_vec, "");
+    let result_vec = node.ctx.b.build_float_add(
+        start_vec,
+        node.ctx.b.build_float_mul(value_diff, position_frac, ""),
+        "",
+    );
+    result_num.set_vec(node.ctx.b, &result_vec);
+    result_num.val
+}
@@ -5,23 +5,26 @@ use inkwell::values::PointerValue;
 use inkwell::AddressSpace;
 
 pub fn gen_store_control_statement(
+    index: usize,
     control: usize,
     field: &ControlField,
     value: usize,
     node: &mut BlockContext,
 ) -> PointerValue {
-    let ptrs = node.get_control_ptrs(control, false);
-
-    let store_val = node.get_statement(value);
-    controls::build_field_set(
-        node.ctx.module,
-        node.ctx.b,
-        *field,
-        ptrs.value,
-        ptrs.data,
-        ptrs.shared,
-        store_val,
-    );
+    // the function that created the value already wrote it straight into the control
+    if !node.layout.copy_elisions.elided_stores.contains(&index) {
+        let ptrs = node.get_control_ptrs(control, false);
+        let store_val = node.get_statement(value);
+        controls::build_field_set(
+            node.ctx.module,
+            node.ctx.b,
+            *field,
+            ptrs.value,
+            ptrs.data,
+            ptrs.shared,
+            store_val,
+        );
+    }
 
     // storing a control has no result, return an undefined value
     node.ctx
@@ -5,6 +5,7 @@ mod gen_constant;
 mod gen_extract;
 mod gen_global;
 mod gen_load_control;
+mod gen_lookup_table;
 mod gen_math_op;
 mod gen_num_cast;
 mod gen_num_convert;
@@ -20,7 +21,7 @@ use inkwell::module::{Linkage, Module};
 use inkwell::values::{FunctionValue, PointerValue};
 use inkwell::AddressSpace;
 use mir::block::Statement;
-use mir::{Block, BlockRef};
+use mir::{Block, BlockRef, ConstantValue};
 
 use self::gen_call_func::gen_call_func_statement;
 use self::gen_combine::gen_combine_statement;
@@ -28,6 +29,7 @@ use self::gen_constant::gen_constant_statement;
 use self::gen_extract::gen_extract_statement;
 use self::gen_global::gen_global_statement;
 use self::gen_load_control::gen_load_control_statement;
+use self::gen_lookup_table::gen_lookup_table_statement;
 use self::gen_math_op::gen_math_op_statement;
 use self::gen_num_cast::gen_num_cast_statement;
 use self::gen_num_convert::gen_num_convert_statement;
@@ -53,24 +55,30 @@ fn gen_statement(index: usize, statement: &Statement, node: &mut BlockContext) -
             args,
             varargs,
         } => gen_call_func_statement(index, function, args, varargs, node),
+        Statement::LookupTable { input, table } => gen_lookup_table_statement(*input, table, node),
         Statement::StoreControl {
             control,
             field,
             value,
-        } => gen_store_control_statement(*control, field, *value, node),
+        } => gen_store_control_statement(index, *control, field, *value, node),
         Statement::LoadControl { control, field } => {
-            gen_load_control_statement(*control, field, node)
+            gen_load_control_statement(index, *control, field, node)
         }
     }
 }
 
+/// The name of one of the block's lifecycle functions.
+pub fn lifecycle_func_name(block: BlockRef, lifecycle: LifecycleFunc) -> String {
+    format!("maxim.block.{}.{}", block, lifecycle)
+}
+
 fn get_lifecycle_func(
     module: &Module,
     cache: &ObjectCache,
     block: BlockRef,
     lifecycle: LifecycleFunc,
 ) -> FunctionValue {
-    let func_name = format!("maxim.block.{}.{}", block, lifecycle);
+    let func_name = lifecycle_func_name(block, lifecycle);
     util::get_or_create_func(module, &func_name, true, &|| {
         let context = module.get_context();
         let layout = cache.block_layout(block).unwrap();
@@ -100,10 +108,21 @@ fn build_lifecycle_func(
     cb: &Fn(&mut BlockContext),
 ) {
     let func = get_lifecycle_func(module, cache, block, lifecycle);
+    build_block_func(module, cache, block, func, &[], cb);
+}
+
+fn build_block_func(
+    module: &Module,
+    cache: &ObjectCache,
+    block: BlockRef,
+    func: FunctionValue,
+    fixed_values: &[(usize, ConstantValue)],
+    cb: &Fn(&mut BlockContext),
+) {
     build_context_function(module, func, cache.target(), &|ctx: BuilderContext| {
         let layout = cache.block_layout(block).unwrap();
         let pointers_ptr = ctx.func.get_nth_param(0).unwrap().into_pointer_value();
-        let mut ctx = BlockContext::new(ctx, layout, pointers_ptr);
+        let mut ctx = BlockContext::new(ctx, layout, pointers_ptr, fixed_values);
         cb(&mut ctx);
         ctx.ctx.b.build_return(None);
     });
@@ -158,11 +177,23 @@ pub fn build_construct_func(module: &Module, cache: &ObjectCache, block: &Block)
 }
 
 pub fn build_update_func(module: &Module, cache: &ObjectCache, block: &Block) {
-    build_lifecycle_func(
+    let func = get_lifecycle_func(module, cache, block.id.id, LifecycleFunc::Update);
+    build_update_body(module, cache, block, func, &[]);
+}
+
+fn build_update_body(
+    module: &Module,
+    cache: &ObjectCache,
+    block: &Block,
+    func: FunctionValue,
+    fixed_values: &[(usize, ConstantValue)],
+) {
+    build_block_func(
         module,
         cache,
         block.id.id,
-        LifecycleFunc::Update,
+        func,
+        fixed_values,
         &|block_ctx: &mut BlockContext| {
             for (control_index, control) in block.controls.iter().enumerate() {
                 let ptrs = block_ctx.get_control_ptrs(control_index, cache.target().include_ui);
@@ -264,3 +295,37 @@ pub fn build_lifecycle_call(
     let func = get_lifecycle_func(module, cache, block, lifecycle);
     builder.build_call(&func, &[&pointers_ptr], "", false);
 }
+
+/// Calls a copy of the block's update function that treats the values of some controls as
+/// constants, building the copy in the module if there isn't one for the same values yet. The copy
+/// is private to the module, so the optimizer can fold the constants through the block's code and
+/// inline it into the caller.
+pub fn build_specialized_update_call(
+    module: &Module,
+    cache: &ObjectCache,
+    builder: &mut Builder,
+    block: BlockRef,
+    fixed_values: &[(usize, ConstantValue)],
+    pointers_ptr: PointerValue,
+) {
+    // the name holds the values themselves, so nodes fixed to the same values share a copy
+    let func_name = format!("maxim.block.{}.update.fixed{:?}", block, fixed_values);
+    let func = match module.get_function(&func_name) {
+        Some(func) => func,
+        None => {
+            let layout = cache.block_layout(block).unwrap();
+            let func = module.add_function(
+                &func_name,
+                &module.get_context().void_type().fn_type(
+                    &[&layout.pointer_struct.ptr_type(AddressSpace::Generic)],
+                    false,
+                ),
+                Some(&Linkage::PrivateLinkage),
+            );
+            let block_mir = cache.block_mir(block).unwrap();
+            build_update_body(module, cache, block_mir, func, fixed_values);
+            func
+        }
+    };
+    builder.build_call(&func, &[&pointers_ptr], "", false);
+}
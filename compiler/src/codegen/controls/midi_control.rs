@@ -1,5 +1,7 @@
-use super::{default_copy_getter, default_copy_setter, Control, ControlFieldGenerator};
+use super::{Control, ControlContext, ControlFieldGenerator};
 use ast::{ControlField, ControlType, MidiField};
+use codegen::values::MidiValue;
+use inkwell::values::PointerValue;
 
 pub struct MidiControl;
 impl Control for MidiControl {
@@ -10,8 +12,24 @@ impl Control for MidiControl {
     fn gen_fields(generator: &ControlFieldGenerator) {
         generator.generate(
             ControlField::Midi(MidiField::Value),
-            &default_copy_getter,
-            &default_copy_setter,
+            &value_field_getter,
+            &value_field_setter,
         );
     }
 }
+
+fn value_field_getter(control: &mut ControlContext, out_val: PointerValue) {
+    MidiValue::new(control.val_ptr).copy_to(
+        control.ctx.b,
+        control.ctx.module,
+        &MidiValue::new(out_val),
+    );
+}
+
+fn value_field_setter(control: &mut ControlContext, in_val: PointerValue) {
+    MidiValue::new(in_val).copy_to(
+        control.ctx.b,
+        control.ctx.module,
+        &MidiValue::new(control.val_ptr),
+    );
+}
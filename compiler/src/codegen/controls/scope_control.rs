@@ -1,5 +1,16 @@
-use super::{default_copy_getter, default_copy_setter, Control, ControlFieldGenerator};
+use super::{
+    default_copy_getter, default_copy_setter, Control, ControlFieldGenerator, ControlUiContext,
+};
 use ast::{ControlField, ControlType, ScopeField};
+use codegen::intrinsics;
+use codegen::values::NumValue;
+use inkwell::context::Context;
+use inkwell::types::StructType;
+use inkwell::IntPredicate;
+
+/// How many points a scope keeps for the editor to read. This must be a power of two, and match
+/// `SCOPE_CONTROL_BUFFER_SIZE` in the editor.
+pub const SCOPE_BUFFER_SIZE: u64 = 4096;
 
 pub struct ScopeControl;
 impl Control for ScopeControl {
@@ -7,6 +18,151 @@ impl Control for ScopeControl {
         ControlType::Scope
     }
 
+    /// A ring buffer of points the editor displays, see `AxiomModel::ScopeControlCapture`. The
+    /// write index and decimation are shared with the editor and accessed atomically. Points are
+    /// written before the index is moved past them with a release store, so the editor can read
+    /// the buffer without taking a lock.
+    fn ui_type(context: &Context) -> StructType {
+        context.struct_type(
+            &[
+                &context.i32_type(), // number of points written so far
+                &context.i32_type(), // samples per point, set by the editor
+                &context.i32_type(), // samples since the last point
+                &context
+                    .f32_type()
+                    .vec_type(2)
+                    .array_type(SCOPE_BUFFER_SIZE as u32), // points
+            ],
+            false,
+        )
+    }
+
+    fn gen_ui_update(control: &mut ControlUiContext) {
+        let write_index_ptr = unsafe {
+            control
+                .ctx
+                .b
+                .build_struct_gep(&control.ui_ptr, 0, "writeindex.ptr")
+        };
+        let decimation_ptr = unsafe {
+            control
+                .ctx
+                .b
+                .build_struct_gep(&control.ui_ptr, 1, "decimation.ptr")
+        };
+        let counter_ptr = unsafe {
+            control
+                .ctx
+                .b
+                .build_struct_gep(&control.ui_ptr, 2, "counter.ptr")
+        };
+        let points_ptr = unsafe {
+            control
+                .ctx
+                .b
+                .build_struct_gep(&control.ui_ptr, 3, "points.ptr")
+        };
+
+        let write_point_block = control
+            .ctx
+            .context
+            .append_basic_block(&control.ctx.func, "writepoint");
+        let skip_point_block = control
+            .ctx
+            .context
+            .append_basic_block(&control.ctx.func, "skippoint");
+        let end_block = control
+            .ctx
+            .context
+            .append_basic_block(&control.ctx.func, "end");
+
+        // Only every `decimation` samples is captured, so slower signals can fill the view. A
+        // decimation of zero is treated the same as one.
+        let counter = control
+            .ctx
+            .b
+            .build_load(&counter_ptr, "counter")
+            .into_int_value();
+        let next_counter = control.ctx.b.build_int_add(
+            counter,
+            control.ctx.context.i32_type().const_int(1, false),
+            "counter.next",
+        );
+        let load_relaxed_func = intrinsics::atomic_load_relaxed_i32(control.ctx.module);
+        let decimation = control
+            .ctx
+            .b
+            .build_call(&load_relaxed_func, &[&decimation_ptr], "decimation", false)
+            .left()
+            .unwrap()
+            .into_int_value();
+        let should_write = control.ctx.b.build_int_compare(
+            IntPredicate::UGE,
+            next_counter,
+            decimation,
+            "shouldwrite",
+        );
+        control.ctx.b.build_conditional_branch(
+            &should_write,
+            &write_point_block,
+            &skip_point_block,
+        );
+
+        control.ctx.b.position_at_end(&write_point_block);
+        let write_index = control
+            .ctx
+            .b
+            .build_load(&write_index_ptr, "writeindex")
+            .into_int_value();
+        let point_index = control.ctx.b.build_and(
+            write_index,
+            control
+                .ctx
+                .context
+                .i32_type()
+                .const_int(SCOPE_BUFFER_SIZE - 1, false),
+            "pointindex",
+        );
+        let point_ptr = unsafe {
+            control.ctx.b.build_in_bounds_gep(
+                &points_ptr,
+                &[
+                    control.ctx.context.i32_type().const_int(0, false),
+                    point_index,
+                ],
+                "point.ptr",
+            )
+        };
+        let value_vec = NumValue::new(control.val_ptr).get_vec(control.ctx.b);
+        control.ctx.b.build_store(&point_ptr, &value_vec);
+
+        // the index is only moved once the point has been written, so the editor never reads a
+        // point that's half-written
+        let next_write_index = control.ctx.b.build_int_add(
+            write_index,
+            control.ctx.context.i32_type().const_int(1, false),
+            "writeindex.next",
+        );
+        let store_release_func = intrinsics::atomic_store_release_i32(control.ctx.module);
+        control.ctx.b.build_call(
+            &store_release_func,
+            &[&write_index_ptr, &next_write_index],
+            "",
+            false,
+        );
+        control.ctx.b.build_store(
+            &counter_ptr,
+            &control.ctx.context.i32_type().const_int(0, false),
+        );
+        control.ctx.b.build_unconditional_branch(&end_block);
+
+        control.ctx.b.position_at_end(&skip_point_block);
+        control.ctx.b.build_store(&counter_ptr, &next_counter);
+        control.ctx.b.build_unconditional_branch(&end_block);
+
+        control.ctx.b.position_at_end(&end_block);
+    }
+
     fn gen_fields(generator: &ControlFieldGenerator) {
         generator.generate(
             ControlField::Scope(ScopeField::Value),
@@ -0,0 +1,197 @@
+use ast::{
+    AudioExtractField, AudioField, ControlField, GraphField, MidiExtractField, MidiField,
+    RollField, ScopeField,
+};
+use codegen::values;
+use inkwell::context::Context;
+use inkwell::targets::TargetData;
+use mir::block::Statement;
+use mir::{Block, VarType};
+use std::collections::{HashMap, HashSet};
+
+/// Copies of control values that a block's update function can skip.
+///
+/// Control values live in their value group, so reading or writing a value field is normally a
+/// copy between the group and a temporary. The copy can be skipped when nothing could change the
+/// group while the temporary is alive:
+///
+///  - A borrowed load hands out a pointer straight into the group, as long as no control is
+///    written before the last statement that reads the loaded value.
+///  - A direct result lets a function write straight into the group of the control its result is
+///    stored to, as long as nothing reads or writes a control between the call and the store, and
+///    no borrowed load is still alive when the call happens.
+///
+/// Controls in the same block can share a group (e.g if a node is wired to itself), so a write to
+/// any control is treated as a possible write to all of them.
+#[derive(Debug, Clone, Default)]
+pub struct CopyElisions {
+    pub borrowed_loads: HashSet<usize>,
+
+    /// Maps function calls that write their result directly to the control they write to.
+    pub direct_results: HashMap<usize, usize>,
+    pub elided_stores: HashSet<usize>,
+}
+
+#[derive(Debug, Clone, Copy, Default)]
+pub struct CopyStats {
+    pub copied_bytes: u64,
+    pub elided_bytes: u64,
+}
+
+/// Returns true if getting or setting the field is just a copy of the control's value, so the
+/// value pointer can be used in place of the copy.
+pub fn is_value_field(field: &ControlField) -> bool {
+    match field {
+        ControlField::Audio(AudioField::Value)
+        | ControlField::Graph(GraphField::Value)
+        | ControlField::Midi(MidiField::Value)
+        | ControlField::Roll(RollField::Value)
+        | ControlField::Scope(ScopeField::Value)
+        | ControlField::AudioExtract(AudioExtractField::Value)
+        | ControlField::MidiExtract(MidiExtractField::Value) => true,
+        _ => false,
+    }
+}
+
+fn get_statement_refs(statement: &Statement) -> Vec<usize> {
+    match statement {
+        Statement::Constant(_) | Statement::Global(_) | Statement::LoadControl { .. } => vec![],
+        Statement::NumConvert { input, .. }
+        | Statement::NumCast { input, .. }
+        | Statement::NumUnaryOp { input, .. }
+        | Statement::LookupTable { input, .. } => vec![*input],
+        Statement::NumMathOp { lhs, rhs, .. } => vec![*lhs, *rhs],
+        Statement::Extract { tuple, .. } => vec![*tuple],
+        Statement::Combine { indexes } => indexes.clone(),
+        Statement::CallFunc { args, varargs, .. } => {
+            args.iter().chain(varargs.iter()).cloned().collect()
+        }
+        Statement::StoreControl { value, .. } => vec![*value],
+    }
+}
+
+// Finds the last statement that reads each statement's result. Extracting from a tuple gives a
+// pointer into it, so a tuple is alive for as long as anything extracted from it is.
+fn get_last_uses(block: &Block) -> (Vec<usize>, Vec<usize>) {
+    let mut last_uses: Vec<usize> = (0..block.statements.len()).collect();
+    let mut use_counts = vec![0; block.statements.len()];
+    for (index, statement) in block.statements.iter().enumerate().rev() {
+        let live_until = match statement {
+            Statement::Extract { .. } => last_uses[index],
+            _ => index,
+        };
+        for ref_index in get_statement_refs(statement) {
+            last_uses[ref_index] = last_uses[ref_index].max(live_until);
+            use_counts[ref_index] += 1;
+        }
+    }
+    (last_uses, use_counts)
+}
+
+pub fn find_copy_elisions(block: &Block) -> CopyElisions {
+    let (last_uses, use_counts) = get_last_uses(block);
+    let control_accesses: Vec<_> = block
+        .statements
+        .iter()
+        .enumerate()
+        .filter(|(_, statement)| match statement {
+            Statement::StoreControl { .. } | Statement::LoadControl { .. } => true,
+            _ => false,
+        }).map(|(index, _)| index)
+        .collect();
+    let stores: Vec<_> = control_accesses
+        .iter()
+        .cloned()
+        .filter(|&index| match block.statements[index] {
+            Statement::StoreControl { .. } => true,
+            _ => false,
+        }).collect();
+
+    let mut elisions = CopyElisions::default();
+    for (index, statement) in block.statements.iter().enumerate() {
+        if let Statement::LoadControl { field, .. } = statement {
+            let is_overwritten = stores
+                .iter()
+                .any(|&store| store > index && store < last_uses[index]);
+            if is_value_field(field) && !is_overwritten {
+                elisions.borrowed_loads.insert(index);
+            }
+        }
+    }
+
+    for (index, statement) in block.statements.iter().enumerate() {
+        if let Statement::StoreControl {
+            control,
+            field,
+            value,
+        } = statement
+        {
+            let call = *value;
+            let function = match block.statements[call] {
+                Statement::CallFunc { function, .. } => function,
+                _ => continue,
+            };
+            if !is_value_field(field)
+                || use_counts[call] != 1
+                || VarType::of_function(&function) != VarType::of_control_field(field)
+            {
+                continue;
+            }
+
+            let is_accessed_between = control_accesses
+                .iter()
+                .any(|&access| access > call && access < index);
+            let overlaps_borrow = elisions
+                .borrowed_loads
+                .iter()
+                .any(|&load| load < call && last_uses[load] >= call);
+            if !is_accessed_between && !overlaps_borrow {
+                elisions.direct_results.insert(call, *control);
+                elisions.elided_stores.insert(index);
+            }
+        }
+    }
+
+    elisions
+}
+
+/// Adds up how many bytes one run of a block's update function copies between temporaries and
+/// value groups, and how many bytes copy elision saves.
+pub fn count_copied_bytes(
+    context: &Context,
+    target_data: &TargetData,
+    block: &Block,
+    elisions: &CopyElisions,
+) -> CopyStats {
+    let get_size =
+        |var_type: &VarType| target_data.get_abi_size(&values::remap_type(context, var_type));
+
+    let mut stats = CopyStats::default();
+    for (index, statement) in block.statements.iter().enumerate() {
+        let (size, is_elided) = match statement {
+            Statement::LoadControl { field, .. } if is_value_field(field) => (
+                get_size(&VarType::of_control_field(field)),
+                elisions.borrowed_loads.contains(&index),
+            ),
+            Statement::StoreControl { field, .. } if is_value_field(field) => (
+                get_size(&VarType::of_control_field(field)),
+                elisions.elided_stores.contains(&index),
+            ),
+            Statement::Combine { indexes } => (
+                indexes
+                    .iter()
+                    .map(|&item| get_size(&VarType::of_statement(block, item)))
+                    .sum::<u64>(),
+                false,
+            ),
+            _ => continue,
+        };
+
+        if is_elided {
+            stats.elided_bytes += size;
+        } else {
+            stats.copied_bytes += size;
+        }
+    }
+    stats
+}
@@ -1,3 +1,4 @@
+use codegen::copy_elision::{self, CopyElisions};
 use codegen::TargetProperties;
 use codegen::{controls, functions, values, ObjectCache};
 use inkwell::context::Context;
@@ -54,6 +55,7 @@ pub struct BlockLayout {
     pub pointer_struct: StructType,
     pub pointer_sources: Vec<PointerSource>,
     pub functions: Vec<Function>,
+    pub copy_elisions: CopyElisions,
     control_count: usize,
     func_indexes: HashMap<usize, usize>,
 }
@@ -175,7 +177,8 @@ pub fn build_node_layout(
             // Note: we put the underlying surface's pointers first, as this enables value
             // read-back to read the first instance without any special behavior.
             // For the editor, we also want a pointer to the actual active state of the surface,
-            // which we'll put in the scratch.
+            // which we'll put in the scratch. Voice sleeping needs the scratch of each voice (so a
+            // sleeping voice can be reset) and its own state, which is also kept in the scratch.
             //
             // This array must match the struct defined below as `pointer_struct`.
             let pointer_sources = vec![
@@ -207,6 +210,8 @@ pub fn build_node_layout(
                         .collect(),
                 ),
                 PointerSource::Scratch(vec![1]),
+                PointerSource::Scratch(vec![0]),
+                PointerSource::Scratch(vec![2]),
             ];
 
             let source_socket_types: Vec<_> = source_sockets
@@ -233,13 +238,12 @@ pub fn build_node_layout(
                 .map(|ptr_type| ptr_type as &BasicType)
                 .collect();
 
+            let voices_scratch_type = surface_layout
+                .scratch_struct
+                .array_type(values::ARRAY_CAPACITY as u32);
+            let sleep_type = get_voice_sleep_type(context);
             let scratch_struct = context.struct_type(
-                &[
-                    &surface_layout
-                        .scratch_struct
-                        .array_type(values::ARRAY_CAPACITY as u32),
-                    &context.i32_type(),
-                ],
+                &[&voices_scratch_type, &context.i32_type(), &sleep_type],
                 false,
             );
 
@@ -252,6 +256,8 @@ pub fn build_node_layout(
                     &context.struct_type(&source_type_refs, false) as &BasicType,
                     &context.struct_type(&dest_type_refs, false) as &BasicType,
                     &context.i32_type().ptr_type(AddressSpace::Generic),
+                    &voices_scratch_type.ptr_type(AddressSpace::Generic),
+                    &sleep_type.ptr_type(AddressSpace::Generic),
                 ],
                 false,
             );
@@ -269,6 +275,24 @@ pub fn build_node_layout(
     }
 }
 
+/// The state used to put silent voices in an extract group to sleep:
+///
+///  - a bitmap of voices that are currently sleeping
+///  - the active bitmap from the previous sample, so newly activated voices can be woken up
+///  - the number of samples each voice has been silent for
+///  - the number of notes each voice is holding, so only released voices are put to sleep
+pub fn get_voice_sleep_type(context: &Context) -> StructType {
+    context.struct_type(
+        &[
+            &context.i32_type(),
+            &context.i32_type(),
+            &context.i32_type().array_type(values::ARRAY_CAPACITY as u32),
+            &context.i8_type().array_type(values::ARRAY_CAPACITY as u32),
+        ],
+        false,
+    )
+}
+
 fn map_extract_pointer_source(
     source: PointerSource,
     voice_index: usize,
@@ -416,11 +440,34 @@ pub fn build_block_layout(
         pointer_struct: context.struct_type(&pointer_type_refs, false),
         pointer_sources,
         functions,
+        copy_elisions: copy_elision::find_copy_elisions(block),
         control_count: block.controls.len(),
         func_indexes,
     }
 }
 
+fn block_functions<'a>(block: &'a Block) -> impl Iterator<Item = Function> + 'a {
+    block
+        .statements
+        .iter()
+        .filter_map(|statement| match statement {
+            Statement::CallFunc { function, .. } => Some(*function),
+            _ => None,
+        })
+}
+
+/// Returns true if `build_block_layout` would produce the same structure types for both blocks,
+/// i.e they have the same control types and call the same functions in the same order. Surfaces
+/// containing the block don't need their layouts rebuilt if this is the case.
+pub fn block_layouts_match(a: &Block, b: &Block) -> bool {
+    a.controls.len() == b.controls.len()
+        && a.controls
+            .iter()
+            .zip(b.controls.iter())
+            .all(|(a_control, b_control)| a_control.control_type == b_control.control_type)
+        && block_functions(a).eq(block_functions(b))
+}
+
 /// Builds up the structure types and default values used for initializing/retaining state of a surface.
 ///
 ///  - `initialized` is a struct containing pre-initialized value group values.
@@ -452,7 +499,8 @@ pub fn build_surface_layout(cache: &ObjectCache, surface: &Surface) -> SurfaceLa
                 ValueGroupSource::Socket(socket_index) => {
                     PointerSource::Socket(socket_index, vec![])
                 }
-                ValueGroupSource::Default(ref default_val) => {
+                ValueGroupSource::Default(ref default_val)
+                | ValueGroupSource::Fixed(ref default_val) => {
                     let initialized_index = initialized_values.len();
                     initialized_values.push(values::remap_constant(context, default_val));
 
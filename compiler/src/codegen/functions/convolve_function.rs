@@ -0,0 +1,970 @@
+use super::{Function, FunctionContext, VarArgs};
+use codegen::values::NumValue;
+use codegen::{
+    build_context_function, globals, intrinsics, util, BuilderContext, TargetProperties,
+};
+use inkwell::context::Context;
+use inkwell::module::{Linkage, Module};
+use inkwell::types::{FunctionType, StructType};
+use inkwell::values::{FunctionValue, GlobalValue, IntValue, PointerValue};
+use inkwell::{AddressSpace, IntPredicate};
+use mir::block;
+use std::f64::consts;
+
+// Implemented by the runtime, see `frontend::ConvolveHistories`.
+const CONSTRUCT_FUNC_NAME: &str = "maxim_convolve_construct";
+
+// Impulse responses are split into partitions of `PARTITION_SIZE` samples and convolved with the
+// input using uniformly partitioned overlap-save: every `PARTITION_SIZE` samples, the latest two
+// partitions of input are transformed, multiplied with the spectrum of every impulse response
+// partition (each against correspondingly older input), and transformed back. Output is delayed
+// by one partition.
+
+/// The number of samples in each partition of an impulse response.
+pub const PARTITION_SIZE: usize = 128;
+
+/// The size of the transforms, big enough to hold a partition convolved with another.
+pub const TRANSFORM_SIZE: usize = PARTITION_SIZE * 2;
+
+/// The number of frequency bins kept from each transform. The spectrum of a real signal is
+/// symmetric, so only the bins up to Nyquist are stored.
+pub const SPECTRUM_BINS: usize = TRANSFORM_SIZE / 2 + 1;
+
+const TRANSFORM_LEVELS: usize = 8;
+
+// Every stage of the transform needs a twiddle factor `e^(-2 pi i k / TRANSFORM_SIZE)` for some
+// `k` in `0..TRANSFORM_SIZE / 2`.
+fn get_twiddle_global(module: &Module, name: &str, component: &Fn(f64) -> f64) -> GlobalValue {
+    if let Some(global) = module.get_global(name) {
+        return global;
+    }
+
+    let context = module.get_context();
+    let values: Vec<_> = (0..TRANSFORM_SIZE / 2)
+        .map(|index| {
+            let angle = -2. * consts::PI * index as f64 / TRANSFORM_SIZE as f64;
+            context.f32_type().const_float(component(angle))
+        }).collect();
+    let table_const = context.f32_type().const_array(&values);
+    let global = module.add_global(&table_const.get_type(), None, name);
+    global.set_constant(true);
+    global.set_initializer(&table_const);
+    global
+}
+
+fn get_bit_reverse_global(module: &Module) -> GlobalValue {
+    let name = "maxim.convolve.bitreverse";
+    if let Some(global) = module.get_global(name) {
+        return global;
+    }
+
+    let context = module.get_context();
+    let values: Vec<_> = (0..TRANSFORM_SIZE)
+        .map(|index| {
+            let reversed = (0..TRANSFORM_LEVELS)
+                .fold(0, |reversed, bit| (reversed << 1) | ((index >> bit) & 1));
+            context.i64_type().const_int(reversed as u64, false)
+        }).collect();
+    let table_const = context.i64_type().const_array(&values);
+    let global = module.add_global(&table_const.get_type(), None, name);
+    global.set_constant(true);
+    global.set_initializer(&table_const);
+    global
+}
+
+// Builds a loop that runs the body once for each index in `0..count`.
+fn build_loop(
+    ctx: &mut BuilderContext,
+    name: &str,
+    count: IntValue,
+    body: &mut FnMut(&mut BuilderContext, IntValue),
+) {
+    let index_ptr = ctx
+        .allocb
+        .build_alloca(&ctx.context.i64_type(), &format!("{}.index.ptr", name));
+    ctx.b
+        .build_store(&index_ptr, &ctx.context.i64_type().const_int(0, false));
+
+    let check_block = ctx
+        .context
+        .append_basic_block(&ctx.func, &format!("{}.check", name));
+    let body_block = ctx
+        .context
+        .append_basic_block(&ctx.func, &format!("{}.body", name));
+    let end_block = ctx
+        .context
+        .append_basic_block(&ctx.func, &format!("{}.end", name));
+    ctx.b.build_unconditional_branch(&check_block);
+
+    ctx.b.position_at_end(&check_block);
+    let index = ctx
+        .b
+        .build_load(&index_ptr, &format!("{}.index", name))
+        .into_int_value();
+    let should_continue = ctx.b.build_int_compare(IntPredicate::ULT, index, count, "");
+    ctx.b
+        .build_conditional_branch(&should_continue, &body_block, &end_block);
+
+    ctx.b.position_at_end(&body_block);
+    body(ctx, index);
+    let next_index = ctx.b.build_int_nuw_add(
+        index,
+        ctx.context.i64_type().const_int(1, false),
+        &format!("{}.nextindex", name),
+    );
+    ctx.b.build_store(&index_ptr, &next_index);
+    ctx.b.build_unconditional_branch(&check_block);
+
+    ctx.b.position_at_end(&end_block);
+}
+
+fn build_item_ptr(ctx: &mut BuilderContext, ptr: PointerValue, index: IntValue) -> PointerValue {
+    unsafe { ctx.b.build_in_bounds_gep(&ptr, &[index], "") }
+}
+
+fn build_array_item_ptr(
+    ctx: &mut BuilderContext,
+    array_ptr: PointerValue,
+    index: IntValue,
+) -> PointerValue {
+    unsafe {
+        ctx.b.build_in_bounds_gep(
+            &array_ptr,
+            &[ctx.context.i64_type().const_int(0, false), index],
+            "",
+        )
+    }
+}
+
+fn build_zero_bytes(ctx: &mut BuilderContext, ptr: PointerValue, byte_count: IntValue) {
+    let target_data = ctx.target.machine.get_data();
+    let memset_intrinsic = intrinsics::memset(ctx.module, &target_data);
+    let size_type = target_data.int_ptr_type_in_context(ctx.context);
+    ctx.b.build_call(
+        &memset_intrinsic,
+        &[
+            &ctx.b.build_pointer_cast(
+                ptr,
+                ctx.context.i8_type().ptr_type(AddressSpace::Generic),
+                "",
+            ),
+            &ctx.context.i8_type().const_int(0, false),
+            &ctx.b.build_int_cast(byte_count, size_type, ""),
+            &ctx.context.i32_type().const_int(0, false),
+            &ctx.context.bool_type().const_int(0, false),
+        ],
+        "",
+        false,
+    );
+}
+
+fn get_private_func(
+    module: &Module,
+    name: &str,
+    func_type: &Fn(&Context) -> FunctionType,
+) -> FunctionValue {
+    util::get_or_create_func(module, name, true, &|| {
+        (Linkage::PrivateLinkage, func_type(&module.get_context()))
+    })
+}
+
+pub struct ConvolveFunction {}
+impl ConvolveFunction {
+    /// The layout of a loaded impulse response, see `frontend::ImpulseResponse`.
+    pub fn impulse_response_type(context: &Context) -> StructType {
+        context.struct_type(
+            &[
+                &context.i64_type(), // partition count
+                &context
+                    .f32_type()
+                    .vec_type(2)
+                    .ptr_type(AddressSpace::Generic), // partition spectra
+            ],
+            false,
+        )
+    }
+
+    fn get_construct_func(module: &Module) -> FunctionValue {
+        util::get_or_create_func(module, CONSTRUCT_FUNC_NAME, false, &|| {
+            let context = module.get_context();
+            (
+                Linkage::ExternalLinkage,
+                context.void_type().fn_type(
+                    &[
+                        &context.i8_type().ptr_type(AddressSpace::Generic), // histories
+                        &ConvolveFunction::data_type(&context).ptr_type(AddressSpace::Generic),
+                    ],
+                    false,
+                ),
+            )
+        })
+    }
+
+    /// Builds a version of the function that sets up the input spectra that does nothing, for
+    /// modules that run without a runtime to load impulse responses into (i.e exported objects).
+    /// Nodes are left without room for any input, so they only ever output silence.
+    pub fn build_silent_funcs(module: &Module, target: &TargetProperties) {
+        let construct_func = ConvolveFunction::get_construct_func(module);
+        build_context_function(module, construct_func, target, &|ctx: BuilderContext| {
+            ctx.b.build_return(None);
+        });
+    }
+
+    fn get_transform_func(module: &Module) -> FunctionValue {
+        get_private_func(module, "maxim.util.convolve.transform", &|context| {
+            let buffer_type = context
+                .f32_type()
+                .vec_type(2)
+                .array_type(TRANSFORM_SIZE as u32)
+                .ptr_type(AddressSpace::Generic);
+            context
+                .void_type()
+                .fn_type(&[&buffer_type, &buffer_type], false)
+        })
+    }
+
+    fn get_partition_update_func(module: &Module) -> FunctionValue {
+        get_private_func(module, "maxim.util.convolve.partitionUpdate", &|context| {
+            context.void_type().fn_type(
+                &[
+                    &ConvolveFunction::data_type(context).ptr_type(AddressSpace::Generic),
+                    &ConvolveFunction::impulse_response_type(context)
+                        .ptr_type(AddressSpace::Generic),
+                ],
+                false,
+            )
+        })
+    }
+
+    /// Builds an in-place radix-2 FFT of a stereo signal, split into real and imaginary parts,
+    /// which must already be in bit-reversed order. Both channels are transformed at once.
+    fn build_transform_func(module: &Module, target: &TargetProperties) {
+        let func = ConvolveFunction::get_transform_func(module);
+        if func.count_basic_blocks() > 0 {
+            return;
+        }
+
+        build_context_function(module, func, target, &|mut ctx: BuilderContext| {
+            let real_ptr = ctx.func.get_nth_param(0).unwrap().into_pointer_value();
+            let imag_ptr = ctx.func.get_nth_param(1).unwrap().into_pointer_value();
+            let twiddle_real_ptr =
+                get_twiddle_global(ctx.module, "maxim.convolve.twiddle.real", &f64::cos)
+                    .as_pointer_value();
+            let twiddle_imag_ptr =
+                get_twiddle_global(ctx.module, "maxim.convolve.twiddle.imag", &f64::sin)
+                    .as_pointer_value();
+
+            // Each stage combines pairs of transforms of size `half` into ones of size `half * 2`,
+            // with one butterfly for each pair of items.
+            for level in 0..TRANSFORM_LEVELS {
+                let half = 1 << level;
+                let twiddle_stride = TRANSFORM_SIZE / (half * 2);
+                let butterfly_count = ctx
+                    .context
+                    .i64_type()
+                    .const_int((TRANSFORM_SIZE / 2) as u64, false);
+
+                build_loop(
+                    &mut ctx,
+                    &format!("stage{}", level),
+                    butterfly_count,
+                    &mut |ctx, butterfly| {
+                        let i64_type = ctx.context.i64_type();
+                        let group = ctx.b.build_int_unsigned_div(
+                            butterfly,
+                            i64_type.const_int(half as u64, false),
+                            "group",
+                        );
+                        let offset = ctx.b.build_int_unsigned_rem(
+                            butterfly,
+                            i64_type.const_int(half as u64, false),
+                            "offset",
+                        );
+                        let top_index = ctx.b.build_int_add(
+                            ctx.b.build_int_mul(
+                                group,
+                                i64_type.const_int((half * 2) as u64, false),
+                                "",
+                            ),
+                            offset,
+                            "topindex",
+                        );
+                        let bottom_index = ctx.b.build_int_add(
+                            top_index,
+                            i64_type.const_int(half as u64, false),
+                            "bottomindex",
+                        );
+                        let twiddle_index = ctx.b.build_int_mul(
+                            offset,
+                            i64_type.const_int(twiddle_stride as u64, false),
+                            "twiddleindex",
+                        );
+
+                        let twiddle_real_item =
+                            build_array_item_ptr(ctx, twiddle_real_ptr, twiddle_index);
+                        let twiddle_real = ctx
+                            .b
+                            .build_load(&twiddle_real_item, "twiddle.real")
+                            .into_float_value();
+                        let twiddle_real = util::splat_vector(ctx.b, twiddle_real, "");
+                        let twiddle_imag_item =
+                            build_array_item_ptr(ctx, twiddle_imag_ptr, twiddle_index);
+                        let twiddle_imag = ctx
+                            .b
+                            .build_load(&twiddle_imag_item, "twiddle.imag")
+                            .into_float_value();
+                        let twiddle_imag = util::splat_vector(ctx.b, twiddle_imag, "");
+
+                        let top_real_ptr = build_array_item_ptr(ctx, real_ptr, top_index);
+                        let top_imag_ptr = build_array_item_ptr(ctx, imag_ptr, top_index);
+                        let bottom_real_ptr = build_array_item_ptr(ctx, real_ptr, bottom_index);
+                        let bottom_imag_ptr = build_array_item_ptr(ctx, imag_ptr, bottom_index);
+                        let top_real = ctx
+                            .b
+                            .build_load(&top_real_ptr, "top.real")
+                            .into_vector_value();
+                        let top_imag = ctx
+                            .b
+                            .build_load(&top_imag_ptr, "top.imag")
+                            .into_vector_value();
+                        let bottom_real = ctx
+                            .b
+                            .build_load(&bottom_real_ptr, "bottom.real")
+                            .into_vector_value();
+                        let bottom_imag = ctx
+                            .b
+                            .build_load(&bottom_imag_ptr, "bottom.imag")
+                            .into_vector_value();
+
+                        // t = bottom * twiddle
+                        let t_real = ctx.b.build_float_sub(
+                            ctx.b.build_float_mul(bottom_real, twiddle_real, ""),
+                            ctx.b.build_float_mul(bottom_imag, twiddle_imag, ""),
+                            "t.real",
+                        );
+                        let t_imag = ctx.b.build_float_add(
+                            ctx.b.build_float_mul(bottom_real, twiddle_imag, ""),
+                            ctx.b.build_float_mul(bottom_imag, twiddle_real, ""),
+                            "t.imag",
+                        );
+
+                        // top, bottom = top + t, top - t
+                        ctx.b.build_store(
+                            &top_real_ptr,
+                            &ctx.b.build_float_add(top_real, t_real, "newtop.real"),
+                        );
+                        ctx.b.build_store(
+                            &top_imag_ptr,
+                            &ctx.b.build_float_add(top_imag, t_imag, "newtop.imag"),
+                        );
+                        ctx.b.build_store(
+                            &bottom_real_ptr,
+                            &ctx.b.build_float_sub(top_real, t_real, "newbottom.real"),
+                        );
+                        ctx.b.build_store(
+                            &bottom_imag_ptr,
+                            &ctx.b.build_float_sub(top_imag, t_imag, "newbottom.imag"),
+                        );
+                    },
+                );
+            }
+
+            ctx.b.build_return(None);
+        });
+    }
+
+    /// Builds a function that is equivalent to the following C++, run every time a partition of
+    /// input has been collected:
+    /// ```cpp
+    /// void partitionUpdate(ConvolveData *data, ImpulseResponse *ir) {
+    ///     uint64_t partitionCount = ir ? ir->partitionCount : 0;
+    ///     partitionCount = min(partitionCount, data->capacity);
+    ///
+    ///     if (partitionCount == 0) {
+    ///         memset(data->output, 0, sizeof(data->output));
+    ///         return;
+    ///     }
+    ///
+    ///     for (uint64_t i = 0; i < TRANSFORM_SIZE; i++) {
+    ///         data->real[i] = data->input[bitReverse[i]];
+    ///         data->imag[i] = 0;
+    ///     }
+    ///     transform(data->real, data->imag);
+    ///     memcpy(data->input, data->input + PARTITION_SIZE, PARTITION_SIZE * sizeof(float2));
+    ///
+    ///     // spectra are stored newest to oldest, starting at newestSpectrum and wrapping around
+    ///     auto newest = data->newestSpectrum == 0 ? data->capacity - 1 : data->newestSpectrum - 1;
+    ///     data->newestSpectrum = newest;
+    ///     for (uint64_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+    ///         data->spectra[(newest * SPECTRUM_BINS + bin) * 2] = data->real[bin];
+    ///         data->spectra[(newest * SPECTRUM_BINS + bin) * 2 + 1] = data->imag[bin];
+    ///     }
+    ///
+    ///     // only spectra written since the node was constructed hold any input
+    ///     data->filledSpectra = min(data->filledSpectra + 1, data->capacity);
+    ///     auto sumCount = min(partitionCount, data->filledSpectra);
+    ///
+    ///     memset(data->sumReal, 0, sizeof(data->sumReal));
+    ///     memset(data->sumImag, 0, sizeof(data->sumImag));
+    ///     for (uint64_t partition = 0; partition < sumCount; partition++) {
+    ///         auto spectrum = newest + partition;
+    ///         if (spectrum >= data->capacity) spectrum -= data->capacity;
+    ///         auto x = &data->spectra[spectrum * SPECTRUM_BINS * 2];
+    ///         auto h = &ir->spectra[partition * SPECTRUM_BINS * 2];
+    ///         for (uint64_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+    ///             data->sumReal[bin] += x[bin * 2] * h[bin * 2] - x[bin * 2 + 1] * h[bin * 2 + 1];
+    ///             data->sumImag[bin] += x[bin * 2] * h[bin * 2 + 1] + x[bin * 2 + 1] * h[bin * 2];
+    ///         }
+    ///     }
+    ///
+    ///     // inverse transform by transforming the conjugate, filling in the mirrored bins
+    ///     for (uint64_t i = 0; i < TRANSFORM_SIZE; i++) {
+    ///         auto bin = bitReverse[i];
+    ///         if (bin < SPECTRUM_BINS) {
+    ///             data->real[i] = data->sumReal[bin];
+    ///             data->imag[i] = -data->sumImag[bin];
+    ///         } else {
+    ///             data->real[i] = data->sumReal[TRANSFORM_SIZE - bin];
+    ///             data->imag[i] = data->sumImag[TRANSFORM_SIZE - bin];
+    ///         }
+    ///     }
+    ///     transform(data->real, data->imag);
+    ///     memcpy(data->output, data->real + PARTITION_SIZE, PARTITION_SIZE * sizeof(float2));
+    /// }
+    /// ```
+    /// The `1 / TRANSFORM_SIZE` scale of the inverse transform is already applied to the impulse
+    /// response's spectra when they're loaded. The input spectra are owned by the runtime, which
+    /// makes sure there's room for every loaded impulse response, so nothing is allocated here.
+    /// Counting the filled spectra means resetting the node doesn't need to clear them.
+    fn build_partition_update_func(module: &Module, target: &TargetProperties) {
+        let func = ConvolveFunction::get_partition_update_func(module);
+        if func.count_basic_blocks() > 0 {
+            return;
+        }
+
+        ConvolveFunction::build_transform_func(module, target);
+        let transform_func = ConvolveFunction::get_transform_func(module);
+
+        build_context_function(module, func, target, &|mut ctx: BuilderContext| {
+            let i64_type = ctx.context.i64_type();
+            let vec_type = ctx.context.f32_type().vec_type(2);
+            let vec_size = vec_type.size_of().unwrap().const_cast(&i64_type, false);
+            let zero_vec = util::get_vec_spread(ctx.context, 0.);
+            let bit_reverse_ptr = get_bit_reverse_global(ctx.module).as_pointer_value();
+
+            let data_ptr = ctx.func.get_nth_param(0).unwrap().into_pointer_value();
+            let ir_ptr = ctx.func.get_nth_param(1).unwrap().into_pointer_value();
+            let field_ptr = |ctx: &mut BuilderContext, index: u32, name: &str| unsafe {
+                ctx.b.build_struct_gep(&data_ptr, index, name)
+            };
+            let capacity_ptr = field_ptr(&mut ctx, 0, "capacity.ptr");
+            let newest_ptr = field_ptr(&mut ctx, 1, "newestspectrum.ptr");
+            let filled_ptr = field_ptr(&mut ctx, 2, "filledspectra.ptr");
+            let spectra_ptr_ptr = field_ptr(&mut ctx, 3, "spectra.ptr");
+            let input_ptr = field_ptr(&mut ctx, 5, "input");
+            let output_ptr = field_ptr(&mut ctx, 6, "output");
+            let real_ptr = field_ptr(&mut ctx, 7, "real");
+            let imag_ptr = field_ptr(&mut ctx, 8, "imag");
+            let sum_real_ptr = field_ptr(&mut ctx, 9, "sumreal");
+            let sum_imag_ptr = field_ptr(&mut ctx, 10, "sumimag");
+
+            // uint64_t partitionCount = ir ? ir->partitionCount : 0;
+            let has_ir_block = ctx.context.append_basic_block(&ctx.func, "hasir.true");
+            let has_ir_continue_block = ctx.context.append_basic_block(&ctx.func, "hasir.continue");
+            let ir_partition_count_ptr = ctx.allocb.build_alloca(&i64_type, "irpartitions.ptr");
+            ctx.b
+                .build_store(&ir_partition_count_ptr, &i64_type.const_int(0, false));
+            let is_null = ctx.b.build_is_null(ir_ptr, "isnull");
+            ctx.b
+                .build_conditional_branch(&is_null, &has_ir_continue_block, &has_ir_block);
+            ctx.b.position_at_end(&has_ir_block);
+            let loaded_partition_count = ctx
+                .b
+                .build_load(
+                    &unsafe { ctx.b.build_struct_gep(&ir_ptr, 0, "ir.partitioncount.ptr") },
+                    "ir.partitioncount",
+                ).into_int_value();
+            ctx.b
+                .build_store(&ir_partition_count_ptr, &loaded_partition_count);
+            ctx.b.build_unconditional_branch(&has_ir_continue_block);
+            ctx.b.position_at_end(&has_ir_continue_block);
+            let ir_partition_count = ctx
+                .b
+                .build_load(&ir_partition_count_ptr, "irpartitioncount")
+                .into_int_value();
+
+            // partitionCount = min(partitionCount, data->capacity);
+            let capacity = ctx.b.build_load(&capacity_ptr, "capacity").into_int_value();
+            let is_truncated = ctx.b.build_int_compare(
+                IntPredicate::UGT,
+                ir_partition_count,
+                capacity,
+                "istruncated",
+            );
+            let partition_count = ctx
+                .b
+                .build_select(is_truncated, capacity, ir_partition_count, "partitioncount")
+                .into_int_value();
+
+            // if (partitionCount == 0) { memset(data->output, 0, sizeof(data->output)); return; }
+            let empty_block = ctx.context.append_basic_block(&ctx.func, "empty.true");
+            let convolve_block = ctx.context.append_basic_block(&ctx.func, "convolve");
+            let is_empty = ctx.b.build_int_compare(
+                IntPredicate::EQ,
+                partition_count,
+                i64_type.const_int(0, false),
+                "isempty",
+            );
+            ctx.b
+                .build_conditional_branch(&is_empty, &empty_block, &convolve_block);
+            ctx.b.position_at_end(&empty_block);
+            let output_bytes = ctx.b.build_int_mul(
+                i64_type.const_int(PARTITION_SIZE as u64, false),
+                vec_size,
+                "outputbytes",
+            );
+            build_zero_bytes(&mut ctx, output_ptr, output_bytes);
+            ctx.b.build_return(None);
+
+            ctx.b.position_at_end(&convolve_block);
+            let spectra_ptr = ctx
+                .b
+                .build_load(&spectra_ptr_ptr, "spectra")
+                .into_pointer_value();
+            let ir_spectra_ptr = ctx
+                .b
+                .build_load(
+                    &unsafe { ctx.b.build_struct_gep(&ir_ptr, 1, "ir.spectra.ptr") },
+                    "ir.spectra",
+                ).into_pointer_value();
+
+            // transform the latest two partitions of input
+            let transform_size = i64_type.const_int(TRANSFORM_SIZE as u64, false);
+            build_loop(&mut ctx, "load", transform_size, &mut |ctx, index| {
+                let source_index_ptr = build_array_item_ptr(ctx, bit_reverse_ptr, index);
+                let source_index = ctx
+                    .b
+                    .build_load(&source_index_ptr, "sourceindex")
+                    .into_int_value();
+                let source_ptr = build_array_item_ptr(ctx, input_ptr, source_index);
+                let source = ctx.b.build_load(&source_ptr, "source");
+                let item_real_ptr = build_array_item_ptr(ctx, real_ptr, index);
+                ctx.b.build_store(&item_real_ptr, &source);
+                let item_imag_ptr = build_array_item_ptr(ctx, imag_ptr, index);
+                ctx.b.build_store(&item_imag_ptr, &zero_vec);
+            });
+            ctx.b
+                .build_call(&transform_func, &[&real_ptr, &imag_ptr], "", false);
+
+            // move the latest partition of input back to make room for the next
+            let partition_size = i64_type.const_int(PARTITION_SIZE as u64, false);
+            let input_start_ptr =
+                build_array_item_ptr(&mut ctx, input_ptr, i64_type.const_int(0, false));
+            let input_latest_ptr = build_array_item_ptr(&mut ctx, input_ptr, partition_size);
+            let partition_bytes = ctx
+                .b
+                .build_int_mul(partition_size, vec_size, "partitionbytes");
+            util::copy_bytes(
+                ctx.b,
+                ctx.module,
+                input_latest_ptr,
+                input_start_ptr,
+                partition_bytes,
+            );
+
+            // auto newest = data->newestSpectrum == 0 ? data->capacity - 1 : data->newestSpectrum - 1;
+            let last_newest = ctx.b.build_load(&newest_ptr, "lastnewest").into_int_value();
+            let is_first_spectrum = ctx.b.build_int_compare(
+                IntPredicate::EQ,
+                last_newest,
+                i64_type.const_int(0, false),
+                "isfirstspectrum",
+            );
+            let newest = ctx.b.build_int_sub(
+                ctx.b
+                    .build_select(is_first_spectrum, capacity, last_newest, "")
+                    .into_int_value(),
+                i64_type.const_int(1, false),
+                "newest",
+            );
+            ctx.b.build_store(&newest_ptr, &newest);
+
+            let spectrum_stride = i64_type.const_int((SPECTRUM_BINS * 2) as u64, false);
+            let spectrum_bins = i64_type.const_int(SPECTRUM_BINS as u64, false);
+            let newest_offset = ctx.b.build_int_mul(newest, spectrum_stride, "newestoffset");
+            let newest_spectrum_ptr = build_item_ptr(&mut ctx, spectra_ptr, newest_offset);
+            build_loop(&mut ctx, "store", spectrum_bins, &mut |ctx, bin| {
+                let bin_real_ptr = build_array_item_ptr(ctx, real_ptr, bin);
+                let bin_real = ctx.b.build_load(&bin_real_ptr, "bin.real");
+                let bin_imag_ptr = build_array_item_ptr(ctx, imag_ptr, bin);
+                let bin_imag = ctx.b.build_load(&bin_imag_ptr, "bin.imag");
+
+                let real_offset =
+                    ctx.b
+                        .build_int_mul(bin, i64_type.const_int(2, false), "realoffset");
+                let imag_offset =
+                    ctx.b
+                        .build_int_add(real_offset, i64_type.const_int(1, false), "imagoffset");
+                let stored_real_ptr = build_item_ptr(ctx, newest_spectrum_ptr, real_offset);
+                ctx.b.build_store(&stored_real_ptr, &bin_real);
+                let stored_imag_ptr = build_item_ptr(ctx, newest_spectrum_ptr, imag_offset);
+                ctx.b.build_store(&stored_imag_ptr, &bin_imag);
+            });
+
+            // data->filledSpectra = min(data->filledSpectra + 1, data->capacity);
+            let last_filled = ctx.b.build_load(&filled_ptr, "lastfilled").into_int_value();
+            let is_full =
+                ctx.b
+                    .build_int_compare(IntPredicate::UGE, last_filled, capacity, "isfull");
+            let filled = ctx
+                .b
+                .build_select(
+                    is_full,
+                    capacity,
+                    ctx.b
+                        .build_int_add(last_filled, i64_type.const_int(1, false), ""),
+                    "filled",
+                ).into_int_value();
+            ctx.b.build_store(&filled_ptr, &filled);
+
+            // auto sumCount = min(partitionCount, data->filledSpectra);
+            let is_partly_filled = ctx.b.build_int_compare(
+                IntPredicate::UGT,
+                partition_count,
+                filled,
+                "ispartlyfilled",
+            );
+            let sum_partition_count = ctx
+                .b
+                .build_select(is_partly_filled, filled, partition_count, "sumcount")
+                .into_int_value();
+
+            // multiply each partition's spectrum with the input from that many partitions ago
+            let sum_bytes = ctx.b.build_int_mul(spectrum_bins, vec_size, "sumbytes");
+            build_zero_bytes(&mut ctx, sum_real_ptr, sum_bytes);
+            build_zero_bytes(&mut ctx, sum_imag_ptr, sum_bytes);
+            build_loop(
+                &mut ctx,
+                "partition",
+                sum_partition_count,
+                &mut |ctx, partition| {
+                    let unwrapped_spectrum = ctx.b.build_int_add(newest, partition, "");
+                    let is_wrapped = ctx.b.build_int_compare(
+                        IntPredicate::UGE,
+                        unwrapped_spectrum,
+                        capacity,
+                        "iswrapped",
+                    );
+                    let spectrum = ctx
+                        .b
+                        .build_select(
+                            is_wrapped,
+                            ctx.b.build_int_sub(unwrapped_spectrum, capacity, ""),
+                            unwrapped_spectrum,
+                            "spectrum",
+                        ).into_int_value();
+                    let x_offset = ctx.b.build_int_mul(spectrum, spectrum_stride, "");
+                    let x_ptr = build_item_ptr(ctx, spectra_ptr, x_offset);
+                    let h_offset = ctx.b.build_int_mul(partition, spectrum_stride, "");
+                    let h_ptr = build_item_ptr(ctx, ir_spectra_ptr, h_offset);
+
+                    build_loop(ctx, "bin", spectrum_bins, &mut |ctx, bin| {
+                        let real_offset =
+                            ctx.b.build_int_mul(bin, i64_type.const_int(2, false), "");
+                        let imag_offset =
+                            ctx.b
+                                .build_int_add(real_offset, i64_type.const_int(1, false), "");
+                        let load_item = |ctx: &mut BuilderContext,
+                                         ptr: PointerValue,
+                                         offset: IntValue,
+                                         name: &str| {
+                            let item_ptr = build_item_ptr(ctx, ptr, offset);
+                            ctx.b.build_load(&item_ptr, name).into_vector_value()
+                        };
+                        let x_real = load_item(ctx, x_ptr, real_offset, "x.real");
+                        let x_imag = load_item(ctx, x_ptr, imag_offset, "x.imag");
+                        let h_real = load_item(ctx, h_ptr, real_offset, "h.real");
+                        let h_imag = load_item(ctx, h_ptr, imag_offset, "h.imag");
+
+                        let sum_real_item_ptr = build_array_item_ptr(ctx, sum_real_ptr, bin);
+                        let sum_imag_item_ptr = build_array_item_ptr(ctx, sum_imag_ptr, bin);
+                        let sum_real = ctx
+                            .b
+                            .build_load(&sum_real_item_ptr, "sum.real")
+                            .into_vector_value();
+                        let sum_imag = ctx
+                            .b
+                            .build_load(&sum_imag_item_ptr, "sum.imag")
+                            .into_vector_value();
+
+                        let product_real = ctx.b.build_float_sub(
+                            ctx.b.build_float_mul(x_real, h_real, ""),
+                            ctx.b.build_float_mul(x_imag, h_imag, ""),
+                            "product.real",
+                        );
+                        let product_imag = ctx.b.build_float_add(
+                            ctx.b.build_float_mul(x_real, h_imag, ""),
+                            ctx.b.build_float_mul(x_imag, h_real, ""),
+                            "product.imag",
+                        );
+                        ctx.b.build_store(
+                            &sum_real_item_ptr,
+                            &ctx.b.build_float_add(sum_real, product_real, "newsum.real"),
+                        );
+                        ctx.b.build_store(
+                            &sum_imag_item_ptr,
+                            &ctx.b.build_float_add(sum_imag, product_imag, "newsum.imag"),
+                        );
+                    });
+                },
+            );
+
+            // inverse transform by transforming the conjugate, filling in the mirrored bins
+            build_loop(&mut ctx, "unload", transform_size, &mut |ctx, index| {
+                let bin_ptr = build_array_item_ptr(ctx, bit_reverse_ptr, index);
+                let bin = ctx.b.build_load(&bin_ptr, "bin").into_int_value();
+                let is_mirrored =
+                    ctx.b
+                        .build_int_compare(IntPredicate::UGE, bin, spectrum_bins, "ismirrored");
+                let source_bin = ctx
+                    .b
+                    .build_select(
+                        is_mirrored,
+                        ctx.b.build_int_sub(transform_size, bin, ""),
+                        bin,
+                        "sourcebin",
+                    ).into_int_value();
+
+                let source_real_ptr = build_array_item_ptr(ctx, sum_real_ptr, source_bin);
+                let source_real = ctx.b.build_load(&source_real_ptr, "source.real");
+                let source_imag_ptr = build_array_item_ptr(ctx, sum_imag_ptr, source_bin);
+                let source_imag = ctx
+                    .b
+                    .build_load(&source_imag_ptr, "source.imag")
+                    .into_vector_value();
+                let conjugate_imag = ctx
+                    .b
+                    .build_select(
+                        is_mirrored,
+                        source_imag,
+                        ctx.b.build_float_neg(&source_imag, ""),
+                        "conjugate.imag",
+                    ).into_vector_value();
+
+                let item_real_ptr = build_array_item_ptr(ctx, real_ptr, index);
+                ctx.b.build_store(&item_real_ptr, &source_real);
+                let item_imag_ptr = build_array_item_ptr(ctx, imag_ptr, index);
+                ctx.b.build_store(&item_imag_ptr, &conjugate_imag);
+            });
+            ctx.b
+                .build_call(&transform_func, &[&real_ptr, &imag_ptr], "", false);
+
+            // the first half is wrapped around from the circular convolution, so only the second
+            // half is output
+            let output_start_ptr =
+                build_array_item_ptr(&mut ctx, output_ptr, i64_type.const_int(0, false));
+            let real_latest_ptr = build_array_item_ptr(&mut ctx, real_ptr, partition_size);
+            util::copy_bytes(
+                ctx.b,
+                ctx.module,
+                real_latest_ptr,
+                output_start_ptr,
+                partition_bytes,
+            );
+
+            ctx.b.build_return(None);
+        });
+    }
+}
+
+impl Function for ConvolveFunction {
+    fn function_type() -> block::Function {
+        block::Function::Convolve
+    }
+
+    fn data_type(context: &Context) -> StructType {
+        let vec_type = context.f32_type().vec_type(2);
+
+        context.struct_type(
+            &[
+                &context.i64_type(),                         // input spectra capacity
+                &context.i64_type(),                         // newest input spectrum
+                &context.i64_type(),                         // filled input spectra
+                &vec_type.ptr_type(AddressSpace::Generic),   // input spectra
+                &context.i64_type(),                         // position in partition
+                &vec_type.array_type(TRANSFORM_SIZE as u32), // latest two partitions of input
+                &vec_type.array_type(PARTITION_SIZE as u32), // output partition
+                &vec_type.array_type(TRANSFORM_SIZE as u32), // transform real parts
+                &vec_type.array_type(TRANSFORM_SIZE as u32), // transform imaginary parts
+                &vec_type.array_type(SPECTRUM_BINS as u32),  // summed spectrum real parts
+                &vec_type.array_type(SPECTRUM_BINS as u32),  // summed spectrum imaginary parts
+            ],
+            false,
+        )
+    }
+
+    fn gen_construct(func: &mut FunctionContext) {
+        let construct_func = ConvolveFunction::get_construct_func(func.ctx.module);
+        let histories = func.ctx.b.build_load(
+            &globals::get_convolve_histories(func.ctx.module).as_pointer_value(),
+            "histories",
+        );
+        func.ctx.b.build_call(
+            &construct_func,
+            &[&histories, &func.data_ptr],
+            "",
+            false,
+        );
+    }
+
+    fn gen_call(
+        func: &mut FunctionContext,
+        args: &[PointerValue],
+        _varargs: Option<VarArgs>,
+        result: PointerValue,
+    ) {
+        let min_intrinsic = intrinsics::minnum_f32(func.ctx.module);
+        let max_intrinsic = intrinsics::maxnum_f32(func.ctx.module);
+
+        ConvolveFunction::build_partition_update_func(func.ctx.module, func.ctx.target);
+        let partition_update_func = ConvolveFunction::get_partition_update_func(func.ctx.module);
+
+        let input_num = NumValue::new(args[0]);
+        let slot_num = NumValue::new(args[1]);
+        let result_num = NumValue::new(result);
+        let i64_type = func.ctx.context.i64_type();
+
+        // find the impulse response in the slot, clamping the slot to the ones that exist
+        let slot_vec = slot_num.get_vec(func.ctx.b);
+        let slot_float = func
+            .ctx
+            .b
+            .build_extract_element(
+                &slot_vec,
+                &func.ctx.context.i32_type().const_int(0, false),
+                "",
+            ).into_float_value();
+        let slot_clamped = func
+            .ctx
+            .b
+            .build_call(
+                &max_intrinsic,
+                &[
+                    &func
+                        .ctx
+                        .b
+                        .build_call(
+                            &min_intrinsic,
+                            &[
+                                &slot_float,
+                                &func
+                                    .ctx
+                                    .context
+                                    .f32_type()
+                                    .const_float((globals::IMPULSE_RESPONSE_SLOTS - 1) as f64),
+                            ],
+                            "",
+                            false,
+                        ).left()
+                        .unwrap()
+                        .into_float_value(),
+                    &func.ctx.context.f32_type().const_float(0.),
+                ],
+                "slot.clamped",
+                false,
+            ).left()
+            .unwrap()
+            .into_float_value();
+        let slot_index = func
+            .ctx
+            .b
+            .build_float_to_unsigned_int(slot_clamped, i64_type, "slot");
+        let ir_ptr_ptr = unsafe {
+            func.ctx.b.build_in_bounds_gep(
+                &globals::get_impulse_responses(func.ctx.module).as_pointer_value(),
+                &[i64_type.const_int(0, false), slot_index],
+                "ir.ptr",
+            )
+        };
+        let ir_ptr = func.ctx.b.build_pointer_cast(
+            func.ctx
+                .b
+                .build_load(&ir_ptr_ptr, "ir")
+                .into_pointer_value(),
+            ConvolveFunction::impulse_response_type(func.ctx.context)
+                .ptr_type(AddressSpace::Generic),
+            "ir",
+        );
+
+        // data->input[PARTITION_SIZE + position] = input;
+        let position_ptr = unsafe {
+            func.ctx
+                .b
+                .build_struct_gep(&func.data_ptr, 4, "position.ptr")
+        };
+        let position = func
+            .ctx
+            .b
+            .build_load(&position_ptr, "position")
+            .into_int_value();
+        let input_ptr = unsafe { func.ctx.b.build_struct_gep(&func.data_ptr, 5, "input") };
+        let input_index = func.ctx.b.build_int_add(
+            position,
+            i64_type.const_int(PARTITION_SIZE as u64, false),
+            "inputindex",
+        );
+        let input_item_ptr = build_array_item_ptr(&mut func.ctx, input_ptr, input_index);
+        let input_vec = input_num.get_vec(func.ctx.b);
+        func.ctx.b.build_store(&input_item_ptr, &input_vec);
+
+        // result = data->output[position];
+        let output_ptr = unsafe { func.ctx.b.build_struct_gep(&func.data_ptr, 6, "output") };
+        let output_item_ptr = build_array_item_ptr(&mut func.ctx, output_ptr, position);
+        let output_vec = func
+            .ctx
+            .b
+            .build_load(&output_item_ptr, "output")
+            .into_vector_value();
+        result_num.set_vec(func.ctx.b, &output_vec);
+
+        // once a partition has been collected, convolve it and start the next one
+        let next_position =
+            func.ctx
+                .b
+                .build_int_nuw_add(position, i64_type.const_int(1, false), "nextposition");
+        let is_full = func.ctx.b.build_int_compare(
+            IntPredicate::EQ,
+            next_position,
+            i64_type.const_int(PARTITION_SIZE as u64, false),
+            "isfull",
+        );
+        let full_block = func
+            .ctx
+            .context
+            .append_basic_block(&func.ctx.func, "full.true");
+        let full_continue_block = func
+            .ctx
+            .context
+            .append_basic_block(&func.ctx.func, "full.continue");
+        func.ctx.b.build_store(&position_ptr, &next_position);
+        func.ctx
+            .b
+            .build_conditional_branch(&is_full, &full_block, &full_continue_block);
+
+        func.ctx.b.position_at_end(&full_block);
+        func.ctx.b.build_call(
+            &partition_update_func,
+            &[&func.data_ptr, &ir_ptr],
+            "",
+            false,
+        );
+        func.ctx
+            .b
+            .build_store(&position_ptr, &i64_type.const_int(0, false));
+        func.ctx.b.build_unconditional_branch(&full_continue_block);
+
+        func.ctx.b.position_at_end(&full_continue_block);
+        let input_form = input_num.get_form(func.ctx.b);
+        result_num.set_form(func.ctx.b, &input_form);
+    }
+}
@@ -1,5 +1,6 @@
 mod biquad_filter_function;
 mod channel_function;
+mod convolve_function;
 mod defer_function;
 mod delay_function;
 mod function_context;
@@ -7,11 +8,13 @@ mod indexed_function;
 mod note_function;
 mod num_function;
 mod oscillator_function;
+mod sampler_function;
 mod scalar_intrinsic_function;
 mod sv_filter_function;
 mod vector_intrinsic_function;
 mod vector_shuffle_function;
 mod voices_function;
+mod wavetable_function;
 
 use codegen::{build_context_function, util, values, BuilderContext, TargetProperties};
 use inkwell::attribute::AttrKind;
@@ -31,18 +34,21 @@ use self::function_context::FunctionContext;
 
 pub use self::biquad_filter_function::*;
 pub use self::channel_function::*;
+pub use self::convolve_function::*;
 pub use self::defer_function::*;
 pub use self::delay_function::*;
 pub use self::indexed_function::*;
 pub use self::note_function::*;
 pub use self::num_function::*;
 pub use self::oscillator_function::*;
+pub use self::sampler_function::*;
 pub use self::scalar_intrinsic_function::*;
 pub use self::sv_filter_function::*;
 pub use self::vector_intrinsic_function::*;
 pub use self::vector_shuffle_function::*;
 pub use self::voices_function::*;
 pub use self::voices_function::*;
+pub use self::wavetable_function::*;
 
 pub enum FunctionLifecycleFunc {
     Construct,
@@ -139,8 +145,11 @@ map_functions! {
     Sequence => SequenceFunction,
     Min => MinFunction,
     Max => MaxFunction,
+    Table => TableFunction,
     Next => NextFunction,
     Delay => DelayFunction,
+    Convolve => ConvolveFunction,
+    Sampler => SamplerFunction,
     Amplitude => AmplitudeFunction,
     Hold => HoldFunction,
     Accum => AccumFunction,
@@ -152,6 +161,11 @@ map_functions! {
     SawOsc => SawOscFunction,
     TriOsc => TriOscFunction,
     RmpOsc => RmpOscFunction,
+    SinTblOsc => SinTblOscFunction,
+    SqrTblOsc => SqrTblOscFunction,
+    SawTblOsc => SawTblOscFunction,
+    TriTblOsc => TriTblOscFunction,
+    RmpTblOsc => RmpTblOscFunction,
     LowBqFilter => LowBqFilterFunction,
     HighBqFilter => HighBqFilterFunction,
     BandBqFilter => BandBqFilterFunction,
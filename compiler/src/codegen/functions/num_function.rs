@@ -352,6 +352,26 @@ impl Function for MixFunction {
     }
 }
 
+// Calls to `table` are replaced with lookups while lowering (see `util::tabulate`), or with the
+// expression itself if it can't be tabulated, so this only ever passes the expression through.
+pub struct TableFunction {}
+impl Function for TableFunction {
+    fn function_type() -> block::Function {
+        block::Function::Table
+    }
+
+    fn gen_call(
+        func: &mut FunctionContext,
+        args: &[PointerValue],
+        _varargs: Option<VarArgs>,
+        result: PointerValue,
+    ) {
+        let expr_num = NumValue::new(args[0]);
+        let result_num = NumValue::new(result);
+        expr_num.copy_to(func.ctx.b, func.ctx.module, &result_num);
+    }
+}
+
 pub struct SequenceFunction {}
 impl Function for SequenceFunction {
     fn function_type() -> block::Function {
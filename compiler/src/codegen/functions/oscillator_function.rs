@@ -9,7 +9,7 @@ use inkwell::FloatPredicate;
 use mir::block;
 use std::f32::consts;
 
-fn gen_periodic_real_args(
+pub fn gen_periodic_real_args(
     ctx: &mut BuilderContext,
     mut args: Vec<PointerValue>,
     needs_pulse_width: bool,
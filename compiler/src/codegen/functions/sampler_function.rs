@@ -0,0 +1,182 @@
+use super::{Function, FunctionContext, VarArgs};
+use ast::FormType;
+use codegen::values::NumValue;
+use codegen::{build_context_function, globals, util, BuilderContext, TargetProperties};
+use inkwell::context::Context;
+use inkwell::module::{Linkage, Module};
+use inkwell::types::StructType;
+use inkwell::values::{FunctionValue, PointerValue};
+use inkwell::AddressSpace;
+use mir::block;
+
+// Implemented by the runtime's sample streamer, see `frontend::sampler`.
+const READ_FUNC_NAME: &str = "maxim_sampler_read";
+const RELEASE_FUNC_NAME: &str = "maxim_sampler_release";
+
+pub struct SamplerFunction {}
+impl SamplerFunction {
+    fn get_read_func(module: &Module) -> FunctionValue {
+        util::get_or_create_func(module, READ_FUNC_NAME, false, &|| {
+            let context = module.get_context();
+            (
+                Linkage::ExternalLinkage,
+                context.void_type().fn_type(
+                    &[
+                        &context
+                            .i8_type()
+                            .ptr_type(AddressSpace::Generic)
+                            .ptr_type(AddressSpace::Generic), // samples in each slot
+                        &SamplerFunction::data_type(&context).ptr_type(AddressSpace::Generic),
+                        &context.f32_type(), // gate
+                        &context.f32_type(), // slot
+                        &context.f32_type(), // sample rate
+                    ],
+                    false,
+                ),
+            )
+        })
+    }
+
+    fn get_release_func(module: &Module) -> FunctionValue {
+        util::get_or_create_func(module, RELEASE_FUNC_NAME, false, &|| {
+            let context = module.get_context();
+            (
+                Linkage::ExternalLinkage,
+                context.void_type().fn_type(
+                    &[
+                        &context
+                            .i8_type()
+                            .ptr_type(AddressSpace::Generic)
+                            .ptr_type(AddressSpace::Generic), // samples in each slot
+                        &SamplerFunction::data_type(&context).ptr_type(AddressSpace::Generic),
+                    ],
+                    false,
+                ),
+            )
+        })
+    }
+
+    fn build_samples_ptr(ctx: &mut BuilderContext) -> PointerValue {
+        let zero = ctx.context.i64_type().const_int(0, false);
+        unsafe {
+            ctx.b.build_in_bounds_gep(
+                &globals::get_samples(ctx.module).as_pointer_value(),
+                &[zero, zero],
+                "samples",
+            )
+        }
+    }
+
+    /// Builds versions of the functions that play samples that do nothing, for modules that run
+    /// without a runtime to load samples into (i.e exported objects). Nodes only ever output
+    /// silence.
+    pub fn build_silent_funcs(module: &Module, target: &TargetProperties) {
+        let read_func = SamplerFunction::get_read_func(module);
+        build_context_function(module, read_func, target, &|ctx: BuilderContext| {
+            let voice_ptr = ctx.func.get_nth_param(1).unwrap().into_pointer_value();
+            let output_ptr = unsafe { ctx.b.build_struct_gep(&voice_ptr, 0, "output.ptr") };
+            ctx.b
+                .build_store(&output_ptr, &util::get_vec_spread(ctx.context, 0.));
+            ctx.b.build_return(None);
+        });
+
+        let release_func = SamplerFunction::get_release_func(module);
+        build_context_function(module, release_func, target, &|ctx: BuilderContext| {
+            ctx.b.build_return(None);
+        });
+    }
+}
+
+impl Function for SamplerFunction {
+    fn function_type() -> block::Function {
+        block::Function::Sampler
+    }
+
+    /// The state of a voice playing samples, see `frontend::SamplerVoice`.
+    fn data_type(context: &Context) -> StructType {
+        context.struct_type(
+            &[
+                &context.f32_type().vec_type(2), // output
+                &context.f32_type().vec_type(2), // second to last frame read
+                &context.f32_type().vec_type(2), // last frame read
+                &context.i64_type(),             // ID of the sample being played
+                &context.i64_type(),             // stream being read from, plus one
+                &context.i64_type(),             // position in the sample
+                &context.i64_type(),             // slot of the sample being played
+                &context.f32_type(),             // phase between the last two frames
+                &context.f32_type(),             // gate on the last sample
+                &context.i32_type(),             // is playing
+            ],
+            false,
+        )
+    }
+
+    fn gen_call(
+        func: &mut FunctionContext,
+        args: &[PointerValue],
+        _varargs: Option<VarArgs>,
+        result: PointerValue,
+    ) {
+        let read_func = SamplerFunction::get_read_func(func.ctx.module);
+        let gate_num = NumValue::new(args[0]);
+        let slot_num = NumValue::new(args[1]);
+        let result_num = NumValue::new(result);
+
+        // only the left channels of the gate and slot are used
+        let left_index = func.ctx.context.i32_type().const_int(0, false);
+        let gate_vec = gate_num.get_vec(func.ctx.b);
+        let gate = func
+            .ctx
+            .b
+            .build_extract_element(&gate_vec, &left_index, "gate");
+        let slot_vec = slot_num.get_vec(func.ctx.b);
+        let slot = func
+            .ctx
+            .b
+            .build_extract_element(&slot_vec, &left_index, "slot");
+
+        let samplerate_vec = func
+            .ctx
+            .b
+            .build_load(
+                &globals::get_sample_rate(func.ctx.module).as_pointer_value(),
+                "samplerate",
+            ).into_vector_value();
+        let samplerate =
+            func.ctx
+                .b
+                .build_extract_element(&samplerate_vec, &left_index, "samplerate");
+
+        let samples_ptr = SamplerFunction::build_samples_ptr(&mut func.ctx);
+        func.ctx.b.build_call(
+            &read_func,
+            &[&samples_ptr, &func.data_ptr, &gate, &slot, &samplerate],
+            "",
+            false,
+        );
+
+        let output_ptr = unsafe { func.ctx.b.build_struct_gep(&func.data_ptr, 0, "output.ptr") };
+        let output_vec = func
+            .ctx
+            .b
+            .build_load(&output_ptr, "output")
+            .into_vector_value();
+        result_num.set_vec(func.ctx.b, &output_vec);
+        result_num.set_form(
+            func.ctx.b,
+            &func
+                .ctx
+                .context
+                .i8_type()
+                .const_int(FormType::Oscillator as u64, false),
+        );
+    }
+
+    fn gen_destruct(func: &mut FunctionContext) {
+        let release_func = SamplerFunction::get_release_func(func.ctx.module);
+        let samples_ptr = SamplerFunction::build_samples_ptr(&mut func.ctx);
+        func.ctx
+            .b
+            .build_call(&release_func, &[&samples_ptr, &func.data_ptr], "", false);
+    }
+}
@@ -0,0 +1,471 @@
+use super::oscillator_function::gen_periodic_real_args;
+use super::{Function, FunctionContext, VarArgs};
+use ast::FormType;
+use codegen::values::NumValue;
+use codegen::{globals, intrinsics, util, BuilderContext};
+use inkwell::context::Context;
+use inkwell::module::Module;
+use inkwell::types::StructType;
+use inkwell::values::{FloatValue, GlobalValue, PointerValue, VectorValue};
+use inkwell::FloatPredicate;
+use mir::block;
+use std::f64::consts;
+
+// Each table stores one cycle of a waveform at a number of mip levels. Level `n` only contains
+// the harmonics up to `TABLE_SIZE / 2 >> n`, so picking the level from the frequency keeps the
+// output band-limited. Every level is followed by its first two samples again, so interpolating
+// doesn't need to wrap the index.
+const TABLE_SIZE: usize = 2048;
+const TABLE_STRIDE: usize = TABLE_SIZE + 2;
+const TABLE_LEVELS: usize = 11;
+
+struct Wavetable {
+    name: &'static str,
+    samples: Vec<f32>,
+}
+
+// Builds the mip levels of a waveform by summing its harmonics, from the level with the fewest
+// harmonics up. `harmonic_amplitude` returns the amplitude of the sine and cosine components of
+// each harmonic.
+fn build_wavetable(
+    name: &'static str,
+    levels: usize,
+    harmonic_amplitude: &Fn(usize) -> (f64, f64),
+) -> Wavetable {
+    let sines: Vec<_> = (0..TABLE_SIZE)
+        .map(|index| (index as f64 / TABLE_SIZE as f64 * consts::PI * 2.).sin())
+        .collect();
+
+    let mut cycle = vec![0.; TABLE_SIZE];
+    let mut samples = vec![0.; levels * TABLE_STRIDE];
+    let mut harmonic = 1;
+    for level in (0..levels).rev() {
+        let max_harmonic = (TABLE_SIZE / 2) >> level;
+        while harmonic <= max_harmonic {
+            let (sin_amplitude, cos_amplitude) = harmonic_amplitude(harmonic);
+            if sin_amplitude != 0. || cos_amplitude != 0. {
+                for (index, sample) in cycle.iter_mut().enumerate() {
+                    let sin_index = (index * harmonic) % TABLE_SIZE;
+                    let cos_index = (sin_index + TABLE_SIZE / 4) % TABLE_SIZE;
+                    *sample += sin_amplitude * sines[sin_index] + cos_amplitude * sines[cos_index];
+                }
+            }
+            harmonic += 1;
+        }
+
+        let level_samples = &mut samples[level * TABLE_STRIDE..(level + 1) * TABLE_STRIDE];
+        for (index, sample) in level_samples.iter_mut().enumerate() {
+            *sample = cycle[index % TABLE_SIZE] as f32;
+        }
+    }
+
+    Wavetable { name, samples }
+}
+
+lazy_static! {
+    static ref SIN_TABLE: Wavetable =
+        build_wavetable("maxim.wavetable.sin", 1, &|harmonic| match harmonic {
+            1 => (1., 0.),
+            _ => (0., 0.),
+        });
+
+    // matches `sawOsc`, rising from -1 to 1
+    static ref SAW_TABLE: Wavetable =
+        build_wavetable("maxim.wavetable.saw", TABLE_LEVELS, &|harmonic| {
+            (-2. / (consts::PI * harmonic as f64), 0.)
+        });
+
+    // matches `triOsc`, starting at 1
+    static ref TRI_TABLE: Wavetable =
+        build_wavetable("maxim.wavetable.tri", TABLE_LEVELS, &|harmonic| {
+            if harmonic % 2 == 1 {
+                (0., 8. / (consts::PI * consts::PI * (harmonic * harmonic) as f64))
+            } else {
+                (0., 0.)
+            }
+        });
+}
+
+fn get_table_global(module: &Module, table: &Wavetable) -> GlobalValue {
+    if let Some(global) = module.get_global(table.name) {
+        return global;
+    }
+
+    let context = module.get_context();
+    let sample_values: Vec<_> = table
+        .samples
+        .iter()
+        .map(|&sample| context.f32_type().const_float(sample as f64))
+        .collect();
+    let table_const = context.f32_type().const_array(&sample_values);
+    let global = module.add_global(&table_const.get_type(), None, table.name);
+    global.set_constant(true);
+    global.set_initializer(&table_const);
+    global
+}
+
+// Wraps the value into [0, 1). Infinities and NaNs wrap to NaN, which maxnum turns into 0 so they
+// can't get stuck in the phase.
+fn build_wrap(func: &mut FunctionContext, val: VectorValue, name: &str) -> VectorValue {
+    let floor_intrinsic = intrinsics::floor_v2f32(func.ctx.module);
+    let max_intrinsic = intrinsics::maxnum_v2f32(func.ctx.module);
+    let floored = func
+        .ctx
+        .b
+        .build_call(&floor_intrinsic, &[&val], "", false)
+        .left()
+        .unwrap()
+        .into_vector_value();
+    let wrapped = func.ctx.b.build_float_sub(val, floored, "");
+    func.ctx
+        .b
+        .build_call(
+            &max_intrinsic,
+            &[&wrapped, &util::get_vec_spread(func.ctx.context, 0.)],
+            name,
+            false,
+        ).left()
+        .unwrap()
+        .into_vector_value()
+}
+
+// Finds the mip level to use for each channel, i.e the number of octaves the frequency is above
+// the point where the first level's highest harmonic reaches Nyquist.
+fn build_table_level(func: &mut FunctionContext, freq: VectorValue) -> VectorValue {
+    let abs_intrinsic = intrinsics::fabs_v2f32(func.ctx.module);
+
+    let samplerate = func
+        .ctx
+        .b
+        .build_load(
+            &globals::get_sample_rate(func.ctx.module).as_pointer_value(),
+            "samplerate",
+        ).into_vector_value();
+    let abs_freq = func
+        .ctx
+        .b
+        .build_call(&abs_intrinsic, &[&freq], "", false)
+        .left()
+        .unwrap()
+        .into_vector_value();
+    let ratio = func.ctx.b.build_float_div(
+        func.ctx.b.build_float_mul(
+            abs_freq,
+            util::get_vec_spread(func.ctx.context, TABLE_SIZE as f32),
+            "",
+        ),
+        samplerate,
+        "levelratio",
+    );
+
+    let zero_vec = util::get_vec_spread(func.ctx.context, 0.);
+    let one_vec = util::get_vec_spread(func.ctx.context, 1.);
+    (0..TABLE_LEVELS - 1).fold(zero_vec, |level, octave| {
+        let is_above = func.ctx.b.build_float_compare(
+            FloatPredicate::OGE,
+            ratio,
+            util::get_vec_spread(func.ctx.context, (1 << octave) as f32),
+            "",
+        );
+        let increment = func
+            .ctx
+            .b
+            .build_select(is_above, one_vec, zero_vec, "")
+            .into_vector_value();
+        func.ctx.b.build_float_add(level, increment, "level")
+    })
+}
+
+// Reads the table at the phase (which should be in [0, 1)) with linear interpolation. The position
+// is clamped to the level before it's converted to an index, so a phase that isn't in range (or
+// is NaN) can't read outside of the table.
+fn build_table_lookup(
+    func: &mut FunctionContext,
+    table: &Wavetable,
+    level: Option<VectorValue>,
+    phase: VectorValue,
+) -> VectorValue {
+    let floor_intrinsic = intrinsics::floor_v2f32(func.ctx.module);
+    let min_intrinsic = intrinsics::minnum_v2f32(func.ctx.module);
+    let max_intrinsic = intrinsics::maxnum_v2f32(func.ctx.module);
+    let table_ptr = get_table_global(func.ctx.module, table).as_pointer_value();
+
+    let position = func.ctx.b.build_float_mul(
+        phase,
+        util::get_vec_spread(func.ctx.context, TABLE_SIZE as f32),
+        "",
+    );
+    let position = func
+        .ctx
+        .b
+        .build_call(
+            &max_intrinsic,
+            &[&position, &util::get_vec_spread(func.ctx.context, 0.)],
+            "",
+            false,
+        ).left()
+        .unwrap()
+        .into_vector_value();
+    // the first sample is repeated after the end, so the end of the cycle can still be read
+    let position = func
+        .ctx
+        .b
+        .build_call(
+            &min_intrinsic,
+            &[
+                &position,
+                &util::get_vec_spread(func.ctx.context, TABLE_SIZE as f32),
+            ],
+            "position",
+            false,
+        ).left()
+        .unwrap()
+        .into_vector_value();
+    let position_floor = func
+        .ctx
+        .b
+        .build_call(&floor_intrinsic, &[&position], "", false)
+        .left()
+        .unwrap()
+        .into_vector_value();
+    let position_frac = func
+        .ctx
+        .b
+        .build_float_sub(position, position_floor, "positionfrac");
+
+    let mut start_vec = util::get_vec_spread(func.ctx.context, 0.);
+    let mut end_vec = util::get_vec_spread(func.ctx.context, 0.);
+    for channel in 0..2 {
+        let channel_index = func.ctx.context.i32_type().const_int(channel, false);
+        let get_channel_int = |func: &mut FunctionContext, vec: VectorValue| {
+            let channel_val = func
+                .ctx
+                .b
+                .build_extract_element(&vec, &channel_index, "")
+                .into_float_value();
+            func.ctx
+                .b
+                .build_float_to_unsigned_int(channel_val, func.ctx.context.i32_type(), "")
+        };
+
+        let mut sample_index = get_channel_int(func, position_floor);
+        if let Some(level) = level {
+            let level_offset = func.ctx.b.build_int_mul(
+                get_channel_int(func, level),
+                func.ctx
+                    .context
+                    .i32_type()
+                    .const_int(TABLE_STRIDE as u64, false),
+                "leveloffset",
+            );
+            sample_index = func
+                .ctx
+                .b
+                .build_int_add(sample_index, level_offset, "sampleindex");
+        }
+        let next_sample_index = func.ctx.b.build_int_add(
+            sample_index,
+            func.ctx.context.i32_type().const_int(1, false),
+            "nextsampleindex",
+        );
+
+        let load_sample = |func: &mut FunctionContext, index| -> FloatValue {
+            let sample_ptr = unsafe {
+                func.ctx.b.build_in_bounds_gep(
+                    &table_ptr,
+                    &[func.ctx.context.i32_type().const_int(0, false), index],
+                    "sample.ptr",
+                )
+            };
+            func.ctx
+                .b
+                .build_load(&sample_ptr, "sample")
+                .into_float_value()
+        };
+        let start_sample = load_sample(func, sample_index);
+        let end_sample = load_sample(func, next_sample_index);
+        start_vec = func
+            .ctx
+            .b
+            .build_insert_element(&start_vec, &start_sample, &channel_index, "")
+            .into_vector_value();
+        end_vec = func
+            .ctx
+            .b
+            .build_insert_element(&end_vec, &end_sample, &channel_index, "")
+            .into_vector_value();
+    }
+
+    let sample_diff = func.ctx.b.build_float_sub(end_vec, start_vec, "");
+    func.ctx.b.build_float_add(
+        start_vec,
+        func.ctx.b.build_float_mul(sample_diff, position_frac, ""),
+        "sample",
+    )
+}
+
+fn table_data_type(context: &Context) -> StructType {
+    context.struct_type(&[&context.f32_type().vec_type(2)], false)
+}
+
+// Same interface as the periodic oscillators, but the phase is kept in [0, 1) with floor instead
+// of `frem`, and the output is read from a table.
+fn gen_table_call(
+    func: &mut FunctionContext,
+    args: &[PointerValue],
+    result: PointerValue,
+    next_val: &Fn(&mut FunctionContext, VectorValue, VectorValue, &[PointerValue]) -> VectorValue,
+) {
+    let phase_ptr = unsafe { func.ctx.b.build_struct_gep(&func.data_ptr, 0, "phase.ptr") };
+
+    let freq_num = NumValue::new(args[0]);
+    let phase_offset_num = NumValue::new(args[1]);
+    let result_num = NumValue::new(result);
+
+    let freq_vec = freq_num.get_vec(func.ctx.b);
+
+    // advance the phase and store the new value
+    let phase = func
+        .ctx
+        .b
+        .build_load(&phase_ptr, "phase")
+        .into_vector_value();
+    let samplerate = func
+        .ctx
+        .b
+        .build_load(
+            &globals::get_sample_rate(func.ctx.module).as_pointer_value(),
+            "samplerate",
+        ).into_vector_value();
+    let phase_increment = func
+        .ctx
+        .b
+        .build_float_div(freq_vec, samplerate, "phaseincrement");
+    let new_phase = func
+        .ctx
+        .b
+        .build_float_add(phase, phase_increment, "newphase");
+    let wrapped_phase = build_wrap(func, new_phase, "wrappedphase");
+    func.ctx.b.build_store(&phase_ptr, &wrapped_phase);
+
+    // calculate result
+    let phase_offset_vec = phase_offset_num.get_vec(func.ctx.b);
+    let input_phase = func
+        .ctx
+        .b
+        .build_float_add(phase_offset_vec, phase, "inputphase");
+    let input_phase = build_wrap(func, input_phase, "inputphase");
+
+    let result_vec = next_val(func, freq_vec, input_phase, &args[2..]);
+
+    result_num.set_vec(func.ctx.b, &result_vec);
+    result_num.set_form(
+        func.ctx.b,
+        &func
+            .ctx
+            .context
+            .i8_type()
+            .const_int(FormType::Oscillator as u64, false),
+    );
+}
+
+macro_rules! define_table_func (
+    ($func_name:ident: $func_type:expr, $needs_pulse_width:expr => $callback:expr) => (
+        pub struct $func_name {}
+        impl Function for $func_name {
+            fn function_type() -> block::Function { $func_type }
+            fn gen_real_args(ctx: &mut BuilderContext, args: Vec<PointerValue>) -> Vec<PointerValue> {
+                gen_periodic_real_args(ctx, args, $needs_pulse_width)
+            }
+            fn data_type(context: &Context) -> StructType {
+                table_data_type(context)
+            }
+            fn gen_call(func: &mut FunctionContext, args: &[PointerValue], _varargs: Option<VarArgs>, result: PointerValue) {
+                gen_table_call(func, args, result, &$callback)
+            }
+        }
+    )
+);
+
+fn sin_table_next_value(
+    func: &mut FunctionContext,
+    _freq: VectorValue,
+    phase: VectorValue,
+    _extra_args: &[PointerValue],
+) -> VectorValue {
+    build_table_lookup(func, &SIN_TABLE, None, phase)
+}
+define_table_func!(SinTblOscFunction: block::Function::SinTblOsc, false => sin_table_next_value);
+
+// A pulse is the difference between two saws offset by the pulse width.
+fn sqr_table_next_value(
+    func: &mut FunctionContext,
+    freq: VectorValue,
+    phase: VectorValue,
+    extra_args: &[PointerValue],
+) -> VectorValue {
+    let pulse_width = NumValue::new(extra_args[0]);
+    let pulse_width_vec = pulse_width.get_vec(func.ctx.b);
+
+    let level = build_table_level(func, freq);
+    let shifted_phase = func
+        .ctx
+        .b
+        .build_float_sub(phase, pulse_width_vec, "shiftedphase");
+    let shifted_phase = build_wrap(func, shifted_phase, "shiftedphase");
+    let saw = build_table_lookup(func, &SAW_TABLE, Some(level), phase);
+    let shifted_saw = build_table_lookup(func, &SAW_TABLE, Some(level), shifted_phase);
+
+    let dc_offset = func.ctx.b.build_float_sub(
+        func.ctx.b.build_float_mul(
+            pulse_width_vec,
+            util::get_vec_spread(func.ctx.context, 2.),
+            "",
+        ),
+        util::get_vec_spread(func.ctx.context, 1.),
+        "dcoffset",
+    );
+    func.ctx.b.build_float_add(
+        func.ctx.b.build_float_sub(shifted_saw, saw, ""),
+        dc_offset,
+        "result",
+    )
+}
+define_table_func!(SqrTblOscFunction: block::Function::SqrTblOsc, true => sqr_table_next_value);
+
+fn saw_table_next_value(
+    func: &mut FunctionContext,
+    freq: VectorValue,
+    phase: VectorValue,
+    _extra_args: &[PointerValue],
+) -> VectorValue {
+    let level = build_table_level(func, freq);
+    build_table_lookup(func, &SAW_TABLE, Some(level), phase)
+}
+define_table_func!(SawTblOscFunction: block::Function::SawTblOsc, false => saw_table_next_value);
+
+fn tri_table_next_value(
+    func: &mut FunctionContext,
+    freq: VectorValue,
+    phase: VectorValue,
+    _extra_args: &[PointerValue],
+) -> VectorValue {
+    let level = build_table_level(func, freq);
+    build_table_lookup(func, &TRI_TABLE, Some(level), phase)
+}
+define_table_func!(TriTblOscFunction: block::Function::TriTblOsc, false => tri_table_next_value);
+
+// A ramp is an inverted saw.
+fn rmp_table_next_value(
+    func: &mut FunctionContext,
+    freq: VectorValue,
+    phase: VectorValue,
+    _extra_args: &[PointerValue],
+) -> VectorValue {
+    let level = build_table_level(func, freq);
+    let saw = build_table_lookup(func, &SAW_TABLE, Some(level), phase);
+    func.ctx
+        .b
+        .build_float_sub(util::get_vec_spread(func.ctx.context, 0.), saw, "result")
+}
+define_table_func!(RmpTblOscFunction: block::Function::RmpTblOsc, false => rmp_table_next_value);
@@ -1,9 +1,21 @@
 use codegen::util;
 use inkwell::module::Module;
 use inkwell::values::GlobalValue;
+use inkwell::AddressSpace;
 
 pub const SAMPLERATE_GLOBAL_NAME: &str = "maxim.samplerate";
 pub const BPM_GLOBAL_NAME: &str = "maxim.bpm";
+pub const WORKER_POOL_GLOBAL_NAME: &str = "maxim.workerpool";
+pub const IMPULSE_RESPONSES_GLOBAL_NAME: &str = "maxim.impulseresponses";
+pub const CONVOLVE_HISTORIES_GLOBAL_NAME: &str = "maxim.convolvehistories";
+pub const SAMPLES_GLOBAL_NAME: &str = "maxim.samples";
+
+/// The number of impulse responses that can be loaded for the `convolve` function at once.
+pub const IMPULSE_RESPONSE_SLOTS: usize = 16;
+
+/// The number of samples that can be loaded for the `sampler` function at once, enough for one for
+/// every MIDI note.
+pub const SAMPLE_SLOTS: usize = 128;
 
 pub fn get_sample_rate(module: &Module) -> GlobalValue {
     util::get_or_create_global(
@@ -21,7 +33,84 @@ pub fn get_bpm(module: &Module) -> GlobalValue {
     )
 }
 
+pub fn get_worker_pool(module: &Module) -> GlobalValue {
+    util::get_or_create_global(
+        module,
+        WORKER_POOL_GLOBAL_NAME,
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic),
+    )
+}
+
+/// An array of pointers to the impulse responses loaded into each slot, or null for empty slots.
+pub fn get_impulse_responses(module: &Module) -> GlobalValue {
+    util::get_or_create_global(
+        module,
+        IMPULSE_RESPONSES_GLOBAL_NAME,
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic)
+            .array_type(IMPULSE_RESPONSE_SLOTS as u32),
+    )
+}
+
+/// The runtime's `ConvolveHistories`, or null when running without a runtime.
+pub fn get_convolve_histories(module: &Module) -> GlobalValue {
+    util::get_or_create_global(
+        module,
+        CONVOLVE_HISTORIES_GLOBAL_NAME,
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic),
+    )
+}
+
+/// An array of pointers to the samples loaded into each slot, or null for empty slots.
+pub fn get_samples(module: &Module) -> GlobalValue {
+    util::get_or_create_global(
+        module,
+        SAMPLES_GLOBAL_NAME,
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic)
+            .array_type(SAMPLE_SLOTS as u32),
+    )
+}
+
 pub fn build_globals(module: &Module) {
     get_sample_rate(module).set_initializer(&util::get_vec_spread(&module.get_context(), 44100.));
     get_bpm(module).set_initializer(&util::get_vec_spread(&module.get_context(), 60.));
+    get_worker_pool(module).set_initializer(
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic)
+            .const_null(),
+    );
+
+    let null_ptr = module
+        .get_context()
+        .i8_type()
+        .ptr_type(AddressSpace::Generic)
+        .const_null();
+    get_impulse_responses(module).set_initializer(
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic)
+            .const_array(&vec![null_ptr; IMPULSE_RESPONSE_SLOTS]),
+    );
+    get_convolve_histories(module).set_initializer(&null_ptr);
+    get_samples(module).set_initializer(
+        &module
+            .get_context()
+            .i8_type()
+            .ptr_type(AddressSpace::Generic)
+            .const_array(&vec![null_ptr; SAMPLE_SLOTS]),
+    );
 }
@@ -67,6 +67,37 @@ pub fn memset(module: &Module, target: &TargetData) -> FunctionValue {
     })
 }
 
+// The builder can't set the ordering of loads and stores, so atomic accesses to data that's shared
+// with the editor go through functions the JIT provides instead.
+pub fn atomic_store_release_i32(module: &Module) -> FunctionValue {
+    util::get_or_create_func(module, "maxim_atomic_store_release_i32", false, &|| {
+        let context = module.get_context();
+        (
+            Linkage::ExternalLinkage,
+            context.void_type().fn_type(
+                &[
+                    &context.i32_type().ptr_type(AddressSpace::Generic),
+                    &context.i32_type(),
+                ],
+                false,
+            ),
+        )
+    })
+}
+
+pub fn atomic_load_relaxed_i32(module: &Module) -> FunctionValue {
+    util::get_or_create_func(module, "maxim_atomic_load_relaxed_i32", false, &|| {
+        let context = module.get_context();
+        (
+            Linkage::ExternalLinkage,
+            context.i32_type().fn_type(
+                &[&context.i32_type().ptr_type(AddressSpace::Generic)],
+                false,
+            ),
+        )
+    })
+}
+
 pub fn pow_v2f32(module: &Module) -> FunctionValue {
     util::get_or_create_func(module, "llvm.pow.v2f32", false, &|| {
         let context = module.get_context();
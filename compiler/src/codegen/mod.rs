@@ -2,6 +2,7 @@ pub mod block;
 mod builder_context;
 pub mod controls;
 pub mod converters;
+pub mod copy_elision;
 pub mod data_analyzer;
 pub mod editor;
 pub mod functions;
@@ -10,7 +11,9 @@ pub mod intrinsics;
 mod object_cache;
 mod optimizer;
 pub mod root;
+pub mod schedule;
 pub mod surface;
+mod target_isa;
 mod target_properties;
 pub mod util;
 pub mod values;
@@ -18,6 +21,7 @@ pub mod values;
 pub use self::builder_context::{build_context_function, BuilderContext};
 pub use self::object_cache::ObjectCache;
 pub use self::optimizer::Optimizer;
+pub use self::target_isa::TargetIsa;
 pub use self::target_properties::TargetProperties;
 
 use std::fmt;
@@ -3,6 +3,8 @@ use inkwell::module::Module;
 use inkwell::passes::{PassManager, PassManagerBuilder};
 use inkwell::values::FunctionValue;
 use inkwell::OptimizationLevel;
+use std::cell::Cell;
+use std::time::{Duration, Instant};
 
 struct ModuleFunctionIterator {
     next_func: Option<FunctionValue>,
@@ -34,6 +36,10 @@ impl Iterator for ModuleFunctionIterator {
 pub struct Optimizer {
     module_pass: PassManager,
     builder: PassManagerBuilder,
+
+    // Time spent optimizing since this was last taken, so commits can report it separately from
+    // building the IR.
+    elapsed: Cell<Duration>,
 }
 
 impl Optimizer {
@@ -61,10 +67,12 @@ impl Optimizer {
         Optimizer {
             module_pass,
             builder,
+            elapsed: Cell::new(Duration::from_secs(0)),
         }
     }
 
     pub fn optimize_module(&self, module: &Module) {
+        let start = Instant::now();
         if let Err(err) = module.verify() {
             module.print_to_stderr();
             panic!(err.to_string());
@@ -79,5 +87,11 @@ impl Optimizer {
             func_pass.run_on_function(&func);
         }
         self.module_pass.run_on_module(module);
+        self.elapsed.set(self.elapsed.get() + start.elapsed());
+    }
+
+    /// Returns how long has been spent optimizing modules since the last call.
+    pub fn take_elapsed(&self) -> Duration {
+        self.elapsed.replace(Duration::from_secs(0))
     }
 }
@@ -3,7 +3,7 @@ use codegen::values::remap_type;
 use codegen::{build_context_function, surface, util, BuilderContext, LifecycleFunc, ObjectCache};
 use inkwell::context::Context;
 use inkwell::module::{Linkage, Module};
-use inkwell::types::BasicType;
+use inkwell::types::{BasicType, StructType};
 use inkwell::values::{BasicValue, BasicValueEnum, GlobalValue, IntValue, PointerValue};
 use inkwell::AddressSpace;
 use mir::{Root, SurfaceRef};
@@ -85,22 +85,34 @@ pub fn build_initialized_global(
     global
 }
 
+fn get_scratch_type(context: &Context, cache: &ObjectCache, surface: SurfaceRef) -> StructType {
+    let layout = cache.surface_layout(surface).unwrap();
+    context.struct_type(&[&layout.scratch_struct, &layout.shared_struct], false)
+}
+
 pub fn build_scratch_global(
     module: &Module,
     cache: &ObjectCache,
     surface: SurfaceRef,
     name: &str,
 ) -> GlobalValue {
-    let layout = cache.surface_layout(surface).unwrap();
-    let virtual_scratch = module
-        .get_context()
-        .struct_type(&[&layout.scratch_struct, &layout.shared_struct], false);
+    let virtual_scratch = get_scratch_type(&module.get_context(), cache, surface);
     let global = util::get_or_create_global(module, name, &virtual_scratch);
     global.set_initializer(&virtual_scratch.const_null());
     //global.set_section("maxim.scratch");
     global
 }
 
+fn get_sockets_type(context: &Context, root: &Root) -> StructType {
+    let struct_types: Vec<_> = root
+        .sockets
+        .iter()
+        .map(|vartype| remap_type(context, vartype))
+        .collect();
+    let sockets_type_refs: Vec<_> = struct_types.iter().map(|ty| ty as &BasicType).collect();
+    context.struct_type(&sockets_type_refs, false)
+}
+
 pub struct SocketsGlobal {
     pub sockets: GlobalValue,
     pub socket_ptrs: GlobalValue,
@@ -113,19 +125,13 @@ pub fn build_sockets_global(
     pointers_name: &str,
 ) -> SocketsGlobal {
     let context = module.get_context();
-    let struct_types: Vec<_> = root
-        .sockets
-        .iter()
-        .map(|vartype| remap_type(&context, vartype))
-        .collect();
-    let sockets_type_refs: Vec<_> = struct_types.iter().map(|ty| ty as &BasicType).collect();
-    let sockets_struct_type = context.struct_type(&sockets_type_refs, false);
+    let sockets_struct_type = get_sockets_type(&context, root);
     let sockets_global = util::get_or_create_global(module, sockets_name, &sockets_struct_type);
     sockets_global.set_initializer(&sockets_struct_type.const_null());
     //sockets_global.set_section("maxim.sockets");
 
     let void_ptr_ty = context.i8_type().ptr_type(AddressSpace::Generic);
-    let array_itms: Vec<_> = (0..struct_types.len())
+    let array_itms: Vec<_> = (0..root.sockets.len())
         .map(|index| unsafe {
             sockets_global
                 .as_pointer_value()
@@ -147,6 +153,44 @@ pub fn build_sockets_global(
     }
 }
 
+pub struct StateGlobals {
+    pub initialized: GlobalValue,
+    pub scratch: GlobalValue,
+    pub sockets: GlobalValue,
+}
+
+/// Declares the globals holding a root's state without defining them, so code in another module
+/// can run on the state of the module that does.
+pub fn declare_state_globals(
+    module: &Module,
+    cache: &ObjectCache,
+    root: &Root,
+    surface: SurfaceRef,
+    initialized_name: &str,
+    scratch_name: &str,
+    sockets_name: &str,
+) -> StateGlobals {
+    let context = module.get_context();
+    let layout = cache.surface_layout(surface).unwrap();
+    StateGlobals {
+        initialized: util::get_or_create_global(
+            module,
+            initialized_name,
+            &layout.initialized_const.get_type(),
+        ),
+        scratch: util::get_or_create_global(
+            module,
+            scratch_name,
+            &get_scratch_type(&context, cache, surface),
+        ),
+        sockets: util::get_or_create_global(
+            module,
+            sockets_name,
+            &get_sockets_type(&context, root),
+        ),
+    }
+}
+
 pub fn build_pointers_global(
     module: &Module,
     cache: &ObjectCache,
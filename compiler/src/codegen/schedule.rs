@@ -0,0 +1,143 @@
+use mir::{NodeData, Surface};
+use std::cmp;
+use std::collections::HashMap;
+
+// A job's task count has to fit in the worker pool's claim word.
+pub const MAX_STAGE_TASKS: usize = 255;
+
+/// A group of nodes that are updated one after another on the same thread, in surface order.
+pub type Task = Vec<usize>;
+
+/// Tasks that don't depend on each other and can be updated at the same time. Stages are run in
+/// order, with each stage only starting after all tasks in the previous one have finished.
+pub type Stage = Vec<Task>;
+
+/// Splits a surface's nodes into stages of independent tasks, with no more than `max_tasks` tasks
+/// in each stage.
+///
+/// Two nodes depend on each other if they share a value group and at least one of them writes to
+/// it. The dependency goes in the direction of the surface's node order, so running the stages in
+/// order gives exactly the same results as updating each node in turn (including for feedback
+/// loops).
+pub fn build_schedule(surface: &Surface, max_tasks: usize) -> Vec<Stage> {
+    let max_tasks = cmp::max(cmp::min(max_tasks, MAX_STAGE_TASKS), 1);
+    let nodes: Vec<_> = surface
+        .nodes
+        .iter()
+        .enumerate()
+        .filter(|&(_, node)| node.data != NodeData::Dummy)
+        .map(|(index, _)| index)
+        .collect();
+    let predecessors = get_predecessors(surface, &nodes);
+
+    let mut successor_counts = vec![0; nodes.len()];
+    for node_predecessors in &predecessors {
+        for &predecessor in node_predecessors {
+            successor_counts[predecessor] += 1;
+        }
+    }
+
+    // Nodes in a chain (where each one is the only thing depending on the last) can't run at the
+    // same time as each other anyway, so they're merged into one cluster to avoid a stage for each.
+    let mut clusters: Vec<Task> = Vec::new();
+    let mut node_clusters = Vec::with_capacity(nodes.len());
+    let mut cluster_depths: Vec<usize> = Vec::new();
+    for (index, node_predecessors) in predecessors.iter().enumerate() {
+        if node_predecessors.len() == 1 && successor_counts[node_predecessors[0]] == 1 {
+            let cluster = node_clusters[node_predecessors[0]];
+            clusters[cluster].push(nodes[index]);
+            node_clusters.push(cluster);
+            continue;
+        }
+
+        // Predecessors always come earlier in the surface, so their depths are already known.
+        let depth = node_predecessors
+            .iter()
+            .map(|&predecessor| cluster_depths[node_clusters[predecessor]] + 1)
+            .max()
+            .unwrap_or(0);
+        node_clusters.push(clusters.len());
+        clusters.push(vec![nodes[index]]);
+        cluster_depths.push(depth);
+    }
+
+    let stage_count = cluster_depths
+        .iter()
+        .map(|&depth| depth + 1)
+        .max()
+        .unwrap_or(0);
+    let mut stages: Vec<Stage> = vec![Vec::new(); stage_count];
+    for (cluster, depth) in clusters.into_iter().zip(cluster_depths.into_iter()) {
+        stages[depth].push(cluster);
+    }
+
+    stages
+        .into_iter()
+        .map(|stage| balance_stage(stage, max_tasks))
+        .collect()
+}
+
+fn get_predecessors(surface: &Surface, nodes: &[usize]) -> Vec<Vec<usize>> {
+    // for each group: the last node to write to it, and nodes that have read it since
+    let mut last_writers: HashMap<usize, usize> = HashMap::new();
+    let mut readers: HashMap<usize, Vec<usize>> = HashMap::new();
+
+    let mut predecessors = Vec::with_capacity(nodes.len());
+    for (index, &node_index) in nodes.iter().enumerate() {
+        let mut node_predecessors = Vec::new();
+
+        for socket in &surface.nodes[node_index].sockets {
+            let writes = socket.value_written || socket.is_extractor;
+            if let Some(&writer) = last_writers.get(&socket.group_id) {
+                node_predecessors.push(writer);
+            }
+            if writes {
+                if let Some(group_readers) = readers.get_mut(&socket.group_id) {
+                    node_predecessors.extend(group_readers.drain(..));
+                }
+            }
+        }
+
+        for socket in &surface.nodes[node_index].sockets {
+            if socket.value_written || socket.is_extractor {
+                last_writers.insert(socket.group_id, index);
+            } else {
+                readers
+                    .entry(socket.group_id)
+                    .or_insert_with(Vec::new)
+                    .push(index);
+            }
+        }
+
+        node_predecessors.retain(|&predecessor| predecessor != index);
+        node_predecessors.sort();
+        node_predecessors.dedup();
+        predecessors.push(node_predecessors);
+    }
+
+    predecessors
+}
+
+// Merges the tasks in a stage down to at most `max_tasks`, handing each task (biggest first) to the
+// least loaded one. Node counts are a rough stand-in for how long each task takes to run.
+fn balance_stage(mut stage: Stage, max_tasks: usize) -> Stage {
+    if stage.len() <= max_tasks {
+        return stage;
+    }
+
+    stage.sort_by_key(|task| cmp::Reverse(task.len()));
+    let mut balanced: Stage = vec![Vec::new(); max_tasks];
+    for task in stage {
+        let target = balanced
+            .iter_mut()
+            .min_by_key(|target_task| target_task.len())
+            .unwrap();
+        target.extend(task);
+    }
+
+    // nodes in a task need to be updated in surface order
+    for task in &mut balanced {
+        task.sort();
+    }
+    balanced
+}
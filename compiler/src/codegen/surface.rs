@@ -1,11 +1,21 @@
+use codegen::schedule::{self, Stage};
 use codegen::{
-    block, build_context_function, util, values, BuilderContext, LifecycleFunc, ObjectCache,
+    block, build_context_function, globals, intrinsics, util, values, BuilderContext,
+    LifecycleFunc, ObjectCache,
 };
+use inkwell::basic_block::BasicBlock;
 use inkwell::builder::Builder;
 use inkwell::module::{Linkage, Module};
-use inkwell::values::{FunctionValue, PointerValue};
-use inkwell::{AddressSpace, IntPredicate};
-use mir::{Node, NodeData, Surface, SurfaceRef};
+use inkwell::values::{FunctionValue, IntValue, PointerValue};
+use inkwell::{AddressSpace, FloatPredicate, IntPredicate};
+use mir::{
+    ConstantValue, Node, NodeData, Surface, SurfaceRef, ValueGroup, ValueGroupSource, VarType,
+};
+
+/// The name of one of the surface's lifecycle functions.
+pub fn lifecycle_func_name(surface: SurfaceRef, lifecycle: LifecycleFunc) -> String {
+    format!("maxim.surface.{}.{}", surface, lifecycle)
+}
 
 fn get_lifecycle_func(
     module: &Module,
@@ -13,7 +23,7 @@ fn get_lifecycle_func(
     surface: SurfaceRef,
     lifecycle: LifecycleFunc,
 ) -> FunctionValue {
-    let func_name = format!("maxim.surface.{}.{}", surface, lifecycle);
+    let func_name = lifecycle_func_name(surface, lifecycle);
     util::get_or_create_func(module, &func_name, true, &|| {
         let context = module.get_context();
         let layout = cache.surface_layout(surface).unwrap();
@@ -27,24 +37,556 @@ fn get_lifecycle_func(
     })
 }
 
+// Implemented by the runtime's worker pool, see `frontend::worker_pool`.
+const RUN_TASKS_FUNC_NAME: &str = "maxim_run_parallel_tasks";
+
+/// The name of the function that runs a single task of a parallel surface update. The runtime
+/// looks this up after deploying the surface and registers it with the worker pool.
+pub fn task_dispatcher_name(surface: SurfaceRef) -> String {
+    format!("maxim.surface.{}.update.task", surface)
+}
+
+fn get_task_dispatcher_func(module: &Module, surface: SurfaceRef) -> FunctionValue {
+    util::get_or_create_func(module, &task_dispatcher_name(surface), true, &|| {
+        let context = module.get_context();
+        (
+            Linkage::ExternalLinkage,
+            context.void_type().fn_type(
+                &[
+                    &context.i8_type().ptr_type(AddressSpace::Generic),
+                    &context.i32_type(),
+                ],
+                false,
+            ),
+        )
+    })
+}
+
+fn get_run_tasks_func(module: &Module) -> FunctionValue {
+    util::get_or_create_func(module, RUN_TASKS_FUNC_NAME, false, &|| {
+        let context = module.get_context();
+        let void_ptr_type = context.i8_type().ptr_type(AddressSpace::Generic);
+        (
+            Linkage::ExternalLinkage,
+            context.void_type().fn_type(
+                &[
+                    &void_ptr_type,
+                    &context.i64_type(),
+                    &context.i32_type(),
+                    &context.i32_type(),
+                    &void_ptr_type,
+                ],
+                false,
+            ),
+        )
+    })
+}
+
+// Voices in an extract group are put to sleep once all of their notes have been released and all
+// of their audio outputs have stayed below the threshold for the hold time. Sleeping voices are
+// reset and skipped until they're woken up.
+const VOICE_SLEEP_THRESHOLD: f64 = 0.0001; // -80dB
+const VOICE_SLEEP_HOLD_SECONDS: f64 = 0.2;
+
+fn get_array_item_type<'a>(node: &Node, groups: &'a [ValueGroup], socket: usize) -> &'a VarType {
+    match &groups[node.sockets[socket].group_id].value_type {
+        VarType::Array(item_type) => item_type,
+        _ => unreachable!(),
+    }
+}
+
+struct VoiceSleep {
+    voices_scratch_ptr: PointerValue,
+    sleeping_ptr: PointerValue,
+    silent_counts_ptr: PointerValue,
+    held_counts_ptr: PointerValue,
+    hold_samples: IntValue,
+    midi_sources: Vec<usize>,
+    num_dests: Vec<usize>,
+}
+
+impl VoiceSleep {
+    fn new(
+        ctx: &mut BuilderContext,
+        pointers_ptr: PointerValue,
+        active_bitmap: IntValue,
+        midi_sources: Vec<usize>,
+        num_dests: Vec<usize>,
+    ) -> Self {
+        let voices_scratch_ptr = ctx
+            .b
+            .build_load(
+                &unsafe { ctx.b.build_struct_gep(&pointers_ptr, 4, "") },
+                "voicesscratch.ptr",
+            ).into_pointer_value();
+        let sleep_ptr = ctx
+            .b
+            .build_load(
+                &unsafe { ctx.b.build_struct_gep(&pointers_ptr, 5, "") },
+                "sleep.ptr",
+            ).into_pointer_value();
+        let sleeping_ptr = unsafe { ctx.b.build_struct_gep(&sleep_ptr, 0, "sleeping.ptr") };
+        let last_active_ptr = unsafe { ctx.b.build_struct_gep(&sleep_ptr, 1, "lastactive.ptr") };
+        let silent_counts_ptr =
+            unsafe { ctx.b.build_struct_gep(&sleep_ptr, 2, "silentcounts.ptr") };
+        let held_counts_ptr = unsafe { ctx.b.build_struct_gep(&sleep_ptr, 3, "heldcounts.ptr") };
+
+        // voices that have just become active (e.g a new note was assigned) always wake up
+        let last_active = ctx
+            .b
+            .build_load(&last_active_ptr, "lastactive")
+            .into_int_value();
+        ctx.b.build_store(&last_active_ptr, &active_bitmap);
+        let newly_active = ctx.b.build_and(
+            active_bitmap,
+            ctx.b.build_not(&last_active, ""),
+            "newlyactive",
+        );
+        let sleeping = ctx.b.build_load(&sleeping_ptr, "sleeping").into_int_value();
+        let sleeping = ctx
+            .b
+            .build_and(sleeping, ctx.b.build_not(&newly_active, ""), "sleeping");
+        ctx.b.build_store(&sleeping_ptr, &sleeping);
+
+        let samplerate = ctx
+            .b
+            .build_load(
+                &globals::get_sample_rate(ctx.module).as_pointer_value(),
+                "samplerate",
+            ).into_vector_value();
+        let samplerate = ctx
+            .b
+            .build_extract_element(&samplerate, &ctx.context.i32_type().const_int(0, false), "")
+            .into_float_value();
+        let hold_samples = ctx.b.build_float_to_unsigned_int(
+            ctx.b.build_float_mul(
+                samplerate,
+                ctx.context.f32_type().const_float(VOICE_SLEEP_HOLD_SECONDS),
+                "",
+            ),
+            ctx.context.i32_type(),
+            "holdsamples",
+        );
+
+        VoiceSleep {
+            voices_scratch_ptr,
+            sleeping_ptr,
+            silent_counts_ptr,
+            held_counts_ptr,
+            hold_samples,
+            midi_sources,
+            num_dests,
+        }
+    }
+
+    fn get_silent_count_ptr(&self, ctx: &mut BuilderContext, index: IntValue) -> PointerValue {
+        unsafe {
+            ctx.b.build_in_bounds_gep(
+                &self.silent_counts_ptr,
+                &[ctx.context.i32_type().const_int(0, false), index],
+                "silentcount.ptr",
+            )
+        }
+    }
+
+    fn get_held_count_ptr(&self, ctx: &mut BuilderContext, index: IntValue) -> PointerValue {
+        unsafe {
+            ctx.b.build_in_bounds_gep(
+                &self.held_counts_ptr,
+                &[ctx.context.i32_type().const_int(0, false), index],
+                "heldcount.ptr",
+            )
+        }
+    }
+
+    fn get_source_midi(
+        &self,
+        ctx: &mut BuilderContext,
+        source_socket_pointers: PointerValue,
+        source_index: usize,
+        index: IntValue,
+    ) -> values::MidiValue {
+        let source_array = values::ArrayValue::new(
+            ctx.b
+                .build_load(
+                    &unsafe {
+                        ctx.b
+                            .build_struct_gep(&source_socket_pointers, source_index as u32, "")
+                    },
+                    "",
+                ).into_pointer_value(),
+        );
+        values::MidiValue::new(source_array.get_item_ptr(ctx.b, index))
+    }
+
+    // Counts the notes the voice is holding from the events sent to it this sample, in the same
+    // way as `note`: note ons increment the count and note offs decrement it if it's above zero.
+    // Any event wakes a sleeping voice, so every event the voice receives passes through here.
+    // Returns the new count.
+    fn build_held_count_update(
+        &self,
+        ctx: &mut BuilderContext,
+        source_socket_pointers: PointerValue,
+        index: IntValue,
+    ) -> IntValue {
+        let held_count_ptr = self.get_held_count_ptr(ctx, index);
+        let event_index_ptr = ctx
+            .allocb
+            .build_alloca(&ctx.context.i8_type(), "eventindex.ptr");
+
+        for &source_index in &self.midi_sources {
+            let source_midi =
+                self.get_source_midi(ctx, source_socket_pointers, source_index, index);
+            let event_count = source_midi.get_count(ctx.b);
+            ctx.b
+                .build_store(&event_index_ptr, &ctx.context.i8_type().const_int(0, false));
+
+            let check_block = ctx.context.append_basic_block(&ctx.func, "heldcount.check");
+            let run_block = ctx.context.append_basic_block(&ctx.func, "heldcount.run");
+            let note_on_block = ctx
+                .context
+                .append_basic_block(&ctx.func, "heldcount.noteon");
+            let note_off_block = ctx
+                .context
+                .append_basic_block(&ctx.func, "heldcount.noteoff");
+            let end_block = ctx.context.append_basic_block(&ctx.func, "heldcount.end");
+            ctx.b.build_unconditional_branch(&check_block);
+
+            ctx.b.position_at_end(&check_block);
+            let event_index = ctx
+                .b
+                .build_load(&event_index_ptr, "eventindex")
+                .into_int_value();
+            let has_event =
+                ctx.b
+                    .build_int_compare(IntPredicate::ULT, event_index, event_count, "hasevent");
+            ctx.b
+                .build_conditional_branch(&has_event, &run_block, &end_block);
+
+            ctx.b.position_at_end(&run_block);
+            ctx.b.build_store(
+                &event_index_ptr,
+                &ctx.b
+                    .build_int_add(event_index, ctx.context.i8_type().const_int(1, false), ""),
+            );
+            let event_name = source_midi.get_event(ctx.b, event_index).get_name(ctx.b);
+            ctx.b.build_switch(
+                &event_name,
+                &check_block,
+                &[
+                    (&ctx.context.i8_type().const_int(0, false), &note_on_block), // 0 = note on
+                    (&ctx.context.i8_type().const_int(1, false), &note_off_block), // 1 = note off
+                ],
+            );
+
+            ctx.b.position_at_end(&note_on_block);
+            let held_count = ctx
+                .b
+                .build_load(&held_count_ptr, "heldcount")
+                .into_int_value();
+            ctx.b.build_store(
+                &held_count_ptr,
+                &ctx.b
+                    .build_int_add(held_count, ctx.context.i8_type().const_int(1, false), ""),
+            );
+            ctx.b.build_unconditional_branch(&check_block);
+
+            ctx.b.position_at_end(&note_off_block);
+            let held_count = ctx
+                .b
+                .build_load(&held_count_ptr, "heldcount")
+                .into_int_value();
+            let is_holding = ctx.b.build_int_compare(
+                IntPredicate::UGT,
+                held_count,
+                ctx.context.i8_type().const_int(0, false),
+                "",
+            );
+            let released_count = ctx.b.build_int_sub(
+                held_count,
+                ctx.b
+                    .build_int_z_extend(is_holding, ctx.context.i8_type(), ""),
+                "",
+            );
+            ctx.b.build_store(&held_count_ptr, &released_count);
+            ctx.b.build_unconditional_branch(&check_block);
+
+            ctx.b.position_at_end(&end_block);
+        }
+
+        ctx.b
+            .build_load(&held_count_ptr, "heldcount")
+            .into_int_value()
+    }
+
+    // Branches to `run_block` if the voice is awake, or wakes it up and branches to `run_block` if
+    // any MIDI events are being sent to it. Otherwise branches to `skip_block`.
+    fn build_wake_check(
+        &self,
+        ctx: &mut BuilderContext,
+        source_socket_pointers: PointerValue,
+        index: IntValue,
+        run_block: &BasicBlock,
+        skip_block: &BasicBlock,
+    ) {
+        let wake_check_block = ctx.context.append_basic_block(&ctx.func, "voice.wakecheck");
+        let wake_block = ctx.context.append_basic_block(&ctx.func, "voice.wake");
+
+        let sleeping = ctx
+            .b
+            .build_load(&self.sleeping_ptr, "sleeping")
+            .into_int_value();
+        let is_sleeping = util::get_bit(ctx.b, sleeping, index);
+        ctx.b
+            .build_conditional_branch(&is_sleeping, &wake_check_block, run_block);
+
+        ctx.b.position_at_end(&wake_check_block);
+        let has_events = self.midi_sources.iter().fold(
+            ctx.context.bool_type().const_int(0, false),
+            |acc, &source_index| {
+                let source_midi =
+                    self.get_source_midi(ctx, source_socket_pointers, source_index, index);
+                let event_count = source_midi.get_count(ctx.b);
+                let source_has_events = ctx.b.build_int_compare(
+                    IntPredicate::NE,
+                    event_count,
+                    event_count.get_type().const_int(0, false),
+                    "",
+                );
+                ctx.b.build_or(acc, source_has_events, "hasevents")
+            },
+        );
+        ctx.b
+            .build_conditional_branch(&has_events, &wake_block, skip_block);
+
+        ctx.b.position_at_end(&wake_block);
+        let sleeping = ctx
+            .b
+            .build_load(&self.sleeping_ptr, "sleeping")
+            .into_int_value();
+        let new_sleeping = util::clear_bit(ctx.b, sleeping, index);
+        ctx.b.build_store(&self.sleeping_ptr, &new_sleeping);
+        let silent_count_ptr = self.get_silent_count_ptr(ctx, index);
+        ctx.b.build_store(
+            &silent_count_ptr,
+            &ctx.context.i32_type().const_int(0, false),
+        );
+        ctx.b.build_unconditional_branch(run_block);
+    }
+
+    // Updates the silence counter of a voice that has just run, and puts it to sleep if it's been
+    // silent for long enough since its last note was released. Notes that are still held keep
+    // the voice awake even if it's silent (e.g a long delay, or a sample that starts quietly).
+    // Branches to `continue_block` afterwards.
+    fn build_silence_check(
+        &self,
+        ctx: &mut BuilderContext,
+        cache: &ObjectCache,
+        surface: SurfaceRef,
+        node: &Node,
+        groups: &[ValueGroup],
+        dest_sockets: &[usize],
+        source_socket_pointers: PointerValue,
+        dest_socket_pointers: PointerValue,
+        voice_pointers_ptr: PointerValue,
+        index: IntValue,
+        continue_block: &BasicBlock,
+    ) {
+        let held_count = self.build_held_count_update(ctx, source_socket_pointers, index);
+
+        let fabs_intrinsic = intrinsics::fabs_v2f32(ctx.module);
+        let max_vec_intrinsic = intrinsics::maxnum_v2f32(ctx.module);
+        let max_intrinsic = intrinsics::maxnum_f32(ctx.module);
+
+        let get_dest_item_ptr = |ctx: &mut BuilderContext, dest_index: usize| {
+            let dest_array = values::ArrayValue::new(
+                ctx.b
+                    .build_load(
+                        &unsafe {
+                            ctx.b
+                                .build_struct_gep(&dest_socket_pointers, dest_index as u32, "")
+                        },
+                        "",
+                    ).into_pointer_value(),
+            );
+            dest_array.get_item_ptr(ctx.b, index)
+        };
+
+        // find the peak level across all of the voice's audio outputs
+        let mut peak_vec = util::get_vec_spread(ctx.context, 0.);
+        for &dest_index in &self.num_dests {
+            let dest_num = values::NumValue::new(get_dest_item_ptr(ctx, dest_index));
+            let dest_vec = dest_num.get_vec(ctx.b);
+            let abs_vec = ctx
+                .b
+                .build_call(&fabs_intrinsic, &[&dest_vec], "", false)
+                .left()
+                .unwrap()
+                .into_vector_value();
+            peak_vec = ctx
+                .b
+                .build_call(&max_vec_intrinsic, &[&peak_vec, &abs_vec], "", false)
+                .left()
+                .unwrap()
+                .into_vector_value();
+        }
+        let peak_left = ctx
+            .b
+            .build_extract_element(&peak_vec, &ctx.context.i32_type().const_int(0, false), "")
+            .into_float_value();
+        let peak_right = ctx
+            .b
+            .build_extract_element(&peak_vec, &ctx.context.i32_type().const_int(1, false), "")
+            .into_float_value();
+        let peak = ctx
+            .b
+            .build_call(&max_intrinsic, &[&peak_left, &peak_right], "peak", false)
+            .left()
+            .unwrap()
+            .into_float_value();
+        let is_silent = ctx.b.build_float_compare(
+            FloatPredicate::OLT,
+            peak,
+            ctx.context.f32_type().const_float(VOICE_SLEEP_THRESHOLD),
+            "silent",
+        );
+        let is_released = ctx.b.build_int_compare(
+            IntPredicate::EQ,
+            held_count,
+            ctx.context.i8_type().const_int(0, false),
+            "released",
+        );
+        let is_silent = ctx.b.build_and(is_silent, is_released, "silentreleased");
+
+        // count up while the voice is silent and released, reset as soon as it isn't
+        let silent_count_ptr = self.get_silent_count_ptr(ctx, index);
+        let silent_count = ctx
+            .b
+            .build_load(&silent_count_ptr, "silentcount")
+            .into_int_value();
+        let incremented_count =
+            ctx.b
+                .build_int_add(silent_count, ctx.context.i32_type().const_int(1, false), "");
+        let new_silent_count = ctx.b.build_int_mul(
+            incremented_count,
+            ctx.b
+                .build_int_z_extend(is_silent, ctx.context.i32_type(), ""),
+            "silentcount",
+        );
+        ctx.b.build_store(&silent_count_ptr, &new_silent_count);
+
+        let sleep_block = ctx.context.append_basic_block(&ctx.func, "voice.sleep");
+        let should_sleep = ctx.b.build_int_compare(
+            IntPredicate::UGE,
+            new_silent_count,
+            self.hold_samples,
+            "shouldsleep",
+        );
+        ctx.b
+            .build_conditional_branch(&should_sleep, &sleep_block, continue_block);
+
+        // Put the voice to sleep, resetting it to the state it would be in if it was just
+        // created. Outputs are cleared too, so nothing reading them (e.g the active input of
+        // `voices`) holds on to the last values.
+        ctx.b.position_at_end(&sleep_block);
+        let sleeping = ctx
+            .b
+            .build_load(&self.sleeping_ptr, "sleeping")
+            .into_int_value();
+        let new_sleeping = util::set_bit(ctx.b, sleeping, index);
+        ctx.b.build_store(&self.sleeping_ptr, &new_sleeping);
+
+        build_lifecycle_call(
+            ctx.module,
+            cache,
+            ctx.b,
+            surface,
+            LifecycleFunc::Destruct,
+            voice_pointers_ptr,
+        );
+        let voice_scratch_ptr = unsafe {
+            ctx.b.build_in_bounds_gep(
+                &self.voices_scratch_ptr,
+                &[ctx.context.i32_type().const_int(0, false), index],
+                "voicescratch.ptr",
+            )
+        };
+        let voice_scratch_type = cache.surface_layout(surface).unwrap().scratch_struct;
+        ctx.b
+            .build_store(&voice_scratch_ptr, &voice_scratch_type.const_null());
+        build_lifecycle_call(
+            ctx.module,
+            cache,
+            ctx.b,
+            surface,
+            LifecycleFunc::Construct,
+            voice_pointers_ptr,
+        );
+
+        for (dest_index, &dest_socket) in dest_sockets.iter().enumerate() {
+            let item_type =
+                values::remap_type(ctx.context, get_array_item_type(node, groups, dest_socket));
+            let dest_item_ptr = get_dest_item_ptr(ctx, dest_index);
+            ctx.b.build_store(&dest_item_ptr, &item_type.const_null());
+        }
+
+        ctx.b.build_unconditional_branch(continue_block);
+    }
+
+    fn build_awake_bitmap(&self, ctx: &mut BuilderContext, active_bitmap: IntValue) -> IntValue {
+        let sleeping = ctx
+            .b
+            .build_load(&self.sleeping_ptr, "sleeping")
+            .into_int_value();
+        ctx.b
+            .build_and(active_bitmap, ctx.b.build_not(&sleeping, ""), "awakebitmap")
+    }
+}
+
+/// Returns the constant values of a custom node's controls that read from fixed groups, which its
+/// update function can be specialized on.
+pub fn get_fixed_values(node: &Node, groups: &[ValueGroup]) -> Vec<(usize, ConstantValue)> {
+    node.sockets
+        .iter()
+        .enumerate()
+        .filter(|(_, socket)| socket.value_read)
+        .filter_map(|(control, socket)| match groups[socket.group_id].source {
+            ValueGroupSource::Fixed(ref value) => Some((control, value.clone())),
+            _ => None,
+        }).collect()
+}
+
 fn build_node_call(
     ctx: &mut BuilderContext,
     cache: &ObjectCache,
     node: &Node,
+    groups: &[ValueGroup],
     lifecycle: LifecycleFunc,
     pointers_ptr: PointerValue,
 ) {
     match &node.data {
         NodeData::Dummy => {}
         NodeData::Custom(block_id) => {
-            block::build_lifecycle_call(
-                ctx.module,
-                cache,
-                ctx.b,
-                *block_id,
-                lifecycle,
-                pointers_ptr,
-            );
+            let fixed_values = get_fixed_values(node, groups);
+            if lifecycle == LifecycleFunc::Update && !fixed_values.is_empty() {
+                block::build_specialized_update_call(
+                    ctx.module,
+                    cache,
+                    ctx.b,
+                    *block_id,
+                    &fixed_values,
+                    pointers_ptr,
+                );
+            } else {
+                block::build_lifecycle_call(
+                    ctx.module,
+                    cache,
+                    ctx.b,
+                    *block_id,
+                    lifecycle,
+                    pointers_ptr,
+                );
+            }
         }
         NodeData::Group(surface_id) => {
             build_lifecycle_call(
@@ -111,6 +653,28 @@ fn build_node_call(
                 None
             };
 
+            // Voices can only be put to sleep if something will wake them up again: MIDI being
+            // sent to them, or being newly activated by the source (e.g when `voices` assigns a
+            // note). We also need an audio output to detect silence on.
+            let midi_sources: Vec<_> = source_sockets
+                .iter()
+                .enumerate()
+                .filter(|&(_, socket)| *get_array_item_type(node, groups, *socket) == VarType::Midi)
+                .map(|(index, _)| index)
+                .collect();
+            let num_dests: Vec<_> = dest_sockets
+                .iter()
+                .enumerate()
+                .filter(|&(_, socket)| *get_array_item_type(node, groups, *socket) == VarType::Num)
+                .map(|(index, _)| index)
+                .collect();
+            let sleep = match valid_bitmap {
+                Some(active_bitmap) if !midi_sources.is_empty() && !num_dests.is_empty() => Some(
+                    VoiceSleep::new(ctx, pointers_ptr, active_bitmap, midi_sources, num_dests),
+                ),
+                _ => None,
+            };
+
             // build a for loop to iterate over each instance
             let index_ptr = ctx
                 .allocb
@@ -158,8 +722,24 @@ fn build_node_call(
             if let Some(active_bitmap) = valid_bitmap {
                 // check if this iteration is active according to the bitmap
                 let active_bit = util::get_bit(ctx.b, active_bitmap, index_32);
-                ctx.b
-                    .build_conditional_branch(&active_bit, &run_block, &check_block);
+                if let Some(ref sleep) = sleep {
+                    let sleep_check_block = ctx
+                        .context
+                        .append_basic_block(&ctx.func, "voice.sleepcheck");
+                    ctx.b
+                        .build_conditional_branch(&active_bit, &sleep_check_block, &check_block);
+                    ctx.b.position_at_end(&sleep_check_block);
+                    sleep.build_wake_check(
+                        ctx,
+                        source_socket_pointers,
+                        index_32,
+                        &run_block,
+                        &check_block,
+                    );
+                } else {
+                    ctx.b
+                        .build_conditional_branch(&active_bit, &run_block, &check_block);
+                }
             } else {
                 ctx.b.build_unconditional_branch(&run_block);
             }
@@ -181,7 +761,23 @@ fn build_node_call(
                 voice_pointers_ptr,
             );
 
-            ctx.b.build_unconditional_branch(&check_block);
+            if let Some(ref sleep) = sleep {
+                sleep.build_silence_check(
+                    ctx,
+                    cache,
+                    *surface_id,
+                    node,
+                    groups,
+                    dest_sockets,
+                    source_socket_pointers,
+                    dest_socket_pointers,
+                    voice_pointers_ptr,
+                    index_32,
+                    &check_block,
+                );
+            } else {
+                ctx.b.build_unconditional_branch(&check_block);
+            }
             ctx.b.position_at_end(&end_block);
 
             // set the bitmaps of all output arrays to be this input
@@ -193,6 +789,20 @@ fn build_node_call(
                         .build_not(&ctx.context.i32_type().const_int(0, false), "")
                 };
 
+                // sleeping voices aren't active as far as anything outside is concerned
+                let active_bitmap = if let Some(ref sleep) = sleep {
+                    let awake_bitmap = sleep.build_awake_bitmap(ctx, active_bitmap);
+                    ctx.b.build_store(
+                        &ctx.b
+                            .build_load(&bitmap_pointer, "bitmap.ptr")
+                            .into_pointer_value(),
+                        &awake_bitmap,
+                    );
+                    awake_bitmap
+                } else {
+                    active_bitmap
+                };
+
                 for dest_socket_index in 0..dest_sockets.len() {
                     let dest_array = values::ArrayValue::new(
                         ctx.b
@@ -214,27 +824,164 @@ fn build_node_call(
     }
 }
 
-pub fn build_lifecycle_func(
-    module: &Module,
+fn build_node_calls(
+    ctx: &mut BuilderContext,
     cache: &ObjectCache,
     surface: &Surface,
+    nodes: &[usize],
     lifecycle: LifecycleFunc,
+    pointers_ptr: PointerValue,
 ) {
-    let func = get_lifecycle_func(module, cache, surface.id.id, lifecycle);
+    let layout = cache.surface_layout(surface.id.id).unwrap();
+    for &node_index in nodes {
+        let layout_ptr_index = layout.node_ptr_index(node_index);
+        let node_pointers_ptr = unsafe {
+            ctx.b
+                .build_struct_gep(&pointers_ptr, layout_ptr_index as u32, "")
+        };
+
+        build_node_call(
+            ctx,
+            cache,
+            &surface.nodes[node_index],
+            &surface.groups,
+            lifecycle,
+            node_pointers_ptr,
+        );
+    }
+}
+
+// Builds a function that runs the nodes in one task of the parallel stages, given the index of the
+// task. Tasks are numbered in order across all stages that have more than one task.
+fn build_task_dispatcher_func(
+    module: &Module,
+    cache: &ObjectCache,
+    surface: &Surface,
+    stages: &[Stage],
+) {
+    let func = get_task_dispatcher_func(module, surface.id.id);
     build_context_function(module, func, cache.target(), &|mut ctx: BuilderContext| {
         let layout = cache.surface_layout(surface.id.id).unwrap();
+        let context_ptr = ctx.func.get_nth_param(0).unwrap().into_pointer_value();
+        let task_index = ctx.func.get_nth_param(1).unwrap().into_int_value();
+        let pointers_ptr = ctx.b.build_pointer_cast(
+            context_ptr,
+            layout.pointer_struct.ptr_type(AddressSpace::Generic),
+            "pointers",
+        );
+
+        let tasks: Vec<_> = stages
+            .iter()
+            .filter(|stage| stage.len() > 1)
+            .flat_map(|stage| stage.iter())
+            .collect();
+        let end_block = ctx.context.append_basic_block(&ctx.func, "end");
+        let task_cases: Vec<_> = (0..tasks.len())
+            .map(|index| {
+                (
+                    ctx.context.i32_type().const_int(index as u64, false),
+                    ctx.context
+                        .append_basic_block(&ctx.func, &format!("task.{}", index)),
+                )
+            }).collect();
+        let switch_refs: Vec<_> = task_cases.iter().map(|&(ref a, ref b)| (a, b)).collect();
+        ctx.b.build_switch(&task_index, &end_block, &switch_refs);
+
+        for (task, (_, task_block)) in tasks.into_iter().zip(task_cases.iter()) {
+            ctx.b.position_at_end(task_block);
+            build_node_calls(
+                &mut ctx,
+                cache,
+                surface,
+                task,
+                LifecycleFunc::Update,
+                pointers_ptr,
+            );
+            ctx.b.build_unconditional_branch(&end_block);
+        }
+
+        ctx.b.position_at_end(&end_block);
+        ctx.b.build_return(None);
+    })
+}
+
+// Stages with a single task are run inline, others are handed to the runtime's worker pool which
+// calls back into the task dispatcher.
+fn build_parallel_update_func(
+    module: &Module,
+    cache: &ObjectCache,
+    surface: &Surface,
+    stages: &[Stage],
+) {
+    build_task_dispatcher_func(module, cache, surface, stages);
+
+    let func = get_lifecycle_func(module, cache, surface.id.id, LifecycleFunc::Update);
+    build_context_function(module, func, cache.target(), &|mut ctx: BuilderContext| {
         let pointers_ptr = ctx.func.get_nth_param(0).unwrap().into_pointer_value();
+        let run_tasks_func = get_run_tasks_func(ctx.module);
 
-        for (node_index, node) in surface.nodes.iter().enumerate() {
-            let layout_ptr_index = layout.node_ptr_index(node_index);
-            let node_pointers_ptr = unsafe {
-                ctx.b
-                    .build_struct_gep(&pointers_ptr, layout_ptr_index as u32, "")
-            };
+        let mut first_task = 0;
+        for stage in stages {
+            if stage.len() == 1 {
+                build_node_calls(
+                    &mut ctx,
+                    cache,
+                    surface,
+                    &stage[0],
+                    LifecycleFunc::Update,
+                    pointers_ptr,
+                );
+                continue;
+            }
+
+            let worker_pool = ctx.b.build_load(
+                &globals::get_worker_pool(ctx.module).as_pointer_value(),
+                "workerpool",
+            );
+            let context_ptr = ctx.b.build_pointer_cast(
+                pointers_ptr,
+                ctx.context.i8_type().ptr_type(AddressSpace::Generic),
+                "context",
+            );
+            ctx.b.build_call(
+                &run_tasks_func,
+                &[
+                    &worker_pool,
+                    &ctx.context.i64_type().const_int(surface.id.id, false),
+                    &ctx.context.i32_type().const_int(first_task as u64, false),
+                    &ctx.context.i32_type().const_int(stage.len() as u64, false),
+                    &context_ptr,
+                ],
+                "",
+                false,
+            );
+            first_task += stage.len();
+        }
+
+        ctx.b.build_return(None);
+    })
+}
 
-            build_node_call(&mut ctx, cache, node, lifecycle, node_pointers_ptr);
+pub fn build_lifecycle_func(
+    module: &Module,
+    cache: &ObjectCache,
+    surface: &Surface,
+    lifecycle: LifecycleFunc,
+) {
+    let parallel_tasks = cache.target().parallel_tasks;
+    if lifecycle == LifecycleFunc::Update && parallel_tasks > 1 {
+        let stages = schedule::build_schedule(surface, parallel_tasks);
+        if stages.iter().any(|stage| stage.len() > 1) {
+            build_parallel_update_func(module, cache, surface, &stages);
+            return;
         }
+    }
 
+    let func = get_lifecycle_func(module, cache, surface.id.id, lifecycle);
+    build_context_function(module, func, cache.target(), &|mut ctx: BuilderContext| {
+        let pointers_ptr = ctx.func.get_nth_param(0).unwrap().into_pointer_value();
+        let nodes: Vec<_> = (0..surface.nodes.len()).collect();
+        build_node_calls(&mut ctx, cache, surface, &nodes, lifecycle, pointers_ptr);
         ctx.b.build_return(None);
     })
 }
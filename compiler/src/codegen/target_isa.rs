@@ -0,0 +1,66 @@
+use inkwell::targets::TargetMachine;
+use std::env;
+use std::ffi::CString;
+use std::fmt;
+use std::os::raw::c_char;
+use std::ptr;
+
+extern "C" {
+    fn LLVMAxiomSetTargetCpu(cpu: *const c_char);
+}
+
+/// The instruction set that generated code is allowed to use.
+///
+/// By default code is generated for the host CPU, using every extension it supports. Pinning a
+/// fixed level instead makes output independent of the machine it's generated on, e.g for
+/// reproducible renders or for objects that are run elsewhere. Levels only apply on x86, other
+/// architectures always target the host.
+#[repr(u8)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TargetIsa {
+    Host,
+    Baseline,
+    Avx2,
+    Avx512,
+}
+
+impl TargetIsa {
+    /// Reads the level from the `AXIOM_TARGET_ISA` environment variable (one of `host`,
+    /// `baseline`, `avx2` or `avx512`), defaulting to the host.
+    pub fn from_env() -> TargetIsa {
+        match env::var("AXIOM_TARGET_ISA") {
+            Ok(ref name) if name == "baseline" => TargetIsa::Baseline,
+            Ok(ref name) if name == "avx2" => TargetIsa::Avx2,
+            Ok(ref name) if name == "avx512" => TargetIsa::Avx512,
+            _ => TargetIsa::Host,
+        }
+    }
+
+    fn cpu_name(&self) -> Option<&'static str> {
+        match self {
+            TargetIsa::Host => None,
+            TargetIsa::Baseline => Some("x86-64"),
+            TargetIsa::Avx2 => Some("haswell"),
+            TargetIsa::Avx512 => Some("skylake-avx512"),
+        }
+    }
+
+    pub fn select_machine(&self) -> TargetMachine {
+        let cpu_name = self.cpu_name().map(|name| CString::new(name).unwrap());
+        unsafe {
+            LLVMAxiomSetTargetCpu(cpu_name.as_ref().map_or(ptr::null(), |name| name.as_ptr()));
+        }
+        TargetMachine::select()
+    }
+}
+
+impl fmt::Display for TargetIsa {
+    fn fmt(&self, f: &mut fmt::Formatter) -> Result<(), fmt::Error> {
+        match self {
+            TargetIsa::Host => write!(f, "host"),
+            TargetIsa::Baseline => write!(f, "baseline"),
+            TargetIsa::Avx2 => write!(f, "avx2"),
+            TargetIsa::Avx512 => write!(f, "avx512"),
+        }
+    }
+}
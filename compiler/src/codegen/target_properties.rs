@@ -1,18 +1,26 @@
+use super::TargetIsa;
 use inkwell::targets::TargetMachine;
 
 #[derive(Debug)]
 pub struct TargetProperties {
     pub include_ui: bool,
     pub min_size: bool,
+    pub isa: TargetIsa,
     pub machine: TargetMachine,
+
+    /// The number of threads surface update functions can spread their nodes across. When this is
+    /// 1, surfaces are always updated serially.
+    pub parallel_tasks: usize,
 }
 
 impl TargetProperties {
-    pub fn new(include_ui: bool, min_size: bool, machine: TargetMachine) -> Self {
+    pub fn new(include_ui: bool, min_size: bool, isa: TargetIsa) -> Self {
         TargetProperties {
             include_ui,
             min_size,
-            machine,
+            isa,
+            machine: isa.select_machine(),
+            parallel_tasks: 1,
         }
     }
 }
@@ -102,6 +102,31 @@ pub fn get_or_create_global(module: &Module, name: &str, val_type: &BasicType) -
     }
 }
 
+/// Makes every function and global defined in the module private other than the exported
+/// functions, so the module doesn't leak `maxim.*` symbols and the optimizer is free to inline or
+/// discard them.
+pub fn internalize_module(module: &Module, exported_funcs: &[&str]) {
+    let mut next_func = module.get_first_function();
+    while let Some(func) = next_func {
+        next_func = func.get_next_function();
+
+        let is_defined = func.count_basic_blocks() > 0;
+        let name = func.get_name().to_string_lossy();
+        if is_defined && !exported_funcs.iter().any(|&exported| exported == name) {
+            func.set_linkage(Linkage::PrivateLinkage);
+        }
+    }
+
+    let mut next_global = module.get_first_global();
+    while let Some(global) = next_global {
+        next_global = global.get_next_global();
+
+        if !global.is_declaration() {
+            global.set_linkage(Linkage::PrivateLinkage);
+        }
+    }
+}
+
 pub fn get_const_vec(context: &Context, left: f32, right: f32) -> VectorValue {
     VectorType::const_vector(&[
         &context.f32_type().const_float(left as f64),
@@ -136,6 +161,16 @@ pub fn copy_ptr(builder: &mut Builder, module: &Module, src: PointerValue, dest:
     assert_eq!(src_elem_type, dest_elem_type);
 
     let param_size = get_size_of(&src_elem_type).unwrap();
+    copy_bytes(builder, module, src, dest, param_size);
+}
+
+pub fn copy_bytes(
+    builder: &mut Builder,
+    module: &Module,
+    src: PointerValue,
+    dest: PointerValue,
+    byte_count: IntValue,
+) {
     let context = module.get_context();
 
     // cast src and dest to the correct pointer types
@@ -148,7 +183,7 @@ pub fn copy_ptr(builder: &mut Builder, module: &Module, src: PointerValue, dest:
         &[
             &dest_p0i8,
             &src_p0i8,
-            &param_size,
+            &byte_count,
             &context.i32_type().const_int(0, false),
             &context.bool_type().const_int(0, false),
         ],
@@ -9,6 +9,7 @@ use inkwell::AddressSpace;
 use inkwell::IntPredicate;
 use std::borrow::Borrow;
 
+// Must match `AxiomModel::MidiValue::MAX_EVENTS` in the editor and `AxiomMidi` in the replayer.
 pub const MIDI_EVENT_COUNT: u8 = 16;
 
 #[derive(Debug, Clone)]
@@ -37,8 +38,20 @@ impl MidiValue {
         MidiValue::new(alloca_builder.build_alloca(&midi_type, "midi"))
     }
 
+    // Only the events that are in use are copied, so copying an empty value is just a load and
+    // store of the count instead of the whole event buffer.
     pub fn copy_to(&self, builder: &mut Builder, module: &Module, other: &MidiValue) {
-        util::copy_ptr(builder, module, self.val, other.val)
+        let context = module.get_context();
+        let count = self.get_count(builder);
+        other.set_count(builder, &count);
+
+        let event_size = MidiEventValue::get_type(&context).size_of().unwrap();
+        let wide_count =
+            builder.build_int_z_extend(count, event_size.get_type(), "midi.count.wide");
+        let copy_size = builder.build_int_mul(event_size, wide_count, "midi.copysize");
+        let src_events = self.get_events_ptr(builder);
+        let dest_events = other.get_events_ptr(builder);
+        util::copy_bytes(builder, module, src_events, dest_events, copy_size);
     }
 
     pub fn get_count_ptr(&self, builder: &mut Builder) -> PointerValue {
@@ -7,9 +7,9 @@ use std::fmt;
 pub enum CompileError {
     MismatchedToken {
         expected: TokenType,
-        found: Token,
+        found: Token<'static>,
     },
-    UnexpectedToken(Token),
+    UnexpectedToken(Token<'static>),
     UnexpectedEnd,
     UnknownForm(String, SourceRange),
     UnknownNote(String, SourceRange),
@@ -36,11 +36,14 @@ pub type CompileResult<T> = Result<T, CompileError>;
 
 impl CompileError {
     pub fn mismatched_token(expected: TokenType, found: Token) -> CompileError {
-        CompileError::MismatchedToken { expected, found }
+        CompileError::MismatchedToken {
+            expected,
+            found: found.detach(),
+        }
     }
 
     pub fn unexpected_token(found: Token) -> CompileError {
-        CompileError::UnexpectedToken(found)
+        CompileError::UnexpectedToken(found.detach())
     }
 
     pub fn unknown_form(form: String, range: SourceRange) -> CompileError {
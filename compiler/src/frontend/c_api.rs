@@ -1,4 +1,8 @@
-use super::{value_reader, Runtime, Transaction};
+use super::{
+    value_reader, CommitMetrics, ConvolveHistories, ConvolveHistory, ExportConfig, ExportPortal,
+    Exporter, FrozenUpdate, ImpulseResponse, Runtime, Sample, SamplerVoice, Transaction,
+    WorkerPool,
+};
 use ast;
 use codegen;
 use inkwell::{orc, targets};
@@ -23,8 +27,9 @@ pub unsafe extern "C" fn maxim_destroy_string(string: *mut std::os::raw::c_char)
 
 #[no_mangle]
 pub unsafe extern "C" fn maxim_create_runtime(include_ui: bool, min_size: bool) -> *mut Runtime {
-    let target =
-        codegen::TargetProperties::new(include_ui, min_size, targets::TargetMachine::select());
+    let isa = codegen::TargetIsa::from_env();
+    println!("Generating code for {} instruction set", isa);
+    let target = codegen::TargetProperties::new(include_ui, min_size, isa);
     Box::into_raw(Box::new(Runtime::new(target)))
 }
 
@@ -66,11 +71,197 @@ pub unsafe extern "C" fn maxim_get_sample_rate(runtime: *const Runtime) -> f32 {
 }
 
 #[no_mangle]
-pub unsafe extern "C" fn maxim_commit(runtime: *mut Runtime, transaction: *mut Transaction) {
+pub unsafe extern "C" fn maxim_set_parallel_tasks(runtime: *mut Runtime, parallel_tasks: u32) {
+    (*runtime).set_parallel_tasks(parallel_tasks as usize);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_get_parallel_tasks(runtime: *const Runtime) -> u32 {
+    (*runtime).get_parallel_tasks() as u32
+}
+
+// Returns null and sets the error if the file can't be loaded.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_create_impulse_response(
+    c_path: *const std::os::raw::c_char,
+    sample_rate: f32,
+    fail_error_out: *mut *mut std::os::raw::c_char,
+) -> *mut ImpulseResponse {
+    let path = std::ffi::CStr::from_ptr(c_path).to_str().unwrap();
+    match ImpulseResponse::open(std::path::Path::new(path), sample_rate) {
+        Ok(response) => Box::into_raw(Box::new(response)),
+        Err(err) => {
+            *fail_error_out = std::ffi::CString::new(err).unwrap().into_raw();
+            std::ptr::null_mut()
+        }
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_destroy_impulse_response(response: *mut ImpulseResponse) {
+    Box::from_raw(response);
+    // box will be dropped here
+}
+
+// Takes ownership of the impulse response, passing null empties the slot.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_set_impulse_response(
+    runtime: *mut Runtime,
+    slot: usize,
+    response: *mut ImpulseResponse,
+) {
+    let owned_response = if response.is_null() {
+        None
+    } else {
+        Some(Box::from_raw(response))
+    };
+    (*runtime).set_impulse_response(slot, owned_response);
+}
+
+#[no_mangle]
+pub extern "C" fn maxim_get_impulse_response_slot_count() -> usize {
+    codegen::globals::IMPULSE_RESPONSE_SLOTS
+}
+
+// Returns null and sets the error if the file can't be loaded.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_create_sample(
+    c_path: *const std::os::raw::c_char,
+    fail_error_out: *mut *mut std::os::raw::c_char,
+) -> *mut Sample {
+    let path = std::ffi::CStr::from_ptr(c_path).to_str().unwrap();
+    match Sample::open(std::path::Path::new(path)) {
+        Ok(sample) => Box::into_raw(Box::new(sample)),
+        Err(err) => {
+            *fail_error_out = std::ffi::CString::new(err).unwrap().into_raw();
+            std::ptr::null_mut()
+        }
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_destroy_sample(sample: *mut Sample) {
+    Box::from_raw(sample);
+    // box will be dropped here
+}
+
+// Takes ownership of the sample, passing null empties the slot.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_set_sample(runtime: *mut Runtime, slot: usize, sample: *mut Sample) {
+    let owned_sample = if sample.is_null() {
+        None
+    } else {
+        Some(Box::from_raw(sample))
+    };
+    (*runtime).set_sample(slot, owned_sample);
+}
+
+#[no_mangle]
+pub extern "C" fn maxim_get_sample_slot_count() -> usize {
+    codegen::globals::SAMPLE_SLOTS
+}
+
+// Called from JIT code when a `convolve` node is constructed, registered with the JIT as a builtin.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_convolve_construct(
+    histories: *mut ConvolveHistories,
+    history: *mut ConvolveHistory,
+) {
+    ConvolveHistories::construct(histories, history);
+}
+
+// Called from JIT code to play a voice of a `sampler` node, registered with the JIT as a builtin.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_sampler_read(
+    samples: *const *const Sample,
+    voice: *mut SamplerVoice,
+    gate: f32,
+    slot: f32,
+    sample_rate: f32,
+) {
+    (*voice).read(samples, gate, slot, sample_rate);
+}
+
+// Called from JIT code when a `sampler` node is destroyed, registered with the JIT as a builtin.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_sampler_release(
+    samples: *const *const Sample,
+    voice: *mut SamplerVoice,
+) {
+    (*voice).release(samples);
+}
+
+// Called from JIT code to run a parallel stage of a surface update, registered with the JIT as a
+// builtin.
+#[no_mangle]
+pub unsafe extern "C" fn maxim_run_parallel_tasks(
+    worker_pool: *const WorkerPool,
+    surface: u64,
+    first_task: u32,
+    task_count: u32,
+    context: *mut c_void,
+) {
+    (*worker_pool).run_tasks(surface, first_task, task_count, context);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_commit(
+    runtime: *mut Runtime,
+    transaction: *mut Transaction,
+) -> CommitMetrics {
     let owned_transaction = Box::from_raw(transaction);
     (*runtime).commit(*owned_transaction)
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn maxim_commit_will_rebuild(
+    runtime: *const Runtime,
+    transaction: *const Transaction,
+) -> bool {
+    (*runtime).will_rebuild(&*transaction)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_build_frozen(runtime: *const Runtime) -> *mut FrozenUpdate {
+    match (*runtime).build_frozen() {
+        Some(frozen) => Box::into_raw(Box::new(frozen)),
+        None => std::ptr::null_mut(),
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_apply_frozen(runtime: *mut Runtime, frozen: *mut FrozenUpdate) {
+    let owned_frozen = Box::from_raw(frozen);
+    (*runtime).apply_frozen(*owned_frozen);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_is_frozen(runtime: *const Runtime) -> bool {
+    (*runtime).is_frozen()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn maxim_export(
+    runtime: *const Runtime,
+    config: *const ExportConfig,
+    portals: *const ExportPortal,
+    portal_count: usize,
+    c_path: *const std::os::raw::c_char,
+    fail_error_out: *mut *mut std::os::raw::c_char,
+) -> bool {
+    let path = std::ffi::CStr::from_ptr(c_path).to_str().unwrap();
+    let portals = std::slice::from_raw_parts(portals, portal_count);
+
+    let exporter = Exporter::new(&*runtime, &*config);
+    match exporter.export_object(&*config, portals, std::path::Path::new(path)) {
+        Ok(()) => true,
+        Err(err) => {
+            *fail_error_out = std::ffi::CString::new(err).unwrap().into_raw();
+            false
+        }
+    }
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn maxim_is_node_extracted(
     runtime: *const Runtime,
@@ -264,6 +455,14 @@ pub unsafe extern "C" fn maxim_valuegroupsource_default(
     Box::into_raw(Box::new(mir::ValueGroupSource::Default(*const_val)))
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn maxim_valuegroupsource_fixed(
+    value: *mut mir::ConstantValue,
+) -> *mut mir::ValueGroupSource {
+    let const_val = Box::from_raw(value);
+    Box::into_raw(Box::new(mir::ValueGroupSource::Fixed(*const_val)))
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn maxim_valuegroupsource_clone(
     base: *const mir::ValueGroupSource,
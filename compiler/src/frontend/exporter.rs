@@ -0,0 +1,558 @@
+use super::Runtime;
+use codegen::{
+    block, build_context_function, controls, converters, data_analyzer, functions, globals,
+    intrinsics, root, surface, util, values, BuilderContext, ObjectCache, Optimizer, TargetIsa,
+    TargetProperties,
+};
+use inkwell::builder::Builder;
+use inkwell::context::Context;
+use inkwell::module::{Linkage, Module};
+use inkwell::targets::FileType;
+use inkwell::types::{BasicType, StructType};
+use inkwell::values::{IntValue, PointerValue};
+use inkwell::{AddressSpace, IntPredicate};
+use mir::{Block, BlockRef, Surface, SurfaceRef, VarType};
+use std::collections::HashMap;
+use std::path::Path;
+
+const INITIALIZED_GLOBAL_NAME: &str = "maxim.export.initialized";
+const SCRATCH_GLOBAL_NAME: &str = "maxim.export.scratch";
+const SOCKETS_GLOBAL_NAME: &str = "maxim.export.sockets";
+const PORTALS_GLOBAL_NAME: &str = "maxim.export.portals";
+const POINTERS_GLOBAL_NAME: &str = "maxim.export.pointers";
+
+pub const INIT_FUNC_NAME: &str = "axiom_init";
+pub const GENERATE_FUNC_NAME: &str = "axiom_generate";
+pub const PACKUP_FUNC_NAME: &str = "axiom_packup";
+pub const GENERATE_BLOCK_FUNC_NAME: &str = "axiom_generate_block";
+pub const GET_PORTAL_FUNC_NAME: &str = "axiom_get_portal";
+pub const MIDI_PUSH_FUNC_NAME: &str = "axiom_midi_push";
+
+// Everything other than the replayer API is made private.
+const EXPORTED_FUNC_NAMES: [&str; 6] = [
+    INIT_FUNC_NAME,
+    GENERATE_FUNC_NAME,
+    PACKUP_FUNC_NAME,
+    GENERATE_BLOCK_FUNC_NAME,
+    GET_PORTAL_FUNC_NAME,
+    MIDI_PUSH_FUNC_NAME,
+];
+
+#[repr(u8)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ExportPortalDirection {
+    Input,
+    Output,
+    Automation,
+}
+
+/// Describes a portal of the exported root, in the order the portals are indexed by
+/// `axiom_get_portal` and `axiom_generate_block`. Several portals can share one socket.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct ExportPortal {
+    pub socket: usize,
+    pub direction: ExportPortalDirection,
+}
+
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct ExportConfig {
+    pub min_size: bool,
+    pub sample_rate: f32,
+    pub bpm: f32,
+    pub isa: TargetIsa,
+}
+
+/// Generates a standalone object from the MIR currently committed to a runtime.
+///
+/// The runtime's modules can't be reused directly since they're built in the runtime's context
+/// and with UI data included, so the exporter rebuilds layouts in its own context from the same
+/// MIR and emits every block, surface and the root into a single module alongside the library.
+pub struct Exporter<'a> {
+    runtime: &'a Runtime,
+    context: Context,
+    target: TargetProperties,
+    surface_layouts: HashMap<SurfaceRef, data_analyzer::SurfaceLayout>,
+    block_layouts: HashMap<BlockRef, data_analyzer::BlockLayout>,
+}
+
+impl<'a> Exporter<'a> {
+    pub fn new(runtime: &'a Runtime, config: &ExportConfig) -> Self {
+        let mut exporter = Exporter {
+            runtime,
+            context: Context::create(),
+            target: TargetProperties::new(false, config.min_size, config.isa),
+            surface_layouts: HashMap::new(),
+            block_layouts: HashMap::new(),
+        };
+        exporter.build_layouts();
+        exporter
+    }
+
+    fn build_layouts(&mut self) {
+        for block in self.runtime.block_mirs() {
+            let layout = data_analyzer::build_block_layout(&self.context, block, &self.target);
+            self.block_layouts.insert(block.id.id, layout);
+        }
+
+        // surfaces are sorted so that any surface comes after the surfaces it contains
+        for surface_id in self.runtime.sorted_surfaces() {
+            let layout = data_analyzer::build_surface_layout(
+                self,
+                self.runtime.surface_mir(surface_id).unwrap(),
+            );
+            self.surface_layouts.insert(surface_id, layout);
+        }
+    }
+
+    pub fn build_module(&self, config: &ExportConfig, portals: &[ExportPortal]) -> Module {
+        let module = self.context.create_module("export");
+        module.set_target(&self.target.machine.get_triple().to_string_lossy());
+        module.set_data_layout(&self.target.machine.get_data().get_data_layout());
+
+        // library functions are only pulled in if something references them, the optimizer will
+        // discard the rest once they're made private
+        controls::build_funcs(&module, &self.target);
+        converters::build_funcs(&module);
+        functions::build_funcs(&module, &self.target);
+        functions::SamplerFunction::build_silent_funcs(&module, &self.target);
+        functions::ConvolveFunction::build_silent_funcs(&module, &self.target);
+        intrinsics::build_intrinsics(&module);
+        globals::build_globals(&module);
+        values::MidiValue::initialize(&module, &self.context);
+        globals::get_sample_rate(&module)
+            .set_initializer(&util::get_vec_spread(&self.context, config.sample_rate));
+        globals::get_bpm(&module).set_initializer(&util::get_vec_spread(&self.context, config.bpm));
+
+        for block in self.runtime.block_mirs() {
+            block::build_funcs(&module, self, block);
+        }
+        for surface_id in self.runtime.sorted_surfaces() {
+            surface::build_funcs(&module, self, self.runtime.surface_mir(surface_id).unwrap());
+        }
+
+        let root = self.runtime.root_mir();
+        let initialized_global =
+            root::build_initialized_global(&module, self, 0, INITIALIZED_GLOBAL_NAME);
+        let scratch_global = root::build_scratch_global(&module, self, 0, SCRATCH_GLOBAL_NAME);
+        let sockets_global =
+            root::build_sockets_global(&module, root, SOCKETS_GLOBAL_NAME, PORTALS_GLOBAL_NAME);
+        let pointers_global = root::build_pointers_global(
+            &module,
+            self,
+            0,
+            POINTERS_GLOBAL_NAME,
+            initialized_global.as_pointer_value(),
+            scratch_global.as_pointer_value(),
+            sockets_global.sockets.as_pointer_value(),
+        );
+        root::build_funcs(
+            &module,
+            self,
+            0,
+            INIT_FUNC_NAME,
+            GENERATE_FUNC_NAME,
+            PACKUP_FUNC_NAME,
+            pointers_global.as_pointer_value(),
+        );
+
+        let socket_ptrs = sockets_global.socket_ptrs.as_pointer_value();
+        build_get_portal_func(&module, &self.target, socket_ptrs, portals);
+        build_generate_block_func(&module, &self.target, &root.sockets, socket_ptrs, portals);
+        build_midi_push_func(&module, &self.target);
+
+        util::internalize_module(&module, &EXPORTED_FUNC_NAMES);
+        Optimizer::new(&self.target).optimize_module(&module);
+        module
+    }
+
+    pub fn export_object(
+        &self,
+        config: &ExportConfig,
+        portals: &[ExportPortal],
+        path: &Path,
+    ) -> Result<(), String> {
+        let module = self.build_module(config, portals);
+        self.target
+            .machine
+            .write_to_file(&module, FileType::Object, path)
+            .map_err(|err| err.to_string())
+    }
+}
+
+impl<'a> ObjectCache for Exporter<'a> {
+    fn context(&self) -> &Context {
+        &self.context
+    }
+
+    fn target(&self) -> &TargetProperties {
+        &self.target
+    }
+
+    fn surface_mir(&self, id: SurfaceRef) -> Option<&Surface> {
+        self.runtime.surface_mir(id)
+    }
+
+    fn surface_layout(&self, id: SurfaceRef) -> Option<&data_analyzer::SurfaceLayout> {
+        self.surface_layouts.get(&id)
+    }
+
+    fn block_mir(&self, id: BlockRef) -> Option<&Block> {
+        self.runtime.block_mir(id)
+    }
+
+    fn block_layout(&self, id: BlockRef) -> Option<&data_analyzer::BlockLayout> {
+        self.block_layouts.get(&id)
+    }
+}
+
+fn build_socket_ptr(
+    builder: &mut Builder,
+    context: &Context,
+    socket_ptrs: PointerValue,
+    root_sockets: &[VarType],
+    socket: usize,
+) -> PointerValue {
+    let socket_ptr = unsafe {
+        builder.build_in_bounds_gep(
+            &socket_ptrs,
+            &[
+                context.i64_type().const_int(0, false),
+                context.i64_type().const_int(socket as u64, false),
+            ],
+            "",
+        )
+    };
+    let socket_type = values::remap_type(context, &root_sockets[socket]);
+    builder.build_pointer_cast(
+        builder
+            .build_load(&socket_ptr, "socket")
+            .into_pointer_value(),
+        socket_type.ptr_type(AddressSpace::Generic),
+        "socket.typed",
+    )
+}
+
+fn build_buffer_ptr(
+    builder: &mut Builder,
+    context: &Context,
+    buffers_ptr: PointerValue,
+    portal_index: usize,
+) -> PointerValue {
+    let buffer_ptr = unsafe {
+        builder.build_in_bounds_gep(
+            &buffers_ptr,
+            &[context.i32_type().const_int(portal_index as u64, false)],
+            "",
+        )
+    };
+    builder
+        .build_load(&buffer_ptr, "buffer")
+        .into_pointer_value()
+}
+
+// Audio buffers are arrays of `AxiomNum` from the exported header, which are 12 bytes instead of
+// the 16 a `NumValue` is padded to, so frames are copied one field at a time.
+fn get_frame_type(context: &Context) -> StructType {
+    context.struct_type(
+        &[&context.f32_type(), &context.f32_type(), &context.i8_type()],
+        false,
+    )
+}
+
+fn build_frame_ptr(
+    builder: &mut Builder,
+    context: &Context,
+    buffer: PointerValue,
+    frame_index: IntValue,
+) -> PointerValue {
+    let typed_buffer = builder.build_pointer_cast(
+        buffer,
+        get_frame_type(context).ptr_type(AddressSpace::Generic),
+        "buffer.typed",
+    );
+    unsafe { builder.build_in_bounds_gep(&typed_buffer, &[frame_index], "buffer.frame") }
+}
+
+fn build_load_frame(
+    builder: &mut Builder,
+    context: &Context,
+    frame: PointerValue,
+    num: &values::NumValue,
+) {
+    let left_ptr = unsafe { builder.build_struct_gep(&frame, 0, "frame.left.ptr") };
+    let right_ptr = unsafe { builder.build_struct_gep(&frame, 1, "frame.right.ptr") };
+    let form_ptr = unsafe { builder.build_struct_gep(&frame, 2, "frame.form.ptr") };
+
+    let left = builder.build_load(&left_ptr, "frame.left").into_float_value();
+    let right = builder.build_load(&right_ptr, "frame.right").into_float_value();
+    let vec = builder
+        .build_insert_element(
+            &builder
+                .build_insert_element(
+                    &context.f32_type().vec_type(2).get_undef(),
+                    &left,
+                    &context.i32_type().const_int(0, false),
+                    "",
+                ).into_vector_value(),
+            &right,
+            &context.i32_type().const_int(1, false),
+            "frame.vec",
+        ).into_vector_value();
+    num.set_vec(builder, &vec);
+
+    let form = builder.build_load(&form_ptr, "frame.form").into_int_value();
+    num.set_form(builder, &form);
+}
+
+fn build_store_frame(
+    builder: &mut Builder,
+    context: &Context,
+    num: &values::NumValue,
+    frame: PointerValue,
+) {
+    let left_ptr = unsafe { builder.build_struct_gep(&frame, 0, "frame.left.ptr") };
+    let right_ptr = unsafe { builder.build_struct_gep(&frame, 1, "frame.right.ptr") };
+    let form_ptr = unsafe { builder.build_struct_gep(&frame, 2, "frame.form.ptr") };
+
+    let vec = num.get_vec(builder);
+    let left =
+        builder.build_extract_element(&vec, &context.i32_type().const_int(0, false), "frame.left");
+    let right =
+        builder.build_extract_element(&vec, &context.i32_type().const_int(1, false), "frame.right");
+    let form = num.get_form(builder);
+    builder.build_store(&left_ptr, &left);
+    builder.build_store(&right_ptr, &right);
+    builder.build_store(&form_ptr, &form);
+}
+
+fn build_get_portal_func(
+    module: &Module,
+    target: &TargetProperties,
+    socket_ptrs: PointerValue,
+    portals: &[ExportPortal],
+) {
+    let context = module.get_context();
+    let void_ptr_type = context.i8_type().ptr_type(AddressSpace::Generic);
+    let func = util::get_or_create_func(module, GET_PORTAL_FUNC_NAME, false, &|| {
+        (
+            Linkage::ExternalLinkage,
+            void_ptr_type.fn_type(&[&context.i32_type()], false),
+        )
+    });
+    build_context_function(module, func, target, &|ctx: BuilderContext| {
+        let portal_index = ctx.func.get_nth_param(0).unwrap().into_int_value();
+        let null_block = ctx.context.append_basic_block(&ctx.func, "portal.null");
+
+        let mut case_builder = ctx.context.create_builder();
+        case_builder.position_at_end(&null_block);
+        case_builder.build_return(Some(&void_ptr_type.const_null()));
+
+        let mut switch_cases = Vec::new();
+        for (index, portal) in portals.iter().enumerate() {
+            let portal_block = ctx
+                .context
+                .append_basic_block(&ctx.func, &format!("portal.{}", index));
+            case_builder.position_at_end(&portal_block);
+            let socket_ptr = unsafe {
+                case_builder.build_in_bounds_gep(
+                    &socket_ptrs,
+                    &[
+                        ctx.context.i64_type().const_int(0, false),
+                        ctx.context
+                            .i64_type()
+                            .const_int(portal.socket as u64, false),
+                    ],
+                    "",
+                )
+            };
+            let socket = case_builder.build_load(&socket_ptr, "socket");
+            case_builder.build_return(Some(&socket));
+
+            let index_val = ctx.context.i32_type().const_int(index as u64, false);
+            switch_cases.push((index_val, portal_block));
+        }
+        let switch_refs: Vec<_> = switch_cases.iter().map(|&(ref a, ref b)| (a, b)).collect();
+        ctx.b.build_switch(&portal_index, &null_block, &switch_refs);
+    });
+}
+
+// `axiom_generate_block(frames, buffers)` runs the update function `frames` times. `buffers` is
+// indexed by portal: audio portals point to an array of `frames` values which is read before each
+// update (inputs and automation) or written after it (outputs), MIDI inputs point to a single
+// value that's consumed on the first frame. Null buffers are skipped.
+fn build_generate_block_func(
+    module: &Module,
+    target: &TargetProperties,
+    root_sockets: &[VarType],
+    socket_ptrs: PointerValue,
+    portals: &[ExportPortal],
+) {
+    let context = module.get_context();
+    let void_ptr_type = context.i8_type().ptr_type(AddressSpace::Generic);
+    let func = util::get_or_create_func(module, GENERATE_BLOCK_FUNC_NAME, false, &|| {
+        (
+            Linkage::ExternalLinkage,
+            context.void_type().fn_type(
+                &[
+                    &context.i32_type(),
+                    &void_ptr_type.ptr_type(AddressSpace::Generic),
+                ],
+                false,
+            ),
+        )
+    });
+    let update_func = module.get_function(GENERATE_FUNC_NAME).unwrap();
+
+    build_context_function(module, func, target, &|ctx: BuilderContext| {
+        let frame_count = ctx.func.get_nth_param(0).unwrap().into_int_value();
+        let buffers_ptr = ctx.func.get_nth_param(1).unwrap().into_pointer_value();
+
+        let index_ptr = ctx
+            .allocb
+            .build_alloca(&ctx.context.i32_type(), "frameindex.ptr");
+        ctx.b
+            .build_store(&index_ptr, &ctx.context.i32_type().const_int(0, false));
+
+        let check_block = ctx.context.append_basic_block(&ctx.func, "frame.check");
+        let run_block = ctx.context.append_basic_block(&ctx.func, "frame.run");
+        let end_block = ctx.context.append_basic_block(&ctx.func, "frame.end");
+
+        ctx.b.build_unconditional_branch(&check_block);
+        ctx.b.position_at_end(&check_block);
+        let current_index = ctx.b.build_load(&index_ptr, "frameindex").into_int_value();
+        let can_continue =
+            ctx.b
+                .build_int_compare(IntPredicate::ULT, current_index, frame_count, "cancontinue");
+        ctx.b
+            .build_conditional_branch(&can_continue, &run_block, &end_block);
+        ctx.b.position_at_end(&run_block);
+
+        let is_first_frame = ctx.b.build_int_compare(
+            IntPredicate::EQ,
+            current_index,
+            ctx.context.i32_type().const_int(0, false),
+            "isfirst",
+        );
+
+        // copy inputs and automation from their buffers into the portals
+        for (portal_index, portal) in portals.iter().enumerate() {
+            if portal.direction == ExportPortalDirection::Output {
+                continue;
+            }
+
+            let buffer = build_buffer_ptr(ctx.b, ctx.context, buffers_ptr, portal_index);
+            let is_null = ctx.b.build_is_null(buffer, "isnull");
+            let copy_block = ctx
+                .context
+                .append_basic_block(&ctx.func, &format!("input.{}.copy", portal_index));
+            let next_block = ctx
+                .context
+                .append_basic_block(&ctx.func, &format!("input.{}.next", portal_index));
+            ctx.b
+                .build_conditional_branch(&is_null, &next_block, &copy_block);
+            ctx.b.position_at_end(&copy_block);
+
+            let socket =
+                build_socket_ptr(ctx.b, ctx.context, socket_ptrs, root_sockets, portal.socket);
+            let typed_buffer = ctx.b.build_pointer_cast(buffer, socket.get_type(), "");
+            if root_sockets[portal.socket] == VarType::Midi {
+                // MIDI events are only pushed on the first frame, and cleared after that
+                let midi = values::MidiValue::new(socket);
+                let first_block = ctx
+                    .context
+                    .append_basic_block(&ctx.func, &format!("input.{}.first", portal_index));
+                let rest_block = ctx
+                    .context
+                    .append_basic_block(&ctx.func, &format!("input.{}.rest", portal_index));
+                ctx.b
+                    .build_conditional_branch(&is_first_frame, &first_block, &rest_block);
+                ctx.b.position_at_end(&first_block);
+                util::copy_ptr(ctx.b, ctx.module, typed_buffer, socket);
+                ctx.b.build_unconditional_branch(&next_block);
+                ctx.b.position_at_end(&rest_block);
+                midi.set_count(ctx.b, &ctx.context.i8_type().const_int(0, false));
+            } else {
+                let frame = build_frame_ptr(ctx.b, ctx.context, buffer, current_index);
+                build_load_frame(ctx.b, ctx.context, frame, &values::NumValue::new(socket));
+            }
+            ctx.b.build_unconditional_branch(&next_block);
+            ctx.b.position_at_end(&next_block);
+        }
+
+        ctx.b.build_call(&update_func, &[], "", false);
+
+        // copy outputs from the portals into their buffers
+        for (portal_index, portal) in portals.iter().enumerate() {
+            if portal.direction != ExportPortalDirection::Output
+                || root_sockets[portal.socket] == VarType::Midi
+            {
+                continue;
+            }
+
+            let buffer = build_buffer_ptr(ctx.b, ctx.context, buffers_ptr, portal_index);
+            let is_null = ctx.b.build_is_null(buffer, "isnull");
+            let copy_block = ctx
+                .context
+                .append_basic_block(&ctx.func, &format!("output.{}.copy", portal_index));
+            let next_block = ctx
+                .context
+                .append_basic_block(&ctx.func, &format!("output.{}.next", portal_index));
+            ctx.b
+                .build_conditional_branch(&is_null, &next_block, &copy_block);
+            ctx.b.position_at_end(&copy_block);
+
+            let socket =
+                build_socket_ptr(ctx.b, ctx.context, socket_ptrs, root_sockets, portal.socket);
+            let frame = build_frame_ptr(ctx.b, ctx.context, buffer, current_index);
+            build_store_frame(ctx.b, ctx.context, &values::NumValue::new(socket), frame);
+            ctx.b.build_unconditional_branch(&next_block);
+            ctx.b.position_at_end(&next_block);
+        }
+
+        let next_index = ctx.b.build_int_add(
+            current_index,
+            ctx.context.i32_type().const_int(1, false),
+            "nextindex",
+        );
+        ctx.b.build_store(&index_ptr, &next_index);
+        ctx.b.build_unconditional_branch(&check_block);
+
+        ctx.b.position_at_end(&end_block);
+        ctx.b.build_return(None);
+    });
+}
+
+// The event is taken as an i32 so the signature matches the C ABI for passing a 4-byte
+// `AxiomMidiEvent` by value.
+fn build_midi_push_func(module: &Module, target: &TargetProperties) {
+    let context = module.get_context();
+    let midi_type = values::MidiValue::get_type(&context);
+    let event_type = values::MidiEventValue::get_type(&context);
+    let func = util::get_or_create_func(module, MIDI_PUSH_FUNC_NAME, false, &|| {
+        (
+            Linkage::ExternalLinkage,
+            context.void_type().fn_type(
+                &[
+                    &midi_type.ptr_type(AddressSpace::Generic),
+                    &context.i32_type(),
+                ],
+                false,
+            ),
+        )
+    });
+    build_context_function(module, func, target, &|ctx: BuilderContext| {
+        let midi = values::MidiValue::new(ctx.func.get_nth_param(0).unwrap().into_pointer_value());
+        let event_ptr = ctx.allocb.build_alloca(&event_type, "event");
+        let event_int_ptr = ctx.b.build_pointer_cast(
+            event_ptr,
+            ctx.context.i32_type().ptr_type(AddressSpace::Generic),
+            "event.int",
+        );
+        ctx.b
+            .build_store(&event_int_ptr, &ctx.func.get_nth_param(1).unwrap());
+        midi.push_event(ctx.b, ctx.module, &values::MidiEventValue::new(event_ptr));
+        ctx.b.build_return(None);
+    });
+}
@@ -0,0 +1,241 @@
+use super::sampler;
+use codegen::functions::{PARTITION_SIZE, SPECTRUM_BINS, TRANSFORM_SIZE};
+use std::collections::HashMap;
+use std::f64::consts;
+use std::path::Path;
+use std::ptr;
+use std::slice;
+
+#[repr(C, align(8))]
+#[derive(Debug, Clone, Copy, Default)]
+struct StereoSample(f32, f32);
+
+/// An impulse response that can be loaded into a slot for the `convolve` function.
+///
+/// The response is split into partitions, and the spectrum of each is worked out up front so
+/// loading one doesn't take any time on the audio thread. The first two fields are read by
+/// generated code, see `ConvolveFunction::impulse_response_type`.
+#[repr(C)]
+#[derive(Debug)]
+pub struct ImpulseResponse {
+    partition_count: u64,
+    spectra_ptr: *const StereoSample,
+    spectra: Vec<StereoSample>,
+}
+
+// In-place radix-2 FFT, matching the one generated for `convolve`.
+fn transform(real: &mut [f64], imag: &mut [f64]) {
+    let size = real.len();
+    let mut reversed = 0;
+    for index in 0..size {
+        if index < reversed {
+            real.swap(index, reversed);
+            imag.swap(index, reversed);
+        }
+        let mut bit = size >> 1;
+        while reversed & bit != 0 {
+            reversed ^= bit;
+            bit >>= 1;
+        }
+        reversed |= bit;
+    }
+
+    let mut half = 1;
+    while half < size {
+        for start in (0..size).step_by(half * 2) {
+            for offset in 0..half {
+                let angle = -consts::PI * offset as f64 / half as f64;
+                let (twiddle_real, twiddle_imag) = (angle.cos(), angle.sin());
+                let top = start + offset;
+                let bottom = top + half;
+                let t_real = real[bottom] * twiddle_real - imag[bottom] * twiddle_imag;
+                let t_imag = real[bottom] * twiddle_imag + imag[bottom] * twiddle_real;
+                real[bottom] = real[top] - t_real;
+                imag[bottom] = imag[top] - t_imag;
+                real[top] += t_real;
+                imag[top] += t_imag;
+            }
+        }
+        half *= 2;
+    }
+}
+
+impl ImpulseResponse {
+    /// Creates an impulse response from the samples of each channel, which must be the same
+    /// length.
+    pub fn new(left: &[f32], right: &[f32]) -> Self {
+        assert_eq!(left.len(), right.len());
+        let partition_count = (left.len() + PARTITION_SIZE - 1) / PARTITION_SIZE;
+
+        // The inverse transform when convolving doesn't scale its output, so it's done here.
+        let scale = 1. / TRANSFORM_SIZE as f64;
+        let mut spectra = vec![StereoSample::default(); partition_count * SPECTRUM_BINS * 2];
+        {
+            let mut channel_spectra = |samples: &[f32], set: &Fn(&mut StereoSample, f32)| {
+                for (partition, partition_samples) in samples.chunks(PARTITION_SIZE).enumerate() {
+                    let mut real = vec![0.; TRANSFORM_SIZE];
+                    let mut imag = vec![0.; TRANSFORM_SIZE];
+                    for (index, &sample) in partition_samples.iter().enumerate() {
+                        real[index] = sample as f64 * scale;
+                    }
+                    transform(&mut real, &mut imag);
+
+                    let spectrum_start = partition * SPECTRUM_BINS * 2;
+                    for bin in 0..SPECTRUM_BINS {
+                        set(&mut spectra[spectrum_start + bin * 2], real[bin] as f32);
+                        set(&mut spectra[spectrum_start + bin * 2 + 1], imag[bin] as f32);
+                    }
+                }
+            };
+            channel_spectra(left, &|sample, value| sample.0 = value);
+            channel_spectra(right, &|sample, value| sample.1 = value);
+        }
+
+        ImpulseResponse {
+            partition_count: partition_count as u64,
+            spectra_ptr: spectra.as_ptr(),
+            spectra,
+        }
+    }
+
+    /// Loads an impulse response from a WAV file, resampling it to the sample rate it'll be
+    /// convolved at.
+    pub fn open(path: &Path, sample_rate: f32) -> Result<Self, String> {
+        let (left, right, file_rate) = sampler::read_wav_channels(path)?;
+        let left = sampler::resample(&left, file_rate, sample_rate);
+        let right = sampler::resample(&right, file_rate, sample_rate);
+
+        // Resampling changes the number of samples the input is summed over, so the response is
+        // scaled to keep the same gain.
+        let gain = file_rate / sample_rate;
+        let scale = |samples: Vec<f32>| -> Vec<f32> {
+            samples.into_iter().map(|sample| sample * gain).collect()
+        };
+        Ok(ImpulseResponse::new(&scale(left), &scale(right)))
+    }
+
+    pub fn partition_count(&self) -> usize {
+        self.partition_count as usize
+    }
+}
+
+/// The input history of a `convolve` node, the first fields of `ConvolveFunction::data_type`. It
+/// starts out zeroed, and is filled in by `ConvolveHistories` when the node is constructed.
+#[repr(C)]
+#[derive(Debug)]
+pub struct ConvolveHistory {
+    capacity: u64,
+    newest_spectrum: u64,
+    filled_spectra: u64,
+    spectra: *mut StereoSample,
+}
+
+/// Owns the spectra of the input to every `convolve` node.
+///
+/// Each node keeps a ring of spectra long enough for the longest impulse response that's loaded.
+/// They're allocated when the nodes are constructed as part of a commit, and replaced with longer
+/// ones when a longer impulse response is loaded, so the audio thread never has to allocate or
+/// resize them.
+#[derive(Debug)]
+pub struct ConvolveHistories {
+    capacity: usize,
+    is_registering: bool,
+    spectra: HashMap<usize, *mut StereoSample>,
+}
+
+fn alloc_spectra(capacity: usize) -> *mut StereoSample {
+    let spectra = vec![StereoSample::default(); capacity * SPECTRUM_BINS * 2].into_boxed_slice();
+    Box::into_raw(spectra) as *mut StereoSample
+}
+
+unsafe fn free_spectra(spectra: *mut StereoSample, capacity: usize) {
+    Box::from_raw(slice::from_raw_parts_mut(
+        spectra,
+        capacity * SPECTRUM_BINS * 2,
+    ));
+    // box will be dropped here
+}
+
+impl ConvolveHistories {
+    pub fn new() -> Self {
+        ConvolveHistories {
+            capacity: 0,
+            is_registering: false,
+            spectra: HashMap::new(),
+        }
+    }
+
+    /// Frees the spectra of every node, so the nodes can be registered again as they're
+    /// constructed. Every node gets room for `capacity` partitions of input.
+    pub fn begin_register(&mut self, capacity: usize) {
+        self.free_all();
+        self.capacity = capacity;
+        self.is_registering = true;
+    }
+
+    pub fn end_register(&mut self) {
+        self.is_registering = false;
+    }
+
+    /// Makes sure every node has room for `capacity` partitions of input, replacing their spectra
+    /// if they don't. Input that was already collected is dropped. The audio thread must not be
+    /// running an update while this happens.
+    pub fn reserve(&mut self, capacity: usize) {
+        if capacity <= self.capacity {
+            return;
+        }
+
+        for (&history, spectra) in self.spectra.iter_mut() {
+            unsafe {
+                free_spectra(*spectra, self.capacity);
+                *spectra = alloc_spectra(capacity);
+                ConvolveHistories::attach(history as *mut ConvolveHistory, *spectra, capacity);
+            }
+        }
+        self.capacity = capacity;
+    }
+
+    /// Called when a node is constructed. While registering, the node's spectra are allocated.
+    /// Otherwise the node is being reset on the audio thread (e.g when a voice goes to sleep), so
+    /// it's given back the spectra it was registered with. They aren't cleared, since that could
+    /// take a while for a long impulse response: the node only reads spectra it's filled since.
+    pub unsafe fn construct(histories: *mut ConvolveHistories, history: *mut ConvolveHistory) {
+        if (*histories).is_registering {
+            let histories = &mut *histories;
+            let spectra = alloc_spectra(histories.capacity);
+            if let Some(old_spectra) = histories.spectra.insert(history as usize, spectra) {
+                free_spectra(old_spectra, histories.capacity);
+            }
+            ConvolveHistories::attach(history, spectra, histories.capacity);
+            return;
+        }
+
+        let histories = &*histories;
+        match histories.spectra.get(&(history as usize)) {
+            Some(&spectra) => ConvolveHistories::attach(history, spectra, histories.capacity),
+            None => ConvolveHistories::attach(history, ptr::null_mut(), 0),
+        }
+    }
+
+    fn free_all(&mut self) {
+        for (_, &spectra) in self.spectra.iter() {
+            unsafe {
+                free_spectra(spectra, self.capacity);
+            }
+        }
+        self.spectra.clear();
+    }
+
+    unsafe fn attach(history: *mut ConvolveHistory, spectra: *mut StereoSample, capacity: usize) {
+        (*history).capacity = capacity as u64;
+        (*history).newest_spectrum = 0;
+        (*history).filled_spectra = 0;
+        (*history).spectra = spectra;
+    }
+}
+
+impl Drop for ConvolveHistories {
+    fn drop(&mut self) {
+        self.free_all();
+    }
+}
@@ -1,24 +1,34 @@
+use codegen::TargetIsa;
 use inkwell::module::Module;
 use inkwell::orc::{Orc, OrcModuleKey};
-use inkwell::targets::TargetMachine;
+
+extern "C" {
+    fn LLVMAxiomOrcGetModuleSize(address: u64) -> u64;
+}
 
 pub type JitKey = OrcModuleKey;
 
+/// Compiles modules to machine code. Code and data is allocated from an arena that's locked into
+/// memory, so the audio thread never page faults on newly deployed modules. The arena grows in
+/// chunks as more modules are deployed, and `AXIOM_JIT_HUGE_PAGES=1` asks for it to be backed by
+/// huge pages.
 #[derive(Debug)]
 pub struct Jit {
     orc: Orc,
 }
 
 impl Jit {
-    pub fn new() -> Self {
-        let machine = TargetMachine::select();
+    pub fn new(isa: TargetIsa) -> Self {
+        let machine = isa.select_machine();
         let orc = Orc::new(machine);
 
         Jit { orc }
     }
 
-    pub fn deploy(&self, module: &Module) -> JitKey {
-        self.orc.add_module(&module.clone())
+    /// Compiles the module and adds it to the JIT. The JIT keeps hold of the module until it's
+    /// removed, so it's taken by value instead of copied.
+    pub fn deploy(&self, module: Module) -> JitKey {
+        self.orc.add_module(&module)
     }
 
     pub fn remove(&self, key: JitKey) {
@@ -28,4 +38,15 @@ impl Jit {
     pub fn get_symbol_address(&self, symbol: &str) -> u64 {
         self.orc.get_symbol_address(symbol)
     }
+
+    /// Returns how many bytes of code and data the JIT has allocated for the module that defines
+    /// the symbol, or 0 if the symbol isn't defined.
+    pub fn get_module_size(&self, symbol: &str) -> usize {
+        let address = self.get_symbol_address(symbol);
+        if address == 0 {
+            0
+        } else {
+            unsafe { LLVMAxiomOrcGetModuleSize(address) as usize }
+        }
+    }
 }
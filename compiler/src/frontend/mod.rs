@@ -1,12 +1,20 @@
 pub mod c_api;
 mod dependency_graph;
+mod exporter;
+mod impulse_response;
 mod jit;
 mod runtime;
+mod sampler;
 pub mod value_reader;
+mod worker_pool;
 
 pub use self::dependency_graph::DependencyGraph;
+pub use self::exporter::{ExportConfig, ExportPortal, ExportPortalDirection, Exporter};
+pub use self::impulse_response::{ConvolveHistories, ConvolveHistory, ImpulseResponse};
 pub use self::jit::Jit;
-pub use self::runtime::Runtime;
+pub use self::runtime::{CommitMetrics, FrozenUpdate, ModuleMemory, Runtime};
+pub use self::sampler::{Sample, SamplerVoice};
+pub use self::worker_pool::WorkerPool;
 
 use mir::{Block, BlockRef, Root, Surface, SurfaceRef};
 use std::collections::HashMap;
@@ -1,14 +1,20 @@
 use super::dependency_graph::DependencyGraph;
+use super::impulse_response::{ConvolveHistories, ImpulseResponse};
 use super::jit::{Jit, JitKey};
+use super::sampler::{Sample, SampleStreamer};
+use super::worker_pool::WorkerPool;
 use super::Transaction;
 use codegen::{
-    block, controls, converters, data_analyzer, editor, functions, globals, intrinsics, root,
-    surface, values, ObjectCache, Optimizer, TargetProperties,
+    block, controls, converters, copy_elision, data_analyzer, editor, functions, globals,
+    intrinsics, root, surface, util, values, LifecycleFunc, ObjectCache, Optimizer,
+    TargetProperties,
 };
 use inkwell::context::Context;
+use inkwell::memory_buffer::MemoryBuffer;
 use inkwell::module::Module;
-use mir::{Block, BlockRef, IdAllocator, InternalNodeRef, Root, Surface, SurfaceRef};
+use mir::{Block, BlockRef, IdAllocator, InternalNodeRef, NodeData, Root, Surface, SurfaceRef};
 use pass;
+use std::cmp;
 use std::collections::hash_map::Entry;
 use std::collections::{HashMap, HashSet, VecDeque};
 use std::iter;
@@ -16,18 +22,100 @@ use std::iter::FromIterator;
 use std::mem;
 use std::os::raw::c_void;
 use std::ptr;
+use std::sync::Arc;
 use std::time::{Duration, Instant};
 
 #[derive(Debug)]
 struct RuntimeModule {
-    module: Module,
+    // The module's IR, until it's handed over to the JIT.
+    module: Option<Module>,
+
+    // Surfaces can be deployed again without being rebuilt when a block they call is replaced, so
+    // they keep their bitcode around to get the IR back. Nothing else keeps any IR once deployed.
+    bitcode: Option<MemoryBuffer>,
     key: Option<JitKey>,
 }
 
 impl RuntimeModule {
     pub fn new(module: Module, key: Option<JitKey>) -> Self {
-        RuntimeModule { module, key }
+        RuntimeModule {
+            module: Some(module),
+            bitcode: None,
+            key,
+        }
+    }
+
+    pub fn new_relinkable(module: Module, key: Option<JitKey>) -> Self {
+        let bitcode = module.write_bitcode_to_memory();
+        RuntimeModule {
+            module: Some(module),
+            bitcode: Some(bitcode),
+            key,
+        }
     }
+
+    fn parse_bitcode(&self, context: &Context) -> Option<Module> {
+        self.bitcode
+            .as_ref()
+            .map(|bitcode| Module::parse_bitcode_from_buffer_in_context(bitcode, context).unwrap())
+    }
+
+    fn bitcode_size(&self) -> usize {
+        self.bitcode
+            .as_ref()
+            .map_or(0, |bitcode| bitcode.get_size())
+    }
+}
+
+/// How much memory one of the runtime's modules is using.
+#[derive(Debug, Clone)]
+pub struct ModuleMemory {
+    pub name: String,
+
+    /// Bytes of code and data allocated by the JIT.
+    pub jit_bytes: usize,
+
+    /// Bytes of bitcode kept around to deploy the module again.
+    pub bitcode_bytes: usize,
+}
+
+/// How long each phase of a commit took and how much it rebuilt, so the editor can report on
+/// commits without relying on the log.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct CommitMetrics {
+    /// Whether anything was rebuilt. If not, the previous state and pointers are still valid.
+    pub rebuilt: bool,
+
+    /// Seconds spent running passes over the new MIR and working out what to rebuild.
+    pub patch_seconds: f64,
+
+    /// Seconds spent calculating the layouts of new blocks and affected surfaces.
+    pub layout_seconds: f64,
+
+    /// Seconds spent building IR, not including optimization.
+    pub codegen_seconds: f64,
+
+    /// Seconds spent optimizing the new modules.
+    pub optimize_seconds: f64,
+
+    /// Seconds spent handing modules to the JIT.
+    pub deploy_seconds: f64,
+
+    /// Number of blocks that were built again.
+    pub block_count: usize,
+
+    /// Number of surfaces that were built again or re-linked.
+    pub surface_count: usize,
+}
+
+/// Frozen code that's been deployed to the JIT but isn't being run yet, see
+/// `Runtime::build_frozen`.
+#[derive(Debug)]
+pub struct FrozenUpdate {
+    key: JitKey,
+    update: unsafe extern "C" fn(),
+    commit_count: u64,
 }
 
 const INITIALIZED_GLOBAL_NAME: &str = "maxim.runtime.initialized";
@@ -39,6 +127,7 @@ const POINTERS_GLOBAL_NAME: &str = "maxim.runtime.pointers";
 const CONSTRUCT_FUNC_NAME: &str = "maxim.runtime.construct";
 const UPDATE_FUNC_NAME: &str = "maxim.runtime.update";
 const DESTRUCT_FUNC_NAME: &str = "maxim.runtime.destruct";
+const FROZEN_UPDATE_FUNC_NAME: &str = "maxim.runtime.frozen.update";
 
 const CONVERT_NUM_FUNC_NAME: &str = "maxim.editor.convert_num";
 
@@ -46,6 +135,10 @@ const CONVERT_NUM_FUNC_NAME: &str = "maxim.editor.convert_num";
 struct LibraryPointers {
     samplerate_ptr: *mut c_void,
     bpm_ptr: *mut c_void,
+    worker_pool_ptr: *mut c_void,
+    impulse_responses_ptr: *mut c_void,
+    convolve_histories_ptr: *mut c_void,
+    samples_ptr: *mut c_void,
     convert_num: unsafe extern "C" fn(*mut c_void, i8, *const c_void),
 }
 
@@ -58,12 +151,31 @@ impl LibraryPointers {
         let bpm_ptr_address = jit.get_symbol_address(globals::BPM_GLOBAL_NAME) as usize;
         assert_ne!(bpm_ptr_address, 0);
 
+        let worker_pool_ptr_address =
+            jit.get_symbol_address(globals::WORKER_POOL_GLOBAL_NAME) as usize;
+        assert_ne!(worker_pool_ptr_address, 0);
+
+        let impulse_responses_ptr_address =
+            jit.get_symbol_address(globals::IMPULSE_RESPONSES_GLOBAL_NAME) as usize;
+        assert_ne!(impulse_responses_ptr_address, 0);
+
+        let convolve_histories_ptr_address =
+            jit.get_symbol_address(globals::CONVOLVE_HISTORIES_GLOBAL_NAME) as usize;
+        assert_ne!(convolve_histories_ptr_address, 0);
+
+        let samples_ptr_address = jit.get_symbol_address(globals::SAMPLES_GLOBAL_NAME) as usize;
+        assert_ne!(samples_ptr_address, 0);
+
         let convert_num_address = jit.get_symbol_address(CONVERT_NUM_FUNC_NAME) as usize;
         assert_ne!(convert_num_address, 0);
 
         LibraryPointers {
             samplerate_ptr: samplerate_ptr_address as *mut c_void,
             bpm_ptr: bpm_ptr_address as *mut c_void,
+            worker_pool_ptr: worker_pool_ptr_address as *mut c_void,
+            impulse_responses_ptr: impulse_responses_ptr_address as *mut c_void,
+            convolve_histories_ptr: convolve_histories_ptr_address as *mut c_void,
+            samples_ptr: samples_ptr_address as *mut c_void,
             convert_num: unsafe { mem::transmute(convert_num_address) },
         }
     }
@@ -119,6 +231,7 @@ pub struct Runtime {
     target: TargetProperties,
     pub optimizer: Optimizer,
     root: (Root, RuntimeModule),
+    source_surfaces: HashMap<SurfaceRef, Surface>,
     surface_mirs: HashMap<SurfaceRef, Surface>,
     surface_layouts: HashMap<SurfaceRef, data_analyzer::SurfaceLayout>,
     surface_modules: HashMap<SurfaceRef, RuntimeModule>,
@@ -127,8 +240,16 @@ pub struct Runtime {
     block_modules: HashMap<BlockRef, RuntimeModule>,
     graph: DependencyGraph,
     jit: Jit,
+    frozen_key: Option<JitKey>,
+    commit_count: u64,
     library_pointers: LibraryPointers,
     runtime_pointers: Option<RuntimePointers>,
+    worker_pool: Option<Box<WorkerPool>>,
+    parallel_tasks: usize,
+    impulse_responses: Vec<Option<Box<ImpulseResponse>>>,
+    convolve_histories: Box<ConvolveHistories>,
+    samples: Vec<Option<Arc<Sample>>>,
+    sample_streamer: SampleStreamer,
     bpm: f32,
     sample_rate: f32,
 }
@@ -138,20 +259,27 @@ impl Runtime {
         let optimizer = Optimizer::new(&target);
         let context = Context::create();
         let root_module = Runtime::create_module(&context, &target, "root");
-        let jit = Jit::new();
+        let jit = Jit::new(target.isa);
 
         // deploy the library to the JIT
         let library_module = Runtime::codegen_lib(&context, &target);
         optimizer.optimize_module(&library_module);
-        jit.deploy(&library_module);
+        jit.deploy(library_module);
         let library_pointers = LibraryPointers::new(&jit);
 
+        let mut convolve_histories = Box::new(ConvolveHistories::new());
+        unsafe {
+            *(library_pointers.convolve_histories_ptr as *mut *mut ConvolveHistories) =
+                &mut *convolve_histories;
+        }
+
         Runtime {
             next_id: 1,
             context,
             target,
             optimizer,
             root: (Root::new(Vec::new()), RuntimeModule::new(root_module, None)),
+            source_surfaces: HashMap::new(),
             surface_mirs: HashMap::new(),
             surface_layouts: HashMap::new(),
             surface_modules: HashMap::new(),
@@ -160,8 +288,16 @@ impl Runtime {
             block_modules: HashMap::new(),
             graph: DependencyGraph::new(),
             jit,
+            frozen_key: None,
+            commit_count: 0,
             library_pointers,
             runtime_pointers: None,
+            worker_pool: None,
+            parallel_tasks: 1,
+            impulse_responses: (0..globals::IMPULSE_RESPONSE_SLOTS).map(|_| None).collect(),
+            convolve_histories,
+            samples: (0..globals::SAMPLE_SLOTS).map(|_| None).collect(),
+            sample_streamer: SampleStreamer::new(),
             bpm: 60.,
             sample_rate: 44100.,
         }
@@ -229,12 +365,30 @@ impl Runtime {
         Vec::from_iter(required_surfaces.into_iter())
     }
 
-    fn deploy_module(jit: &Jit, module: &mut RuntimeModule) {
+    fn surface_unchanged(old: &Surface, new: &Surface) -> bool {
+        old.id.debug_name == new.id.debug_name && old.groups == new.groups && old.nodes == new.nodes
+    }
+
+    fn block_unchanged(old: &Block, new: &Block) -> bool {
+        old.id.debug_name == new.id.debug_name
+            && old.controls == new.controls
+            && old.statements == new.statements
+    }
+
+    fn deploy_module(jit: &Jit, context: &Context, module: &mut RuntimeModule) {
         // if the module already has a key, remove it
         if let Some(key) = module.key {
             jit.remove(key);
         }
-        let key = jit.deploy(&module.module);
+
+        // modules that are being relinked haven't been rebuilt, so their IR comes from the bitcode
+        let ir = match module.module.take() {
+            Some(ir) => ir,
+            None => module
+                .parse_bitcode(context)
+                .expect("module has already been deployed"),
+        };
+        let key = jit.deploy(ir);
         module.key = Some(key);
     }
 
@@ -289,9 +443,26 @@ impl Runtime {
         }
     }
 
-    fn patch_transaction(&mut self, transaction: Transaction) -> (Vec<BlockRef>, Vec<SurfaceRef>) {
-        let surfaces =
-            self.optimize_surfaces(transaction.surfaces.into_iter().map(|(_, surface)| surface));
+    fn patch_transaction(
+        &mut self,
+        transaction: Transaction,
+        metrics: &mut CommitMetrics,
+    ) -> (Vec<BlockRef>, Vec<SurfaceRef>, Vec<SurfaceRef>) {
+        // Surfaces that are identical to the ones we last received don't need to be touched, so
+        // we skip them before running any passes.
+        let mut source_surfaces = Vec::new();
+        for (_, surface) in transaction.surfaces {
+            let unchanged = match self.source_surfaces.get(&surface.id.id) {
+                Some(old_surface) => Runtime::surface_unchanged(old_surface, &surface),
+                None => false,
+            };
+            if !unchanged {
+                self.source_surfaces.insert(surface.id.id, surface.clone());
+                source_surfaces.push(surface);
+            }
+        }
+        let surfaces = self.optimize_surfaces(source_surfaces);
+
         let mut blocks: Vec<_> = transaction
             .blocks
             .into_iter()
@@ -299,6 +470,27 @@ impl Runtime {
             .collect();
         self.optimize_blocks(blocks.iter_mut());
 
+        // Editing a block's code usually doesn't change its controls or the functions it calls, in
+        // which case its layout is the same and the surfaces containing it can keep their layouts
+        // and code. They only need to be re-linked against the new block. Blocks that haven't
+        // changed at all can be dropped entirely.
+        let mut layout_block_ids = Vec::new();
+        let mut relink_block_ids = Vec::new();
+        {
+            let block_mirs = &self.block_mirs;
+            blocks.retain(|block| match block_mirs.get(&block.id.id) {
+                Some(old_block) if Runtime::block_unchanged(old_block, block) => false,
+                Some(old_block) if data_analyzer::block_layouts_match(old_block, block) => {
+                    relink_block_ids.push(block.id.id);
+                    true
+                }
+                _ => {
+                    layout_block_ids.push(block.id.id);
+                    true
+                }
+            });
+        }
+
         // add the new surfaces to the dependency graph and remove old ones
         for surface in &surfaces {
             self.graph.generate_surface(surface);
@@ -313,7 +505,7 @@ impl Runtime {
         // calculation depends on layouts of surfaces inside.
         let affected_surfaces = HashSet::from_iter(Runtime::get_affected_surfaces(
             &self.graph,
-            &new_block_ids,
+            &layout_block_ids,
             &new_surface_ids,
         ));
         let mut sorted_surfaces = self.graph.get_sorted_surfaces(&affected_surfaces);
@@ -321,8 +513,18 @@ impl Runtime {
         // `sorted_surfaces` goes from the root surface down - we need to process them in reverse
         sorted_surfaces.reverse();
 
+        // Surfaces above a re-linked block keep their existing modules, but still need to be
+        // redeployed so they pick up the new block's functions.
+        let relink_surfaces: Vec<_> =
+            Runtime::get_affected_surfaces(&self.graph, &relink_block_ids, &[])
+                .into_iter()
+                .filter(|surface| !affected_surfaces.contains(surface))
+                .collect();
+
+        let layout_start = Instant::now();
         self.patch_in_blocks(blocks);
         self.patch_in_surfaces(surfaces, &sorted_surfaces);
+        metrics.layout_seconds = precise_duration_seconds(&layout_start.elapsed());
         if let Some(new_root) = transaction.root {
             self.root.0 = new_root;
         }
@@ -330,12 +532,38 @@ impl Runtime {
         // remove orphaned objects
         self.garbage_collect();
 
-        (new_block_ids, sorted_surfaces)
+        // Surfaces with nodes specialized on a re-linked block have their own copies of its code,
+        // so they need to be built again instead of just being redeployed.
+        let (respecialize_surfaces, relink_surfaces): (Vec<_>, Vec<_>) =
+            relink_surfaces.into_iter().partition(|surface_id| {
+                let surface = &self.surface_mirs[surface_id];
+                surface.nodes.iter().any(|node| match node.data {
+                    NodeData::Custom(block_id) => {
+                        relink_block_ids.contains(&block_id)
+                            && !surface::get_fixed_values(node, &surface.groups).is_empty()
+                    }
+                    _ => false,
+                })
+            });
+        sorted_surfaces.extend(respecialize_surfaces);
+
+        (new_block_ids, sorted_surfaces, relink_surfaces)
     }
 
     fn codegen_blocks(&mut self, block_ids: &[BlockRef]) {
+        let target_data = self.target.machine.get_data();
+        let mut copy_stats = copy_elision::CopyStats::default();
+
         for &block_id in block_ids {
             let block = &self.block_mirs[&block_id];
+            let block_stats = copy_elision::count_copied_bytes(
+                &self.context,
+                &target_data,
+                block,
+                &self.block_layouts[&block_id].copy_elisions,
+            );
+            copy_stats.copied_bytes += block_stats.copied_bytes;
+            copy_stats.elided_bytes += block_stats.elided_bytes;
 
             let module_id = if let Entry::Occupied(old_module) = self.block_modules.entry(block_id)
             {
@@ -344,17 +572,22 @@ impl Runtime {
                 None
             };
 
-            let module = RuntimeModule::new(
-                Runtime::create_module(
-                    &self.context,
-                    &self.target,
-                    &format!("block.{}.{}", block.id.id, block.id.debug_name),
-                ),
-                module_id,
+            let module = Runtime::create_module(
+                &self.context,
+                &self.target,
+                &format!("block.{}.{}", block.id.id, block.id.debug_name),
+            );
+            block::build_funcs(&module, self, block);
+            self.optimizer.optimize_module(&module);
+            self.block_modules
+                .insert(block_id, RuntimeModule::new(module, module_id));
+        }
+
+        if !block_ids.is_empty() {
+            println!(
+                "New blocks copy {} bytes per update ({} bytes elided)",
+                copy_stats.copied_bytes, copy_stats.elided_bytes
             );
-            block::build_funcs(&module.module, self, block);
-            self.optimizer.optimize_module(&module.module);
-            self.block_modules.insert(block_id, module);
         }
     }
 
@@ -369,17 +602,15 @@ impl Runtime {
                     None
                 };
 
-            let module = RuntimeModule::new(
-                Runtime::create_module(
-                    &self.context,
-                    &self.target,
-                    &format!("surface.{}.{}", surface.id.id, surface.id.debug_name),
-                ),
-                module_id,
+            let module = Runtime::create_module(
+                &self.context,
+                &self.target,
+                &format!("surface.{}.{}", surface.id.id, surface.id.debug_name),
             );
-            surface::build_funcs(&module.module, self, surface);
-            self.optimizer.optimize_module(&module.module);
-            self.surface_modules.insert(surface_id, module);
+            surface::build_funcs(&module, self, surface);
+            self.optimizer.optimize_module(&module);
+            self.surface_modules
+                .insert(surface_id, RuntimeModule::new_relinkable(module, module_id));
         }
     }
 
@@ -420,29 +651,67 @@ impl Runtime {
         self.codegen_blocks(new_block_ids);
         self.codegen_surfaces(affected_surfaces);
 
-        self.root.1.module = self.codegen_root(&self.root.0);
+        self.root.1.module = Some(self.codegen_root(&self.root.0));
     }
 
-    fn deploy_transaction(&mut self, block_ids: &[BlockRef], affected_surfaces: &[SurfaceRef]) {
+    fn deploy_transaction(
+        &mut self,
+        block_ids: &[BlockRef],
+        affected_surfaces: &[SurfaceRef],
+        relink_surfaces: &[SurfaceRef],
+    ) {
         for block in block_ids {
-            Runtime::deploy_module(&self.jit, self.block_modules.get_mut(block).unwrap());
+            Runtime::deploy_module(
+                &self.jit,
+                &self.context,
+                self.block_modules.get_mut(block).unwrap(),
+            );
         }
-        for surface in affected_surfaces {
-            Runtime::deploy_module(&self.jit, self.surface_modules.get_mut(surface).unwrap());
+        for surface in affected_surfaces.iter().chain(relink_surfaces.iter()) {
+            Runtime::deploy_module(
+                &self.jit,
+                &self.context,
+                self.surface_modules.get_mut(surface).unwrap(),
+            );
+
+            // surfaces only have a task dispatcher if they were split into parallel stages
+            if let Some(ref mut worker_pool) = self.worker_pool {
+                let dispatcher_address = self
+                    .jit
+                    .get_symbol_address(&surface::task_dispatcher_name(*surface))
+                    as usize;
+                let dispatcher = if dispatcher_address == 0 {
+                    None
+                } else {
+                    Some(unsafe { mem::transmute(dispatcher_address) })
+                };
+                worker_pool.set_dispatcher(*surface, dispatcher);
+            }
         }
 
-        Runtime::deploy_module(&self.jit, &mut self.root.1);
+        Runtime::deploy_module(&self.jit, &self.context, &mut self.root.1);
         self.runtime_pointers = Some(RuntimePointers::new(&self.jit));
     }
 
-    pub fn commit(&mut self, transaction: Transaction) {
+    /// Whether committing the transaction rebuilds the runtime, moving its state. Empty
+    /// transactions are skipped unless the parallel task count changed since the last commit.
+    pub fn will_rebuild(&self, transaction: &Transaction) -> bool {
+        !transaction.surfaces.is_empty()
+            || !transaction.blocks.is_empty()
+            || transaction.root.is_some()
+            || self.parallel_tasks != self.target.parallel_tasks
+    }
+
+    pub fn commit(&mut self, transaction: Transaction) -> CommitMetrics {
+        let mut metrics = CommitMetrics::default();
+
         // if the transaction is empty, early exit
-        if transaction.surfaces.is_empty()
-            && transaction.blocks.is_empty()
-            && transaction.root.is_none()
-        {
-            return;
+        if !self.will_rebuild(&transaction) {
+            return metrics;
         }
+        let parallel_tasks_changed = self.parallel_tasks != self.target.parallel_tasks;
+        metrics.rebuilt = true;
+        self.commit_count += 1;
 
         // run destructors on old data before beginning
         if let Some(ref pointers) = self.runtime_pointers {
@@ -451,46 +720,197 @@ impl Runtime {
             }
         }
 
+        // the frozen code is built from the old modules, so it's dropped until the next freeze
+        self.unfreeze();
+
         let patch_start = Instant::now();
-        let (new_block_ids, affected_surfaces) = self.patch_transaction(transaction);
+        let (new_block_ids, mut affected_surfaces, mut relink_surfaces) =
+            self.patch_transaction(transaction, &mut metrics);
+
+        // Surfaces are scheduled differently depending on how many threads they can use, so they
+        // all need to be rebuilt when that changes. The old code has stopped running by now, so
+        // it's safe to swap out the worker pool.
+        if parallel_tasks_changed {
+            self.update_worker_pool();
+            affected_surfaces = self.sorted_surfaces();
+            relink_surfaces.clear();
+        }
+        metrics.patch_seconds =
+            precise_duration_seconds(&patch_start.elapsed()) - metrics.layout_seconds;
+        metrics.block_count = new_block_ids.len();
+        metrics.surface_count = affected_surfaces.len() + relink_surfaces.len();
         println!(
-            "Patch took {}s",
-            precise_duration_seconds(&patch_start.elapsed())
+            "Patch took {}s ({}s in layout)",
+            metrics.patch_seconds, metrics.layout_seconds
         );
 
         let codegen_start = Instant::now();
+        self.optimizer.take_elapsed();
         self.codegen_transaction(&new_block_ids, &affected_surfaces);
+        metrics.optimize_seconds = precise_duration_seconds(&self.optimizer.take_elapsed());
+        metrics.codegen_seconds =
+            precise_duration_seconds(&codegen_start.elapsed()) - metrics.optimize_seconds;
         println!(
-            "Codegen took {}s",
-            precise_duration_seconds(&codegen_start.elapsed())
+            "Codegen took {}s ({}s in optimization)",
+            metrics.codegen_seconds, metrics.optimize_seconds
         );
 
         let deploy_start = Instant::now();
-        self.deploy_transaction(&new_block_ids, &affected_surfaces);
+        self.deploy_transaction(&new_block_ids, &affected_surfaces, &relink_surfaces);
+        metrics.deploy_seconds = precise_duration_seconds(&deploy_start.elapsed());
+        println!(
+            "Deploy took {}s for {} blocks and {} surfaces",
+            metrics.deploy_seconds, metrics.block_count, metrics.surface_count
+        );
+
+        let module_memory = self.module_memory();
         println!(
-            "Deploy took {}s",
-            precise_duration_seconds(&deploy_start.elapsed())
+            "Modules use {} bytes of JIT memory and {} bytes of bitcode",
+            module_memory
+                .iter()
+                .map(|module| module.jit_bytes)
+                .sum::<usize>(),
+            module_memory
+                .iter()
+                .map(|module| module.bitcode_bytes)
+                .sum::<usize>()
         );
 
         // reset the BPM and sample rate
         Runtime::set_vector(self.library_pointers.bpm_ptr, self.bpm);
         Runtime::set_vector(self.library_pointers.samplerate_ptr, self.sample_rate);
 
+        // `convolve` nodes get room for the longest impulse response as they're constructed
+        let convolve_capacity = self
+            .impulse_responses
+            .iter()
+            .filter_map(|response| response.as_ref().map(|response| response.partition_count()))
+            .max()
+            .unwrap_or(0);
+        self.convolve_histories.begin_register(convolve_capacity);
         if let Some(ref pointers) = self.runtime_pointers {
             // run the new constructor
             unsafe {
                 (pointers.construct)();
             }
         }
+        self.convolve_histories.end_register();
+
+        metrics
+    }
+
+    fn codegen_frozen(&self) -> Module {
+        let module = Runtime::create_module(&self.context, &self.target, "frozen");
+        for block in self.block_mirs.values() {
+            block::build_funcs(&module, self, block);
+        }
+        for surface_id in self.sorted_surfaces() {
+            surface::build_funcs(&module, self, &self.surface_mirs[&surface_id]);
+        }
+
+        // The frozen update runs on the state defined by the root module, so switching to it
+        // doesn't need to move any state around. It gets its own copy of the pointers global
+        // though, since that's constant and folding it is what lets LLVM resolve node pointers.
+        let state_globals = root::declare_state_globals(
+            &module,
+            self,
+            &self.root.0,
+            0,
+            INITIALIZED_GLOBAL_NAME,
+            SCRATCH_GLOBAL_NAME,
+            SOCKETS_GLOBAL_NAME,
+        );
+        let pointers_global = root::build_pointers_global(
+            &module,
+            self,
+            0,
+            POINTERS_GLOBAL_NAME,
+            state_globals.initialized.as_pointer_value(),
+            state_globals.scratch.as_pointer_value(),
+            state_globals.sockets.as_pointer_value(),
+        );
+        root::build_lifecycle_func(
+            &module,
+            self,
+            0,
+            FROZEN_UPDATE_FUNC_NAME,
+            LifecycleFunc::Update,
+            pointers_global.as_pointer_value(),
+        );
+
+        // Blocks and surfaces are private to the frozen module, so they can be inlined into the
+        // update and don't clash with the symbols in their own modules. Parallel stages still go
+        // through the worker pool, which keeps running tasks from the surfaces' own modules.
+        util::internalize_module(&module, &[FROZEN_UPDATE_FUNC_NAME]);
+        self.optimizer.optimize_module(&module);
+        module
+    }
+
+    /// Links every block and surface into one module along with the root's update function, and
+    /// deploys it next to the separate modules. Since nothing is called across module boundaries,
+    /// LLVM can inline block code into surface loops and optimize across nodes.
+    ///
+    /// This takes much longer than a normal commit, so it's meant to be done once the patch hasn't
+    /// been edited for a while. It only reads the MIR and adds a module to the JIT, so it can run
+    /// while the audio thread is updating. Updates don't use the new code until it's passed to
+    /// `apply_frozen`. Returns `None` if the patch is already frozen or there's nothing to freeze.
+    pub fn build_frozen(&self) -> Option<FrozenUpdate> {
+        if self.frozen_key.is_some() || self.runtime_pointers.is_none() {
+            return None;
+        }
+
+        let freeze_start = Instant::now();
+        let module = self.codegen_frozen();
+        let key = self.jit.deploy(module);
+        let update_address = self.jit.get_symbol_address(FROZEN_UPDATE_FUNC_NAME) as usize;
+        assert_ne!(update_address, 0);
+        println!(
+            "Freeze took {}s",
+            precise_duration_seconds(&freeze_start.elapsed())
+        );
+
+        Some(FrozenUpdate {
+            key,
+            update: unsafe { mem::transmute(update_address) },
+            commit_count: self.commit_count,
+        })
+    }
+
+    /// Switches updates over to code built by `build_frozen`. The separate modules stay deployed,
+    /// and the next commit goes back to using them.
+    pub fn apply_frozen(&mut self, frozen: FrozenUpdate) {
+        // the frozen code is built against the state of the last commit, so it's no use after another
+        if self.frozen_key.is_some() || frozen.commit_count != self.commit_count {
+            self.jit.remove(frozen.key);
+            return;
+        }
+
+        if let Some(ref mut pointers) = self.runtime_pointers {
+            pointers.update = frozen.update;
+        }
+        self.frozen_key = Some(frozen.key);
+    }
+
+    fn unfreeze(&mut self) {
+        if let Some(key) = self.frozen_key.take() {
+            self.jit.remove(key);
+        }
+    }
+
+    pub fn is_frozen(&self) -> bool {
+        self.frozen_key.is_some()
     }
 
     /// Remove any objects that aren't referenced by others (and aren't the root).
     pub fn garbage_collect(&mut self) {
         let graph = &self.graph;
+        self.source_surfaces
+            .retain(|&key, _| graph.get_surface_deps(key).is_some());
         let surface_mirs = &mut self.surface_mirs;
         let surface_layouts = &mut self.surface_layouts;
         let block_mirs = &mut self.block_mirs;
         let block_layouts = &mut self.block_layouts;
+        let worker_pool = &mut self.worker_pool;
         let jit = &self.jit;
 
         // we can now remove any objects that don't exist in the graph
@@ -500,6 +920,9 @@ impl Runtime {
             } else {
                 surface_mirs.remove(&key);
                 surface_layouts.remove(&key);
+                if let Some(ref mut worker_pool) = worker_pool {
+                    worker_pool.set_dispatcher(key, None);
+                }
                 Runtime::remove_module(jit, module);
                 false
             }
@@ -565,6 +988,75 @@ impl Runtime {
         self.sample_rate
     }
 
+    /// Sets how many threads surface updates can be spread across. This takes effect on the next
+    /// commit, which rebuilds every surface.
+    pub fn set_parallel_tasks(&mut self, parallel_tasks: usize) {
+        self.parallel_tasks = cmp::max(parallel_tasks, 1);
+    }
+
+    fn update_worker_pool(&mut self) {
+        // The thread running the update takes tasks too, so the pool needs one less worker.
+        let parallel_tasks = self.parallel_tasks;
+        self.target.parallel_tasks = parallel_tasks;
+        self.worker_pool = if parallel_tasks > 1 {
+            Some(Box::new(WorkerPool::new(parallel_tasks - 1)))
+        } else {
+            None
+        };
+
+        let worker_pool_ptr = match self.worker_pool {
+            Some(ref worker_pool) => &**worker_pool as *const WorkerPool as *mut c_void,
+            None => ptr::null_mut(),
+        };
+        unsafe {
+            *(self.library_pointers.worker_pool_ptr as *mut *mut c_void) = worker_pool_ptr;
+        }
+    }
+
+    pub fn get_parallel_tasks(&self) -> usize {
+        self.parallel_tasks
+    }
+
+    /// Loads an impulse response into a slot that `convolve` can read from, replacing the one
+    /// that was there before. If it's longer than any other that's loaded, `convolve` nodes are
+    /// given more room for their input here. The audio thread must not be running an update while
+    /// this happens.
+    pub fn set_impulse_response(&mut self, slot: usize, response: Option<Box<ImpulseResponse>>) {
+        assert!(slot < globals::IMPULSE_RESPONSE_SLOTS);
+        let response_ptr = match response {
+            Some(ref response) => {
+                self.convolve_histories.reserve(response.partition_count());
+                &**response as *const ImpulseResponse as *mut c_void
+            }
+            None => ptr::null_mut(),
+        };
+        unsafe {
+            *(self.library_pointers.impulse_responses_ptr as *mut *mut c_void).add(slot) =
+                response_ptr;
+        }
+        self.impulse_responses[slot] = response;
+    }
+
+    /// Loads a sample into a slot that `sampler` can play from, replacing the one that was there
+    /// before. Voices playing the old sample stop. The audio thread must not be running an update
+    /// while this happens.
+    pub fn set_sample(&mut self, slot: usize, sample: Option<Box<Sample>>) {
+        assert!(slot < globals::SAMPLE_SLOTS);
+        let sample = sample.map(|sample| self.sample_streamer.add_sample(sample));
+        let sample_ptr = match sample {
+            Some(ref sample) => &**sample as *const Sample as *mut c_void,
+            None => ptr::null_mut(),
+        };
+        unsafe {
+            *(self.library_pointers.samples_ptr as *mut *mut c_void).add(slot) = sample_ptr;
+        }
+
+        if let Some(ref old_sample) = self.samples[slot] {
+            self.sample_streamer.remove_sample(old_sample);
+        }
+        self.samples[slot] = sample;
+    }
+
     pub fn is_node_extracted(&self, surface: SurfaceRef, node: usize) -> bool {
         let surface_mir = self.surface_mir(surface).unwrap();
         let node_inner = surface_mir.source_map.map_to_internal(node);
@@ -580,6 +1072,23 @@ impl Runtime {
         unsafe { (self.library_pointers.convert_num)(result, target_form, num) }
     }
 
+    pub fn root_mir(&self) -> &Root {
+        &self.root.0
+    }
+
+    pub fn block_mirs(&self) -> impl Iterator<Item = &Block> {
+        self.block_mirs.values()
+    }
+
+    /// Returns every surface reachable from the root, ordered so that each surface comes after
+    /// the surfaces it contains.
+    pub fn sorted_surfaces(&self) -> Vec<SurfaceRef> {
+        let all_surfaces = HashSet::from_iter(self.surface_mirs.keys().cloned());
+        let mut sorted_surfaces = self.graph.get_sorted_surfaces(&all_surfaces);
+        sorted_surfaces.reverse();
+        sorted_surfaces
+    }
+
     pub fn print_mir(&self) {
         println!(">> Begin MIR");
         println!("Blocks >>");
@@ -594,14 +1103,59 @@ impl Runtime {
         println!("<< End MIR");
     }
 
+    /// Prints the IR that's kept for deployed modules. Only surfaces keep theirs (as bitcode), so
+    /// blocks and the root aren't printed once they've been deployed.
     pub fn print_modules(&self) {
-        for module in self.block_modules.values() {
-            module.module.print_to_stderr();
-        }
-        for module in self.surface_modules.values() {
-            module.module.print_to_stderr();
+        let modules = self
+            .block_modules
+            .values()
+            .chain(self.surface_modules.values())
+            .chain(iter::once(&self.root.1));
+        for module in modules {
+            if let Some(ref ir) = module.module {
+                ir.print_to_stderr();
+            } else if let Some(ir) = module.parse_bitcode(&self.context) {
+                ir.print_to_stderr();
+            }
         }
-        self.root.1.module.print_to_stderr();
+    }
+
+    /// Returns how much memory each block, surface and the root are using once deployed, along
+    /// with the frozen module if there is one.
+    pub fn module_memory(&self) -> Vec<ModuleMemory> {
+        let block_memory = self.block_modules.iter().map(|(&id, module)| ModuleMemory {
+            name: format!("block.{}", id),
+            jit_bytes: self
+                .jit
+                .get_module_size(&block::lifecycle_func_name(id, LifecycleFunc::Update)),
+            bitcode_bytes: module.bitcode_size(),
+        });
+        let surface_memory = self
+            .surface_modules
+            .iter()
+            .map(|(&id, module)| ModuleMemory {
+                name: format!("surface.{}", id),
+                jit_bytes: self
+                    .jit
+                    .get_module_size(&surface::lifecycle_func_name(id, LifecycleFunc::Update)),
+                bitcode_bytes: module.bitcode_size(),
+            });
+        let root_memory = iter::once(ModuleMemory {
+            name: "root".to_string(),
+            jit_bytes: self.jit.get_module_size(UPDATE_FUNC_NAME),
+            bitcode_bytes: self.root.1.bitcode_size(),
+        });
+        let frozen_memory = self.frozen_key.map(|_| ModuleMemory {
+            name: "frozen".to_string(),
+            jit_bytes: self.jit.get_module_size(FROZEN_UPDATE_FUNC_NAME),
+            bitcode_bytes: 0,
+        });
+
+        block_memory
+            .chain(surface_memory)
+            .chain(root_memory)
+            .chain(frozen_memory)
+            .collect()
     }
 }
 
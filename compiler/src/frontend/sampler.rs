@@ -0,0 +1,645 @@
+use codegen::globals;
+use std::cell::UnsafeCell;
+use std::cmp;
+use std::fs::File;
+use std::io::{Read, Seek, SeekFrom};
+use std::path::Path;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::Duration;
+
+/// The number of frames at the start of every sample that are kept in memory, so a voice can
+/// start playing as soon as it's triggered while the rest of the sample is read from disk.
+pub const PRELOAD_FRAMES: usize = 32768;
+
+/// The number of voices that can stream samples at once, shared between every sample in a
+/// runtime. Voices triggered while every stream is taken only play the preloaded part of their
+/// sample.
+pub const STREAM_COUNT: usize = 32;
+
+// Each stream buffers up to this many frames ahead of the voice reading it, enough to cover a
+// few hundred milliseconds of a slow disk.
+const STREAM_CAPACITY: usize = 16384;
+
+// The most frames read from disk for one stream before moving on to the next, so one voice can't
+// starve the others.
+const PREFETCH_CHUNK_FRAMES: usize = 4096;
+const PREFETCH_INTERVAL: Duration = Duration::from_millis(2);
+
+// Streams are claimed by the audio thread and filled by the prefetch thread. Only the prefetch
+// thread resets a stream, so it never writes to one that's been handed to another voice. A stream
+// is claiming while the audio thread sets which sample it's for.
+const STREAM_FREE: usize = 0;
+const STREAM_CLAIMED: usize = 1;
+const STREAM_STREAMING: usize = 2;
+const STREAM_RELEASED: usize = 3;
+const STREAM_CLAIMING: usize = 4;
+
+static NEXT_SAMPLE_ID: AtomicUsize = AtomicUsize::new(0);
+
+#[repr(C, align(8))]
+#[derive(Debug, Clone, Copy, Default)]
+struct StereoSample(f32, f32);
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum SampleFormat {
+    Int(usize),
+    Float,
+}
+
+#[derive(Debug)]
+struct WavInfo {
+    format: SampleFormat,
+    channel_count: usize,
+    sample_rate: f32,
+    data_offset: u64,
+    frame_count: usize,
+}
+
+fn read_le(bytes: &[u8]) -> u32 {
+    bytes
+        .iter()
+        .rev()
+        .fold(0, |value, &byte| (value << 8) | byte as u32)
+}
+
+impl WavInfo {
+    fn read(file: &mut File) -> Result<WavInfo, String> {
+        let mut header = [0; 12];
+        file.read_exact(&mut header)
+            .map_err(|_| "The file isn't a WAV file.".to_string())?;
+        if &header[0..4] != b"RIFF" || &header[8..12] != b"WAVE" {
+            return Err("The file isn't a WAV file.".to_string());
+        }
+
+        // chunks can appear in any order, and are padded to an even size
+        let file_size = file.metadata().map_err(|err| err.to_string())?.len();
+        let mut format = None;
+        let mut data = None;
+        let mut chunk_header = [0; 8];
+        while file.read_exact(&mut chunk_header).is_ok() {
+            let chunk_size = read_le(&chunk_header[4..8]) as u64;
+            let chunk_offset = file
+                .seek(SeekFrom::Current(0))
+                .map_err(|err| err.to_string())?;
+            if &chunk_header[0..4] == b"fmt " && chunk_size >= 16 {
+                let mut format_chunk = vec![0; cmp::min(chunk_size, 40) as usize];
+                file.read_exact(&mut format_chunk)
+                    .map_err(|err| err.to_string())?;
+                let mut format_tag = read_le(&format_chunk[0..2]);
+
+                // extensible files keep the real format at the start of their sub-format GUID
+                if format_tag == 0xFFFE && format_chunk.len() >= 26 {
+                    format_tag = read_le(&format_chunk[24..26]);
+                }
+                format = Some((
+                    format_tag,
+                    read_le(&format_chunk[2..4]) as usize,
+                    read_le(&format_chunk[4..8]),
+                    read_le(&format_chunk[14..16]) as usize,
+                ));
+            } else if &chunk_header[0..4] == b"data" {
+                let data_size = cmp::min(chunk_size, file_size.saturating_sub(chunk_offset));
+                data = Some((chunk_offset, data_size));
+            }
+
+            file.seek(SeekFrom::Start(
+                chunk_offset + chunk_size + (chunk_size & 1),
+            )).map_err(|err| err.to_string())?;
+        }
+
+        let unsupported = "Only uncompressed PCM or 32-bit float WAV files are supported.";
+        let (format_tag, channel_count, sample_rate, bits_per_sample) =
+            format.ok_or(unsupported)?;
+        let sample_format = match (format_tag, bits_per_sample) {
+            (1, 8) | (1, 16) | (1, 24) | (1, 32) => SampleFormat::Int(bits_per_sample / 8),
+            (3, 32) => SampleFormat::Float,
+            _ => return Err(unsupported.to_string()),
+        };
+        let (data_offset, data_size) = data.ok_or(unsupported)?;
+        if channel_count == 0 || sample_rate == 0 {
+            return Err(unsupported.to_string());
+        }
+
+        let mut info = WavInfo {
+            format: sample_format,
+            channel_count,
+            sample_rate: sample_rate as f32,
+            data_offset,
+            frame_count: 0,
+        };
+        info.frame_count = data_size as usize / info.frame_bytes();
+        Ok(info)
+    }
+
+    fn sample_bytes(&self) -> usize {
+        match self.format {
+            SampleFormat::Int(bytes) => bytes,
+            SampleFormat::Float => 4,
+        }
+    }
+
+    fn frame_bytes(&self) -> usize {
+        self.sample_bytes() * self.channel_count
+    }
+
+    fn convert_sample(&self, bytes: &[u8]) -> f32 {
+        let value = read_le(bytes);
+        match self.format {
+            SampleFormat::Float => f32::from_bits(value),
+            // 8-bit samples are unsigned
+            SampleFormat::Int(1) => (value as f32 - 128.) / 128.,
+            // sign-extend by shifting the sample to the top of a 32-bit int
+            SampleFormat::Int(bytes) => ((value << (32 - bytes * 8)) as i32) as f32 / 2147483648.,
+        }
+    }
+
+    // Converts frames of the file's data into stereo, using the first channel of mono files for
+    // both sides and dropping any channels after the second.
+    fn convert_frame(&self, bytes: &[u8]) -> StereoSample {
+        let sample_bytes = self.sample_bytes();
+        let right_offset = if self.channel_count > 1 {
+            sample_bytes
+        } else {
+            0
+        };
+        StereoSample(
+            self.convert_sample(&bytes[0..sample_bytes]),
+            self.convert_sample(&bytes[right_offset..right_offset + sample_bytes]),
+        )
+    }
+}
+
+fn lerp(from: StereoSample, to: StereoSample, amount: f32) -> StereoSample {
+    StereoSample(
+        from.0 + (to.0 - from.0) * amount,
+        from.1 + (to.1 - from.1) * amount,
+    )
+}
+
+/// Reads all of a WAV file into memory, returning the samples of each side and the sample rate
+/// they were recorded at. Channels are converted to stereo the same way they are for samples.
+pub fn read_wav_channels(path: &Path) -> Result<(Vec<f32>, Vec<f32>, f32), String> {
+    let mut file = File::open(path).map_err(|err| err.to_string())?;
+    let info = WavInfo::read(&mut file)?;
+
+    let mut bytes = vec![0; info.frame_count * info.frame_bytes()];
+    file.seek(SeekFrom::Start(info.data_offset))
+        .and_then(|_| file.read_exact(&mut bytes))
+        .map_err(|err| err.to_string())?;
+    let (left, right) = bytes
+        .chunks(info.frame_bytes())
+        .map(|frame| {
+            let StereoSample(left, right) = info.convert_frame(frame);
+            (left, right)
+        }).unzip();
+    Ok((left, right, info.sample_rate))
+}
+
+/// Resamples a channel from one sample rate to another with linear interpolation, the same way
+/// `sampler` plays samples back at a different rate.
+pub fn resample(samples: &[f32], from_rate: f32, to_rate: f32) -> Vec<f32> {
+    if from_rate == to_rate || samples.is_empty() {
+        return samples.to_vec();
+    }
+
+    let step = from_rate as f64 / to_rate as f64;
+    let length = ((samples.len() - 1) as f64 / step) as usize + 1;
+    (0..length)
+        .map(|index| {
+            let position = index as f64 * step;
+            let start = position as usize;
+            let end = cmp::min(start + 1, samples.len() - 1);
+            let amount = (position - start as f64) as f32;
+            samples[start] + (samples[end] - samples[start]) * amount
+        }).collect()
+}
+
+// A single-producer single-consumer ring of frames, filled by the prefetch thread and read by the
+// voice that claimed it.
+#[derive(Debug)]
+struct SampleStream {
+    state: AtomicUsize,
+    sample_id: AtomicUsize,
+    written: AtomicUsize,
+    read: AtomicUsize,
+    buffer: Box<[UnsafeCell<StereoSample>]>,
+}
+
+unsafe impl Sync for SampleStream {}
+
+impl SampleStream {
+    fn new() -> Self {
+        SampleStream {
+            state: AtomicUsize::new(STREAM_FREE),
+            sample_id: AtomicUsize::new(0),
+            written: AtomicUsize::new(0),
+            read: AtomicUsize::new(0),
+            buffer: (0..STREAM_CAPACITY)
+                .map(|_| UnsafeCell::new(StereoSample::default()))
+                .collect::<Vec<_>>()
+                .into_boxed_slice(),
+        }
+    }
+
+    fn pop(&self) -> Option<StereoSample> {
+        if self.state.load(Ordering::Acquire) != STREAM_STREAMING {
+            return None;
+        }
+
+        let read = self.read.load(Ordering::Relaxed);
+        if read == self.written.load(Ordering::Acquire) {
+            return None;
+        }
+        let frame = unsafe { *self.buffer[read % STREAM_CAPACITY].get() };
+        self.read.store(read + 1, Ordering::Release);
+        Some(frame)
+    }
+
+    // Runs on the prefetch thread, resetting the stream if it's been claimed or released and
+    // topping it up if it's playing. Streams for samples that were only just added are left until
+    // the next pass.
+    fn prefetch(&self, samples: &[Arc<Sample>], read_buffer: &mut Vec<u8>) {
+        let state = self.state.load(Ordering::Acquire);
+        if state == STREAM_RELEASED {
+            self.state.store(STREAM_FREE, Ordering::Release);
+            return;
+        }
+        if state != STREAM_CLAIMED && state != STREAM_STREAMING {
+            return;
+        }
+
+        let sample_id = self.sample_id.load(Ordering::Relaxed);
+        let sample = match samples.iter().find(|sample| sample.id == sample_id) {
+            Some(sample) => sample,
+            None => return,
+        };
+        if state == STREAM_CLAIMED {
+            self.read.store(0, Ordering::Relaxed);
+            self.written.store(0, Ordering::Relaxed);
+
+            // the stream might have been released in the meantime
+            if self
+                .state
+                .compare_exchange(
+                    STREAM_CLAIMED,
+                    STREAM_STREAMING,
+                    Ordering::Release,
+                    Ordering::Relaxed,
+                ).is_err()
+            {
+                return;
+            }
+        }
+        sample.fill_stream(self, read_buffer);
+    }
+}
+
+/// The streams voices read samples from disk with, shared by every sample in a runtime. They're
+/// only allocated once a sample that doesn't fit in its preloaded frames is loaded.
+#[derive(Debug)]
+struct SampleStreams {
+    streams: Vec<SampleStream>,
+}
+
+impl SampleStreams {
+    fn new() -> Self {
+        SampleStreams {
+            streams: (0..STREAM_COUNT).map(|_| SampleStream::new()).collect(),
+        }
+    }
+
+    fn claim(&self, sample_id: usize) -> Option<usize> {
+        let index = self.streams.iter().position(|stream| {
+            stream
+                .state
+                .compare_exchange(
+                    STREAM_FREE,
+                    STREAM_CLAIMING,
+                    Ordering::Acquire,
+                    Ordering::Relaxed,
+                ).is_ok()
+        })?;
+        let stream = &self.streams[index];
+        stream.sample_id.store(sample_id, Ordering::Relaxed);
+        stream.state.store(STREAM_CLAIMED, Ordering::Release);
+        Some(index)
+    }
+
+    // Gives back every stream of a sample that's no longer in a slot. Nothing can read from them
+    // any more, since voices check the sample in their slot before reading.
+    fn release_sample(&self, sample_id: usize) {
+        for stream in &self.streams {
+            let state = stream.state.load(Ordering::Acquire);
+            if (state == STREAM_CLAIMED || state == STREAM_STREAMING)
+                && stream.sample_id.load(Ordering::Relaxed) == sample_id
+            {
+                stream.state.store(STREAM_RELEASED, Ordering::Release);
+            }
+        }
+    }
+}
+
+/// A sample that can be played by the `sampler` function.
+///
+/// Only the first `PRELOAD_FRAMES` frames are loaded into memory, the rest is streamed from the
+/// file by a `SampleStreamer` into a ring buffer for each playing voice, so the audio thread never
+/// touches the disk. Voices step through the sample by the ratio of its sample rate to the
+/// runtime's, so it plays at the same pitch at any rate.
+#[derive(Debug)]
+pub struct Sample {
+    id: usize,
+    info: WavInfo,
+    file: Mutex<File>,
+    attack: Vec<StereoSample>,
+    streams: Option<Arc<SampleStreams>>,
+}
+
+impl Sample {
+    /// Opens a WAV file and loads its first frames.
+    pub fn open(path: &Path) -> Result<Self, String> {
+        let mut file = File::open(path).map_err(|err| err.to_string())?;
+        let info = WavInfo::read(&mut file)?;
+
+        let attack_frames = cmp::min(info.frame_count, PRELOAD_FRAMES);
+        let mut attack_bytes = vec![0; attack_frames * info.frame_bytes()];
+        file.seek(SeekFrom::Start(info.data_offset))
+            .and_then(|_| file.read_exact(&mut attack_bytes))
+            .map_err(|err| err.to_string())?;
+        let attack = attack_bytes
+            .chunks(info.frame_bytes())
+            .map(|frame| info.convert_frame(frame))
+            .collect();
+
+        Ok(Sample {
+            id: NEXT_SAMPLE_ID.fetch_add(1, Ordering::Relaxed) + 1,
+            info,
+            file: Mutex::new(file),
+            attack,
+            streams: None,
+        })
+    }
+
+    pub fn frame_count(&self) -> usize {
+        self.info.frame_count
+    }
+
+    fn needs_streaming(&self) -> bool {
+        self.frame_count() > self.attack.len()
+    }
+
+    fn claim_stream(&self) -> Option<usize> {
+        self.streams
+            .as_ref()
+            .and_then(|streams| streams.claim(self.id))
+    }
+
+    fn get_stream(&self, stream: u64) -> &SampleStream {
+        &self.streams.as_ref().unwrap().streams[stream as usize - 1]
+    }
+
+    fn fill_stream(&self, stream: &SampleStream, read_buffer: &mut Vec<u8>) {
+        let written = stream.written.load(Ordering::Relaxed);
+        let read = stream.read.load(Ordering::Acquire);
+        let next_frame = self.attack.len() + written;
+        let frame_count = cmp::min(
+            cmp::min(STREAM_CAPACITY - (written - read), PREFETCH_CHUNK_FRAMES),
+            self.info.frame_count.saturating_sub(next_frame),
+        );
+        if frame_count == 0 {
+            return;
+        }
+
+        let frame_bytes = self.info.frame_bytes();
+        read_buffer.resize(frame_count * frame_bytes, 0);
+        let offset = self.info.data_offset + (next_frame * frame_bytes) as u64;
+        let mut file = self.file.lock().unwrap();
+        if file
+            .seek(SeekFrom::Start(offset))
+            .and_then(|_| file.read_exact(read_buffer))
+            .is_err()
+        {
+            // leave the voice to underrun, the file might be back on the next pass
+            return;
+        }
+
+        for (index, frame) in read_buffer.chunks(frame_bytes).enumerate() {
+            unsafe {
+                *stream.buffer[(written + index) % STREAM_CAPACITY].get() =
+                    self.info.convert_frame(frame);
+            }
+        }
+        stream
+            .written
+            .store(written + frame_count, Ordering::Release);
+    }
+}
+
+/// The state of a `sampler` node, see `SamplerFunction::data_type`. It starts out zeroed.
+#[repr(C)]
+#[derive(Debug)]
+pub struct SamplerVoice {
+    output: StereoSample,
+    last_frame: StereoSample,
+    next_frame: StereoSample,
+    sample_id: u64,
+    stream: u64,
+    position: u64,
+    slot: u64,
+    phase: f32,
+    last_gate: f32,
+    is_playing: u32,
+}
+
+unsafe fn get_slot_sample<'a>(samples: *const *const Sample, slot: u64) -> Option<&'a Sample> {
+    let sample = *samples.offset(slot as isize);
+    if sample.is_null() {
+        None
+    } else {
+        Some(&*sample)
+    }
+}
+
+impl SamplerVoice {
+    /// Plays the next frame of the voice into its output, given the array of samples in each
+    /// slot and the runtime's sample rate. A rising edge on the gate starts the sample in the slot
+    /// from the beginning.
+    pub unsafe fn read(
+        &mut self,
+        samples: *const *const Sample,
+        gate: f32,
+        slot: f32,
+        sample_rate: f32,
+    ) {
+        let is_triggered = gate > 0. && self.last_gate <= 0.;
+        self.last_gate = gate;
+        self.output = StereoSample::default();
+
+        if is_triggered {
+            self.release(samples);
+            self.slot = (slot.max(0.) as u64).min(globals::SAMPLE_SLOTS as u64 - 1);
+            self.position = 0;
+            self.is_playing = 0;
+            if let Some(sample) = get_slot_sample(samples, self.slot) {
+                self.sample_id = sample.id as u64;
+                self.is_playing = 1;
+                if sample.needs_streaming() {
+                    self.stream = sample.claim_stream().map_or(0, |stream| stream as u64 + 1);
+                }
+
+                // the first two frames are read before the first output
+                self.phase = 2.;
+            }
+        }
+
+        if self.is_playing == 0 {
+            return;
+        }
+        let sample = match get_slot_sample(samples, self.slot) {
+            Some(sample) if sample.id as u64 == self.sample_id => sample,
+            _ => {
+                self.is_playing = 0;
+                self.stream = 0;
+                return;
+            }
+        };
+
+        // The output is interpolated between the last two frames read, moving on to the next
+        // frame each time the phase passes one.
+        while self.phase >= 1. {
+            let position = self.position as usize;
+            let frame = if position >= sample.frame_count() {
+                None
+            } else if position < sample.attack.len() {
+                Some(sample.attack[position])
+            } else if self.stream != 0 {
+                match sample.get_stream(self.stream).pop() {
+                    Some(frame) => Some(frame),
+                    // the disk has fallen behind, so the voice waits for it
+                    None => return,
+                }
+            } else {
+                // there's no stream, so nothing more can be played
+                None
+            };
+
+            match frame {
+                Some(frame) => {
+                    self.last_frame = self.next_frame;
+                    self.next_frame = frame;
+                    self.position += 1;
+                    self.phase -= 1.;
+                }
+                None => {
+                    self.release(samples);
+                    self.is_playing = 0;
+                    return;
+                }
+            }
+        }
+
+        self.output = lerp(self.last_frame, self.next_frame, self.phase);
+        if sample_rate > 0. {
+            self.phase += sample.info.sample_rate / sample_rate;
+        } else {
+            self.phase += 1.;
+        }
+    }
+
+    /// Gives the voice's stream back. If the sample it was streaming from has been replaced, the
+    /// stream was already given back when it was removed, and the voice just forgets about it.
+    pub unsafe fn release(&mut self, samples: *const *const Sample) {
+        if self.stream != 0 {
+            if let Some(sample) = get_slot_sample(samples, self.slot) {
+                if sample.id as u64 == self.sample_id {
+                    sample
+                        .get_stream(self.stream)
+                        .state
+                        .store(STREAM_RELEASED, Ordering::Release);
+                }
+            }
+        }
+        self.stream = 0;
+    }
+}
+
+/// A background thread that streams samples from disk into the buffers of voices playing them.
+#[derive(Debug)]
+pub struct SampleStreamer {
+    samples: Arc<Mutex<Vec<Arc<Sample>>>>,
+    streams: Option<Arc<SampleStreams>>,
+    shutdown: Arc<AtomicBool>,
+    thread: Option<thread::JoinHandle<()>>,
+}
+
+impl SampleStreamer {
+    pub fn new() -> Self {
+        SampleStreamer {
+            samples: Arc::new(Mutex::new(Vec::new())),
+            streams: None,
+            shutdown: Arc::new(AtomicBool::new(false)),
+            thread: None,
+        }
+    }
+
+    /// Takes a sample so it can be played, streaming it if it doesn't fit in its preloaded
+    /// frames. The streams and the thread are only created once the first such sample is added.
+    pub fn add_sample(&mut self, mut sample: Box<Sample>) -> Arc<Sample> {
+        if !sample.needs_streaming() {
+            return Arc::new(*sample);
+        }
+
+        if self.streams.is_none() {
+            let streams = Arc::new(SampleStreams::new());
+            let samples = self.samples.clone();
+            let thread_streams = streams.clone();
+            let shutdown = self.shutdown.clone();
+            self.streams = Some(streams);
+            self.thread = Some(
+                thread::Builder::new()
+                    .name("maxim sample streamer".to_string())
+                    .spawn(move || SampleStreamer::run(&samples, &thread_streams, &shutdown))
+                    .unwrap(),
+            );
+        }
+
+        sample.streams = self.streams.clone();
+        let sample = Arc::new(*sample);
+        self.samples.lock().unwrap().push(sample.clone());
+        sample
+    }
+
+    /// Stops streaming a sample, giving back any streams voices were playing it from. No voice
+    /// can be reading the sample while this happens.
+    pub fn remove_sample(&mut self, sample: &Arc<Sample>) {
+        if let Some(ref streams) = sample.streams {
+            streams.release_sample(sample.id);
+        }
+        self.samples
+            .lock()
+            .unwrap()
+            .retain(|other| !Arc::ptr_eq(other, sample));
+    }
+
+    fn run(samples: &Mutex<Vec<Arc<Sample>>>, streams: &SampleStreams, shutdown: &AtomicBool) {
+        let mut read_buffer = Vec::new();
+        while !shutdown.load(Ordering::Relaxed) {
+            // don't hold the lock while reading, so samples can be added or removed meanwhile
+            let current_samples = samples.lock().unwrap().clone();
+            for stream in &streams.streams {
+                stream.prefetch(&current_samples, &mut read_buffer);
+            }
+            thread::sleep(PREFETCH_INTERVAL);
+        }
+    }
+}
+
+impl Drop for SampleStreamer {
+    fn drop(&mut self) {
+        self.shutdown.store(true, Ordering::Relaxed);
+        if let Some(thread) = self.thread.take() {
+            thread.join().unwrap();
+        }
+    }
+}
@@ -0,0 +1,206 @@
+use mir::SurfaceRef;
+use std::collections::HashMap;
+use std::os::raw::c_void;
+use std::sync::atomic::{self, AtomicBool, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread;
+use std::time::Duration;
+
+/// Runs a single task from a surface's task dispatcher, given the surface's pointers and the
+/// index of the task.
+pub type TaskDispatcher = unsafe extern "C" fn(*mut c_void, u32);
+
+// The claim word packs the index of the next task to hand out, the number of tasks in the current
+// job and a generation counter that changes for every job, so workers that read the word for an
+// old job can't claim a task from a new one.
+const CLAIM_INDEX_BITS: usize = 8;
+const CLAIM_COUNT_BITS: usize = 8;
+const CLAIM_INDEX_MASK: usize = (1 << CLAIM_INDEX_BITS) - 1;
+const CLAIM_COUNT_MASK: usize = (1 << CLAIM_COUNT_BITS) - 1;
+const CLAIM_GENERATION_SHIFT: usize = CLAIM_INDEX_BITS + CLAIM_COUNT_BITS;
+
+// Idle workers spin for a while before backing off, so they're still awake when the next job comes
+// in a sample later, but don't burn a core when nothing is running.
+const SPIN_ITERATIONS: u32 = 1 << 14;
+const YIELD_ITERATIONS: u32 = 1 << 16;
+const IDLE_SLEEP: Duration = Duration::from_millis(1);
+
+#[derive(Debug)]
+struct SharedState {
+    claim: AtomicUsize,
+    finished: AtomicUsize,
+    dispatcher: AtomicUsize,
+    context: AtomicUsize,
+    first_task: AtomicUsize,
+    shutdown: AtomicBool,
+}
+
+impl SharedState {
+    // Claims the next task of the current job if there's one left, returning its index.
+    fn try_claim(&self) -> Option<usize> {
+        let mut word = self.claim.load(Ordering::Acquire);
+        loop {
+            let index = word & CLAIM_INDEX_MASK;
+            let count = (word >> CLAIM_INDEX_BITS) & CLAIM_COUNT_MASK;
+            if index >= count {
+                return None;
+            }
+
+            match self.claim.compare_exchange_weak(
+                word,
+                word + 1,
+                Ordering::Acquire,
+                Ordering::Acquire,
+            ) {
+                Ok(_) => return Some(index),
+                Err(new_word) => word = new_word,
+            }
+        }
+    }
+
+    unsafe fn run_claimed(&self, index: usize) {
+        let dispatcher: TaskDispatcher =
+            ::std::mem::transmute(self.dispatcher.load(Ordering::Relaxed));
+        let context = self.context.load(Ordering::Relaxed) as *mut c_void;
+        let task = self.first_task.load(Ordering::Relaxed) + index;
+        dispatcher(context, task as u32);
+        self.finished.fetch_add(1, Ordering::Release);
+    }
+}
+
+/// A fixed set of threads that run the tasks of parallel surface stages.
+///
+/// Submitting a job never allocates, locks or waits on a thread that might be asleep: the calling
+/// thread claims tasks alongside the workers, and only spins for tasks that another thread has
+/// already started. Only one job can run at a time, so a job submitted while another is running
+/// (e.g from a task of a group surface that is also parallel) is just run on the calling thread.
+#[derive(Debug)]
+pub struct WorkerPool {
+    state: Arc<SharedState>,
+    busy: AtomicBool,
+    workers: Vec<thread::JoinHandle<()>>,
+    dispatchers: HashMap<SurfaceRef, TaskDispatcher>,
+}
+
+impl WorkerPool {
+    pub fn new(thread_count: usize) -> Self {
+        let state = Arc::new(SharedState {
+            claim: AtomicUsize::new(0),
+            finished: AtomicUsize::new(0),
+            dispatcher: AtomicUsize::new(0),
+            context: AtomicUsize::new(0),
+            first_task: AtomicUsize::new(0),
+            shutdown: AtomicBool::new(false),
+        });
+        let workers = (0..thread_count)
+            .map(|index| {
+                let worker_state = state.clone();
+                thread::Builder::new()
+                    .name(format!("maxim worker {}", index))
+                    .spawn(move || WorkerPool::run_worker(&worker_state))
+                    .unwrap()
+            }).collect();
+
+        WorkerPool {
+            state,
+            busy: AtomicBool::new(false),
+            workers,
+            dispatchers: HashMap::new(),
+        }
+    }
+
+    pub fn thread_count(&self) -> usize {
+        self.workers.len()
+    }
+
+    pub fn set_dispatcher(&mut self, surface: SurfaceRef, dispatcher: Option<TaskDispatcher>) {
+        match dispatcher {
+            Some(dispatcher) => self.dispatchers.insert(surface, dispatcher),
+            None => self.dispatchers.remove(&surface),
+        };
+    }
+
+    fn run_worker(state: &SharedState) {
+        let mut idle_iterations = 0;
+        while !state.shutdown.load(Ordering::Relaxed) {
+            if let Some(index) = state.try_claim() {
+                unsafe {
+                    state.run_claimed(index);
+                }
+                idle_iterations = 0;
+                continue;
+            }
+
+            idle_iterations = idle_iterations.saturating_add(1);
+            if idle_iterations < SPIN_ITERATIONS {
+                atomic::spin_loop_hint();
+            } else if idle_iterations < YIELD_ITERATIONS {
+                thread::yield_now();
+            } else {
+                thread::sleep(IDLE_SLEEP);
+            }
+        }
+    }
+
+    /// Runs tasks `first_task..first_task + task_count` from a surface's dispatcher, returning once
+    /// all of them have finished.
+    pub unsafe fn run_tasks(
+        &self,
+        surface: SurfaceRef,
+        first_task: u32,
+        task_count: u32,
+        context: *mut c_void,
+    ) {
+        let dispatcher = match self.dispatchers.get(&surface) {
+            Some(&dispatcher) => dispatcher,
+            None => return,
+        };
+        let task_count = task_count as usize;
+
+        if task_count <= 1
+            || task_count > CLAIM_COUNT_MASK
+            || self.workers.is_empty()
+            || self.busy.swap(true, Ordering::Acquire)
+        {
+            for task in 0..task_count {
+                dispatcher(context, first_task + task as u32);
+            }
+            return;
+        }
+
+        let state = &*self.state;
+        state
+            .dispatcher
+            .store(dispatcher as usize, Ordering::Relaxed);
+        state.context.store(context as usize, Ordering::Relaxed);
+        state
+            .first_task
+            .store(first_task as usize, Ordering::Relaxed);
+        state.finished.store(0, Ordering::Relaxed);
+
+        let generation =
+            (state.claim.load(Ordering::Relaxed) >> CLAIM_GENERATION_SHIFT).wrapping_add(1);
+        state.claim.store(
+            generation << CLAIM_GENERATION_SHIFT | task_count << CLAIM_INDEX_BITS,
+            Ordering::Release,
+        );
+
+        while let Some(index) = state.try_claim() {
+            state.run_claimed(index);
+        }
+        while state.finished.load(Ordering::Acquire) < task_count {
+            atomic::spin_loop_hint();
+        }
+
+        self.busy.store(false, Ordering::Release);
+    }
+}
+
+impl Drop for WorkerPool {
+    fn drop(&mut self) {
+        self.state.shutdown.store(true, Ordering::Relaxed);
+        for worker in self.workers.drain(..) {
+            worker.join().unwrap();
+        }
+    }
+}
@@ -1,6 +1,6 @@
 use ast::ControlType;
 
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, PartialEq, Eq)]
 pub struct Control {
     pub name: String,
     pub control_type: ControlType,
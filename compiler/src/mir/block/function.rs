@@ -22,7 +22,7 @@ macro_rules! func {
 
 macro_rules! define_functions {
     ($($enum_name:ident = $str_name:tt $data:expr ),*) => (
-        #[derive(Debug, Clone, Copy)]
+        #[derive(Debug, Clone, Copy, PartialEq, Eq)]
         pub enum Function {
             $( $enum_name, )*
         }
@@ -51,7 +51,7 @@ macro_rules! define_functions {
             }
         }
 
-        pub const FUNCTION_TABLE: [&str; 51] = [$($str_name, )*];
+        pub const FUNCTION_TABLE: [&str; 59] = [$($str_name, )*];
     );
 }
 
@@ -84,8 +84,11 @@ define_functions! {
     Sequence = "sequence" func![(Num => Num) -> Num],
     Min = "min" func![(Num, Num) -> Num],
     Max = "max" func![(Num, Num) -> Num],
+    Table = "table" func![(Num, Num, Num, Num) -> Num],
     Next = "next" func![(Num) -> Num],
     Delay = "delay" func![(Num, Num, ?Num) -> Num],
+    Convolve = "convolve" func![(Num, Num) -> Num],
+    Sampler = "sampler" func![(Num, Num) -> Num],
     Amplitude = "amplitude" func![(Num) -> Num],
     Hold = "hold" func![(Num, Num, ?Num) -> Num],
     Accum = "accum" func![(Num, Num, ?Num) -> Num],
@@ -103,6 +106,11 @@ define_functions! {
     SawOsc = "sawOsc" func![(Num, ?Num) -> Num],
     TriOsc = "triOsc" func![(Num, ?Num) -> Num],
     RmpOsc = "rmpOsc" func![(Num, ?Num) -> Num],
+    SinTblOsc = "sinTblOsc" func![(Num, ?Num) -> Num],
+    SqrTblOsc = "sqrTblOsc" func![(Num, ?Num, ?Num) -> Num],
+    SawTblOsc = "sawTblOsc" func![(Num, ?Num) -> Num],
+    TriTblOsc = "triTblOsc" func![(Num, ?Num) -> Num],
+    RmpTblOsc = "rmpTblOsc" func![(Num, ?Num) -> Num],
     Note = "note" func![(Midi) -> Tuple(vec![Num, Num, Num, Num])],
     Voices = "voices" func![(Midi, VarType::new_array(Num)) -> VarType::new_array(Midi)],
     Channel = "channel" func![(Midi, Num) -> Midi],
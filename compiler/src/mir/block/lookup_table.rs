@@ -0,0 +1,15 @@
+use ast::FormType;
+use mir::ConstantNum;
+
+/// The values of an expression of one input at evenly spaced points from `lo` to `hi`, which
+/// `table` calls are replaced with. Each channel of the input is swept over its own range, and is
+/// looked up in the same channel of the values.
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+pub struct LookupTable {
+    pub lo: ConstantNum,
+    pub hi: ConstantNum,
+
+    /// The form of the result, or `None` if it has the form of the input.
+    pub form: Option<FormType>,
+    pub values: Vec<ConstantNum>,
+}
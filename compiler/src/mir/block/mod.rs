@@ -2,10 +2,12 @@ use mir::pool_id::{PoolId, PoolRef};
 
 mod control;
 mod function;
+mod lookup_table;
 mod statement;
 
 pub use self::control::Control;
 pub use self::function::{Function, FunctionArgRange, FUNCTION_TABLE};
+pub use self::lookup_table::LookupTable;
 pub use self::statement::{Global, Statement};
 
 pub type BlockRef = PoolRef;
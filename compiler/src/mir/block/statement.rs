@@ -1,14 +1,14 @@
 use ast::{ControlField, FormType, OperatorType, UnaryOperation};
-use mir::block::Function;
+use mir::block::{Function, LookupTable};
 use mir::{ConstantNum, ConstantTuple, ConstantValue};
 
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, PartialEq, Eq)]
 pub enum Global {
     SampleRate,
     BPM,
 }
 
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, PartialEq, Eq)]
 pub enum Statement {
     Constant(ConstantValue),
     Global(Global),
@@ -43,6 +43,10 @@ pub enum Statement {
         args: Vec<usize>,
         varargs: Vec<usize>,
     },
+    LookupTable {
+        input: usize,
+        table: LookupTable,
+    },
     StoreControl {
         control: usize,
         field: ControlField,
@@ -74,7 +78,8 @@ impl Statement {
             | Statement::Extract { .. }
             | Statement::Combine { .. }
             | Statement::LoadControl { .. }
-            | Statement::CallFunc { .. } => false,
+            | Statement::CallFunc { .. }
+            | Statement::LookupTable { .. } => false,
             Statement::StoreControl { .. } => true,
         }
     }
@@ -5,6 +5,10 @@ pub enum ValueGroupSource {
     None,
     Socket(usize),
     Default(ConstantValue),
+
+    /// Like `Default`, but the value is never changed while the surface is running (not even from
+    /// the UI), so nodes reading it can be specialized on the constant.
+    Fixed(ConstantValue),
 }
 
 #[derive(Debug, PartialEq, Eq, Clone)]
@@ -55,6 +55,7 @@ impl VarType {
                     .collect(),
             ),
             Statement::CallFunc { ref function, .. } => VarType::of_function(function),
+            Statement::LookupTable { .. } => VarType::Num,
             Statement::StoreControl { ref field, .. } => VarType::of_control_field(field),
             Statement::LoadControl { ref field, .. } => VarType::of_control_field(field),
         }
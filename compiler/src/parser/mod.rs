@@ -103,7 +103,7 @@ impl Parser {
             ..
         } = Parser::expect_token(TokenType::Identifier, stream.next())?;
 
-        let form_type = match form_name.as_ref() {
+        let form_type = match form_name {
             "none" => FormType::None,
             "control" => FormType::Control,
             "osc" => FormType::Oscillator,
@@ -115,7 +115,7 @@ impl Parser {
             "db" => FormType::Db,
             "amp" => FormType::Amplitude,
             "q" => FormType::Q,
-            _ => return Err(CompileError::unknown_form(form_name, name_pos)),
+            _ => return Err(CompileError::unknown_form(form_name.to_string(), name_pos)),
         };
 
         let end_pos = Parser::expect_token(TokenType::CloseSquare, stream.next())?
@@ -150,7 +150,7 @@ impl Parser {
                 content,
                 pos,
                 ..
-            }) => Parser::parse_control_expr(stream, content, pos.0),
+            }) => Parser::parse_control_expr(stream, content.to_string(), pos.0),
             Some(Token {
                 token_type: TokenType::Identifier,
                 ..
@@ -260,7 +260,7 @@ impl Parser {
         }
 
         let note_token = Parser::expect_token(TokenType::Note, stream.next())?;
-        let captures = NOTE_REGEX.captures(&note_token.content).unwrap();
+        let captures = NOTE_REGEX.captures(note_token.content).unwrap();
         let note_name = captures[1].to_uppercase();
         let note_num = match NOTE_NAMES.iter().position(|&s| s == note_name) {
             Some(index) => index,
@@ -381,15 +381,15 @@ impl Parser {
                 token_type: TokenType::OpenBracket,
                 pos,
                 ..
-            }) => Parser::parse_call_expr(stream, identifier_token.content, pos.0),
+            }) => Parser::parse_call_expr(stream, identifier_token.content.to_string(), pos.0),
             Some(Token {
                 token_type: TokenType::Colon,
                 pos,
                 ..
-            }) => Parser::parse_control_expr(stream, identifier_token.content, pos.0),
+            }) => Parser::parse_control_expr(stream, identifier_token.content.to_string(), pos.0),
             _ => Ok(Expression::new_variable(
                 identifier_token.pos,
-                identifier_token.content,
+                identifier_token.content.to_string(),
             )),
         }
     }
@@ -446,7 +446,7 @@ impl Parser {
         Parser::expect_token(TokenType::Colon, stream.next())?;
 
         let type_token = Parser::expect_token(TokenType::Identifier, stream.next())?;
-        let control_type = match type_token.content.as_ref() {
+        let control_type = match type_token.content {
             "num" => ControlType::Audio,
             "graph" => ControlType::Graph,
             "midi" => ControlType::Midi,
@@ -456,7 +456,7 @@ impl Parser {
             "midi[]" => ControlType::MidiExtract,
             _ => {
                 return Err(CompileError::unknown_control(
-                    type_token.content,
+                    type_token.content.to_string(),
                     type_token.pos,
                 ))
             }
@@ -475,10 +475,10 @@ impl Parser {
                     Parser::expect_token(TokenType::Identifier, stream.next())?;
                 (content, pos)
             }
-            _ => ("value".to_string(), type_token.pos),
+            _ => ("value", type_token.pos),
         };
 
-        let control_field = match prop_name.as_ref() {
+        let control_field = match prop_name {
             "value" if control_type == ControlType::Audio => ControlField::Audio(AudioField::Value),
             "value" if control_type == ControlType::Graph => ControlField::Graph(GraphField::Value),
             "state" if control_type == ControlType::Graph => ControlField::Graph(GraphField::State),
@@ -498,7 +498,7 @@ impl Parser {
             _ => {
                 return Err(CompileError::unknown_field(
                     control_type,
-                    prop_name,
+                    prop_name.to_string(),
                     prop_pos,
                 ))
             }
@@ -59,19 +59,25 @@ pub enum TokenType {
     Unknown,
 }
 
-#[derive(Debug, PartialEq, Eq, Clone)]
-pub struct Token {
+#[derive(Debug, PartialEq, Eq, Clone, Copy)]
+pub struct Token<'a> {
     pub pos: SourceRange,
     pub token_type: TokenType,
-    pub content: String,
+    pub content: &'a str,
 }
 
-impl Token {
-    pub fn new(pos: SourceRange, token_type: TokenType, content: String) -> Token {
+impl<'a> Token<'a> {
+    pub fn new(pos: SourceRange, token_type: TokenType, content: &'a str) -> Token<'a> {
         Token {
             pos,
             token_type,
             content,
         }
     }
+
+    // Drops the content borrowed from the source, so the token can be kept around (e.g. in an
+    // error) after the source is gone.
+    pub fn detach(&self) -> Token<'static> {
+        Token::new(self.pos, self.token_type, "")
+    }
 }
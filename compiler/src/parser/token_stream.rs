@@ -1,78 +1,155 @@
 use ast::{SourcePos, SourceRange};
 use parser::{Token, TokenType};
-use regex::Regex;
 use std::iter::Peekable;
 
-type TokenMatcher = (Regex, TokenType);
-
-lazy_static! {
-    static ref PAIR_MATCHES: [TokenMatcher; 48] = [
-        // multi-char tokens
-        get_matcher(r"\.\.\.", TokenType::Ellipsis),
-        get_matcher(r"==", TokenType::EqualTo),
-        get_matcher(r"!=", TokenType::NotEqualTo),
-        get_matcher(r"<=", TokenType::Lte),
-        get_matcher(r">=", TokenType::Gte),
-        get_matcher(r"\+=", TokenType::PlusAssign),
-        get_matcher(r"-=", TokenType::MinusAssign),
-        get_matcher(r"\*=", TokenType::TimesAssign),
-        get_matcher(r"/=", TokenType::DivideAssign),
-        get_matcher(r"%=", TokenType::ModuloAssign),
-        get_matcher(r"\^=", TokenType::PowerAssign),
-        get_matcher(r"->", TokenType::Cast),
-        get_matcher(r"\+\+", TokenType::Increment),
-        get_matcher(r"--", TokenType::Decrement),
-        get_matcher(r"\^\^", TokenType::BitwiseXor),
-        get_matcher(r"&&", TokenType::LogicalAnd),
-        get_matcher(r"\|\|", TokenType::LogicalOr),
-        get_matcher(r"/\*", TokenType::CommentOpen),
-        get_matcher(r"\*/", TokenType::CommentClose),
-
-        // free tokens
-        get_matcher(r"'((?:[^'\\]|\\.)*)'", TokenType::SingleString),
-        get_matcher(r#""((?:[^"\\]|\\.)*)""#, TokenType::DoubleString),
-        get_matcher(r"([0-9]*\.?[0-9]+(?:[eE][-+]?[0-9]+)?)", TokenType::Number),
-        get_matcher(r":([a-gA-G]#?[0-9]+)", TokenType::Note),
-        get_matcher(r"([_a-zA-Z][_a-zA-Z0-9]*(?:\[\])?)", TokenType::Identifier),
-
-        // single-char tokens
-        get_matcher(r"\+", TokenType::Plus),
-        get_matcher(r"-", TokenType::Minus),
-        get_matcher(r"\*", TokenType::Times),
-        get_matcher(r"/", TokenType::Divide),
-        get_matcher(r"%", TokenType::Modulo),
-        get_matcher(r"\^", TokenType::Power),
-        get_matcher(r"=", TokenType::Assign),
-        get_matcher(r"!", TokenType::Not),
-        get_matcher(r"\(", TokenType::OpenBracket),
-        get_matcher(r"\)", TokenType::CloseBracket),
-        get_matcher(r"\[", TokenType::OpenSquare),
-        get_matcher(r"\]", TokenType::CloseSquare),
-        get_matcher(r"\{", TokenType::OpenCurly),
-        get_matcher(r"\}", TokenType::CloseCurly),
-        get_matcher(r",", TokenType::Comma),
-        get_matcher(r";", TokenType::Semicolon),
-        get_matcher(r"\.", TokenType::Dot),
-        get_matcher(r":", TokenType::Colon),
-        get_matcher(r"#", TokenType::Hash),
-        get_matcher(r">", TokenType::Gt),
-        get_matcher(r"<", TokenType::Lt),
-        get_matcher(r"&", TokenType::BitwiseAnd),
-        get_matcher(r"\|", TokenType::BitwiseOr),
-
-        get_matcher("\n", TokenType::EndOfLine)
-    ];
+// Operators longer than one character. These are checked before anything else so e.g. `+=` isn't
+// lexed as `+` followed by `=`.
+const MULTI_CHAR_TOKENS: [(&str, TokenType); 19] = [
+    ("...", TokenType::Ellipsis),
+    ("==", TokenType::EqualTo),
+    ("!=", TokenType::NotEqualTo),
+    ("<=", TokenType::Lte),
+    (">=", TokenType::Gte),
+    ("+=", TokenType::PlusAssign),
+    ("-=", TokenType::MinusAssign),
+    ("*=", TokenType::TimesAssign),
+    ("/=", TokenType::DivideAssign),
+    ("%=", TokenType::ModuloAssign),
+    ("^=", TokenType::PowerAssign),
+    ("->", TokenType::Cast),
+    ("++", TokenType::Increment),
+    ("--", TokenType::Decrement),
+    ("^^", TokenType::BitwiseXor),
+    ("&&", TokenType::LogicalAnd),
+    ("||", TokenType::LogicalOr),
+    ("/*", TokenType::CommentOpen),
+    ("*/", TokenType::CommentClose),
+];
+
+fn single_char_token(c: u8) -> Option<TokenType> {
+    match c {
+        b'+' => Some(TokenType::Plus),
+        b'-' => Some(TokenType::Minus),
+        b'*' => Some(TokenType::Times),
+        b'/' => Some(TokenType::Divide),
+        b'%' => Some(TokenType::Modulo),
+        b'^' => Some(TokenType::Power),
+        b'=' => Some(TokenType::Assign),
+        b'!' => Some(TokenType::Not),
+        b'(' => Some(TokenType::OpenBracket),
+        b')' => Some(TokenType::CloseBracket),
+        b'[' => Some(TokenType::OpenSquare),
+        b']' => Some(TokenType::CloseSquare),
+        b'{' => Some(TokenType::OpenCurly),
+        b'}' => Some(TokenType::CloseCurly),
+        b',' => Some(TokenType::Comma),
+        b';' => Some(TokenType::Semicolon),
+        b'.' => Some(TokenType::Dot),
+        b':' => Some(TokenType::Colon),
+        b'#' => Some(TokenType::Hash),
+        b'>' => Some(TokenType::Gt),
+        b'<' => Some(TokenType::Lt),
+        b'&' => Some(TokenType::BitwiseAnd),
+        b'|' => Some(TokenType::BitwiseOr),
+        b'\n' => Some(TokenType::EndOfLine),
+        _ => None,
+    }
+}
+
+fn is_identifier_start(c: u8) -> bool {
+    c == b'_' || c.is_ascii_alphabetic()
+}
+
+fn is_identifier_continue(c: u8) -> bool {
+    c == b'_' || c.is_ascii_alphanumeric()
+}
+
+fn skip_digits(bytes: &[u8], mut index: usize) -> usize {
+    while index < bytes.len() && bytes[index].is_ascii_digit() {
+        index += 1;
+    }
+    index
 }
 
-fn get_matcher(regex: &str, token_type: TokenType) -> TokenMatcher {
-    let regex_str = format!(r"^[^\S\n]*{}[^\S\n]*", regex);
-    (Regex::new(&regex_str).unwrap(), token_type)
+// Matches `'...'` or `"..."` starting at `start`, where a backslash escapes the next character.
+// Returns the index after the closing quote.
+fn match_string(bytes: &[u8], start: usize) -> Option<usize> {
+    let quote = bytes[start];
+    let mut index = start + 1;
+    while index < bytes.len() {
+        match bytes[index] {
+            c if c == quote => return Some(index + 1),
+            b'\\' if index + 1 < bytes.len() && bytes[index + 1] != b'\n' => index += 2,
+            b'\\' => return None,
+            _ => index += 1,
+        }
+    }
+    None
 }
 
-struct TokenIterator<'a> {
+// Matches numbers like `1`, `1.5`, `.5` and `1.5e-3`. Returns the index after the number.
+fn match_number(bytes: &[u8], start: usize) -> Option<usize> {
+    let int_end = skip_digits(bytes, start);
+    let mut end = if int_end < bytes.len() && bytes[int_end] == b'.' {
+        let frac_end = skip_digits(bytes, int_end + 1);
+        if frac_end > int_end + 1 {
+            frac_end
+        } else {
+            // a dot without digits after it isn't part of the number
+            int_end
+        }
+    } else {
+        int_end
+    };
+    if end == start {
+        return None;
+    }
+
+    if end < bytes.len() && (bytes[end] == b'e' || bytes[end] == b'E') {
+        let mut exp_start = end + 1;
+        if exp_start < bytes.len() && (bytes[exp_start] == b'-' || bytes[exp_start] == b'+') {
+            exp_start += 1;
+        }
+        let exp_end = skip_digits(bytes, exp_start);
+        if exp_end > exp_start {
+            end = exp_end;
+        }
+    }
+
+    Some(end)
+}
+
+// Matches the note name after a colon, like `c4` or `F#2`. Returns the index after the note.
+fn match_note(bytes: &[u8], start: usize) -> Option<usize> {
+    if start >= bytes.len() {
+        return None;
+    }
+    match bytes[start] {
+        b'a'..=b'g' | b'A'..=b'G' => {}
+        _ => return None,
+    }
+
+    let mut index = start + 1;
+    if index < bytes.len() && bytes[index] == b'#' {
+        index += 1;
+    }
+    let end = skip_digits(bytes, index);
+    if end > index {
+        Some(end)
+    } else {
+        None
+    }
+}
+
+// Lexes the source in a single pass, yielding tokens that borrow their content from the source.
+// Whitespace around a token (apart from newlines, which are tokens themselves) is included in its
+// range. Comments are skipped here as well.
+pub struct TokenIterator<'a> {
     data: &'a str,
     cursor: usize,
     current_pos: SourcePos,
+    in_single_comment: bool,
+    multi_comment_depth: usize,
 }
 
 impl<'a> TokenIterator<'a> {
@@ -81,93 +158,144 @@ impl<'a> TokenIterator<'a> {
             data,
             cursor: 0,
             current_pos: SourcePos { line: 0, column: 0 },
+            in_single_comment: false,
+            multi_comment_depth: 0,
         }
     }
-}
 
-impl<'a> Iterator for TokenIterator<'a> {
-    type Item = Token;
+    fn skip_whitespace(&self, start: usize) -> usize {
+        let mut index = start;
+        for c in self.data[start..].chars() {
+            if c == '\n' || !c.is_whitespace() {
+                break;
+            }
+            index += c.len_utf8();
+        }
+        index
+    }
+
+    // Finds the token at `start`, returning its type, the index after it, and its content.
+    fn match_token(&self, start: usize) -> Option<(TokenType, usize, &'a str)> {
+        let data = self.data;
+        let bytes = data.as_bytes();
+        let first = *bytes.get(start)?;
+
+        for &(text, token_type) in MULTI_CHAR_TOKENS.iter() {
+            if bytes[start..].starts_with(text.as_bytes()) {
+                return Some((token_type, start + text.len(), ""));
+            }
+        }
+
+        if first == b'\'' || first == b'"' {
+            if let Some(end) = match_string(bytes, start) {
+                let token_type = if first == b'\'' {
+                    TokenType::SingleString
+                } else {
+                    TokenType::DoubleString
+                };
+                return Some((token_type, end, &data[start + 1..end - 1]));
+            }
+        }
+
+        if let Some(end) = match_number(bytes, start) {
+            return Some((TokenType::Number, end, &data[start..end]));
+        }
 
-    fn next(&mut self) -> Option<Token> {
+        if first == b':' {
+            if let Some(end) = match_note(bytes, start + 1) {
+                return Some((TokenType::Note, end, &data[start + 1..end]));
+            }
+        }
+
+        if is_identifier_start(first) {
+            let mut end = start + 1;
+            while end < bytes.len() && is_identifier_continue(bytes[end]) {
+                end += 1;
+            }
+            if bytes[end..].starts_with(b"[]") {
+                end += 2;
+            }
+            return Some((TokenType::Identifier, end, &data[start..end]));
+        }
+
+        single_char_token(first).map(|token_type| (token_type, start + 1, ""))
+    }
+
+    fn next_raw(&mut self) -> Option<Token<'a>> {
         if self.cursor >= self.data.len() {
             return None;
         }
 
         let token_start = self.current_pos;
-        let remaining_data = &self.data[self.cursor..];
-
-        let matched_pair = PAIR_MATCHES
-            .iter()
-            .filter_map(|matcher| {
-                let maybe_caps = matcher.0.captures(remaining_data);
-                match maybe_caps {
-                    Some(caps) => Some((matcher.1, caps)),
-                    None => None,
-                }
-            }).next();
-
-        let token = match matched_pair {
-            Some((token_type, captures)) => {
-                let capture_length = captures[0].len();
+        let match_start = self.skip_whitespace(self.cursor);
+
+        match self.match_token(match_start) {
+            Some((token_type, match_end, content)) => {
+                let token_end_index = self.skip_whitespace(match_end);
                 let token_end = if token_type == TokenType::EndOfLine {
+                    // whitespace after a newline is the indentation of the next line
                     SourcePos {
                         line: self.current_pos.line + 1,
-                        column: 0,
+                        column: (token_end_index - match_end) as isize,
                     }
                 } else {
                     SourcePos {
                         line: self.current_pos.line,
-                        column: self.current_pos.column + capture_length as isize,
+                        column: self.current_pos.column + (token_end_index - self.cursor) as isize,
                     }
                 };
-                let token_content = if captures.len() > 1 { &captures[1] } else { "" };
 
-                self.cursor += capture_length;
+                self.cursor = token_end_index;
                 self.current_pos = token_end;
-                Token::new(
+                Some(Token::new(
                     SourceRange(token_start, token_end),
                     token_type,
-                    token_content.to_string(),
-                )
+                    content,
+                ))
             }
             None => {
                 // move cursor to end so the next iteration returns None
                 self.cursor = self.data.len();
 
-                Token::new(
+                Some(Token::new(
                     SourceRange(token_start, token_start),
                     TokenType::Unknown,
-                    "".to_string(),
-                )
+                    "",
+                ))
             }
-        };
-        Some(token)
+        }
     }
 }
 
-pub type TokenStream<'a> = Peekable<Box<Iterator<Item = Token> + 'a>>;
+impl<'a> Iterator for TokenIterator<'a> {
+    type Item = Token<'a>;
 
-pub fn get_token_stream<'a>(data: &'a str) -> TokenStream<'a> {
-    let mut in_single_comment = false;
-    let mut multi_comment_depth = 0;
+    fn next(&mut self) -> Option<Token<'a>> {
+        loop {
+            let token = self.next_raw()?;
 
-    let boxed: Box<Iterator<Item = Token>> =
-        Box::new(TokenIterator::<'a>::new(data).filter(move |token| {
             match token.token_type {
-                TokenType::Hash => in_single_comment = true,
-                TokenType::EndOfLine => in_single_comment = false,
-                TokenType::CommentOpen => multi_comment_depth += 1,
+                TokenType::Hash => self.in_single_comment = true,
+                TokenType::EndOfLine => self.in_single_comment = false,
+                TokenType::CommentOpen => self.multi_comment_depth += 1,
                 _ => {}
             }
 
-            let is_valid = !in_single_comment && multi_comment_depth == 0;
+            let is_valid = !self.in_single_comment && self.multi_comment_depth == 0;
 
-            if token.token_type == TokenType::CommentClose && multi_comment_depth > 0 {
-                multi_comment_depth -= 1;
+            if token.token_type == TokenType::CommentClose && self.multi_comment_depth > 0 {
+                self.multi_comment_depth -= 1;
             }
 
-            is_valid
-        }));
+            if is_valid {
+                return Some(token);
+            }
+        }
+    }
+}
+
+pub type TokenStream<'a> = Peekable<TokenIterator<'a>>;
 
-    boxed.peekable()
+pub fn get_token_stream<'a>(data: &'a str) -> TokenStream<'a> {
+    TokenIterator::new(data).peekable()
 }
@@ -143,7 +143,15 @@ impl<'a> GroupExtractor<'a> {
             } else {
                 false
             };
-            if is_source_or_destination || is_socket_source || !group_written {
+
+            // fixed groups can't be configured from the UI, so they stay inside each voice where
+            // nodes can be specialized on them
+            let is_fixed = if let mir::ValueGroupSource::Fixed(_) = parent_group.source {
+                true
+            } else {
+                false
+            };
+            if is_source_or_destination || is_socket_source || (!group_written && !is_fixed) {
                 let socket_index = new_sockets.len();
 
                 // if it's a source or destination group, we want the actual array item
@@ -2,7 +2,7 @@ use ast;
 use mir;
 use std::collections::HashMap;
 use std::f32::consts;
-use util::constant_propagate;
+use util::{constant_propagate, tabulate};
 use {CompileError, CompileResult};
 
 // lowers an AST into a Block MIR object
@@ -642,6 +642,10 @@ impl<'a> AstLower<'a> {
             }
         }
 
+        if function == mir::block::Function::Table {
+            return self.add_lookup_table(pos, &args);
+        }
+
         // if all arguments are constant, we can try to constant-fold
         // todo: might be good to only actually try this if we know the function can be constant
         // folded
@@ -672,6 +676,32 @@ impl<'a> AstLower<'a> {
         }))
     }
 
+    // Replaces a `table` call with a lookup into the values of the expression, if they can be
+    // worked out up front. Otherwise the expression is just used as it is.
+    fn add_lookup_table(&mut self, pos: &ast::SourceRange, args: &[usize]) -> LowerResult {
+        let expr = args[0];
+        let (lo, hi, size) = match (
+            self.get_constant(args[1]),
+            self.get_constant(args[2]),
+            self.get_constant(args[3]),
+        ) {
+            (
+                Some(mir::ConstantValue::Num(lo)),
+                Some(mir::ConstantValue::Num(hi)),
+                Some(mir::ConstantValue::Num(size)),
+            ) => (lo.clone(), hi.clone(), size.left as usize),
+            _ => return Ok(expr),
+        };
+
+        match tabulate::tabulate(&self.block.statements, expr, &lo, &hi, size, pos) {
+            Some(result) => {
+                let (input, table) = result?;
+                Ok(self.add_statement(mir::block::Statement::LookupTable { input, table }))
+            }
+            None => Ok(expr),
+        }
+    }
+
     fn add_store_control(
         &mut self,
         pos: &ast::SourceRange,
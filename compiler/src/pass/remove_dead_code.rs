@@ -90,6 +90,7 @@ impl<'a> DeadCodeRemover<'a> {
                 ref mut varargs,
                 ..
             } => args.iter_mut().chain(varargs.iter_mut()).collect(),
+            mir::block::Statement::LookupTable { ref mut input, .. } => vec![input],
             mir::block::Statement::StoreControl { ref mut value, .. } => vec![value],
         }
     }
@@ -165,7 +165,7 @@ pub fn const_call(
     match function {
         Function::Cos => Some(const_num_intrinsic(&args[0], range, &|f| f.cos())),
         Function::Sin => Some(const_num_intrinsic(&args[0], range, &|f| f.sin())),
-        Function::Log => Some(const_num_intrinsic(&args[0], range, &|f| f.log(consts::PI))),
+        Function::Log => Some(const_num_intrinsic(&args[0], range, &|f| f.ln())),
         Function::Log2 => Some(const_num_intrinsic(&args[0], range, &|f| f.log2())),
         Function::Log10 => Some(const_num_intrinsic(&args[0], range, &|f| f.log10())),
         Function::Sqrt => Some(const_num_intrinsic(&args[0], range, &|f| f.sqrt())),
@@ -1 +1,2 @@
 pub mod constant_propagate;
+pub mod tabulate;
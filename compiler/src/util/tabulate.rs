@@ -0,0 +1,190 @@
+use ast::{FormType, SourceRange};
+use mir::block::{Function, LookupTable, Statement};
+use mir::{ConstantNum, ConstantValue};
+use std::collections::HashMap;
+use util::constant_propagate;
+use CompileResult;
+
+/// The most values a table can hold, larger sizes are clamped to this.
+pub const MAX_TABLE_SIZE: usize = 65536;
+
+// Functions without state that `constant_propagate::const_call` can evaluate. Functions that
+// move values between channels (like `swap`) aren't included, as each channel of the input is
+// looked up separately.
+fn is_tabulable(function: Function) -> bool {
+    match function {
+        Function::Cos
+        | Function::Sin
+        | Function::Log
+        | Function::Log2
+        | Function::Log10
+        | Function::Sqrt
+        | Function::Ceil
+        | Function::Floor
+        | Function::Abs
+        | Function::Tan
+        | Function::Acos
+        | Function::Asin
+        | Function::Atan
+        | Function::Atan2
+        | Function::Hypot
+        | Function::ToRad
+        | Function::ToDeg
+        | Function::Clamp
+        | Function::Pan
+        | Function::Mix
+        | Function::Min
+        | Function::Max => true,
+        _ => false,
+    }
+}
+
+// Collects the statements that the expression at `index` is built from into `nodes`, and the one
+// statement it depends on that can't be evaluated up front into `input`. Returns false if there's
+// more than one of those.
+fn find_nodes(
+    statements: &[Statement],
+    index: usize,
+    input: &mut Option<usize>,
+    nodes: &mut Vec<usize>,
+) -> bool {
+    if nodes.contains(&index) {
+        return true;
+    }
+
+    let refs = match &statements[index] {
+        Statement::Constant(ConstantValue::Num(_)) => Vec::new(),
+        Statement::NumCast {
+            input: cast_input, ..
+        } => vec![*cast_input],
+        Statement::NumUnaryOp {
+            input: op_input, ..
+        } => vec![*op_input],
+        Statement::NumMathOp { lhs, rhs, .. } => vec![*lhs, *rhs],
+        Statement::CallFunc {
+            function,
+            args,
+            varargs,
+        } if is_tabulable(*function) => args.iter().chain(varargs.iter()).cloned().collect(),
+        _ => {
+            return match *input {
+                Some(existing_input) => existing_input == index,
+                None => {
+                    *input = Some(index);
+                    true
+                }
+            }
+        }
+    };
+
+    nodes.push(index);
+    refs.into_iter()
+        .all(|ref_index| find_nodes(statements, ref_index, input, nodes))
+}
+
+// Evaluates the expression made of `nodes` (which must be in order) with a value for its input.
+fn evaluate(
+    statements: &[Statement],
+    nodes: &[usize],
+    input: usize,
+    input_val: ConstantNum,
+    range: &SourceRange,
+) -> CompileResult<ConstantNum> {
+    let mut values = HashMap::with_capacity(nodes.len() + 1);
+    values.insert(input, input_val);
+    for &index in nodes {
+        let value = match &statements[index] {
+            Statement::Constant(ConstantValue::Num(num)) => num.clone(),
+            Statement::NumCast { target_form, input } => {
+                constant_propagate::const_cast(&values[input], *target_form)
+            }
+            Statement::NumUnaryOp { op, input } => {
+                constant_propagate::const_unary_op(&values[input], *op)
+            }
+            Statement::NumMathOp { op, lhs, rhs } => {
+                constant_propagate::const_math_op(&values[lhs], &values[rhs], *op)
+            }
+            Statement::CallFunc {
+                function,
+                args,
+                varargs,
+            } => {
+                let get_consts = |indexes: &[usize]| -> Vec<_> {
+                    indexes
+                        .iter()
+                        .map(|index| ConstantValue::Num(values[index].clone()))
+                        .collect()
+                };
+                let result = constant_propagate::const_call(
+                    function,
+                    &get_consts(args),
+                    &get_consts(varargs),
+                    range,
+                ).unwrap()?;
+                result.as_num().unwrap().clone()
+            }
+            _ => unreachable!(),
+        };
+        values.insert(index, value);
+    }
+
+    let result_index = nodes.last().cloned().unwrap_or(input);
+    Ok(values.remove(&result_index).unwrap())
+}
+
+/// Works out the table for a `table` call, by evaluating the expression at `expr` with its input
+/// swept from `lo` to `hi`. Returns the index of the input and the table, or `None` if the
+/// expression doesn't depend on exactly one statement or uses something that can't be evaluated
+/// up front (e.g a function with state), in which case it has to be run as it is.
+pub fn tabulate(
+    statements: &[Statement],
+    expr: usize,
+    lo: &ConstantNum,
+    hi: &ConstantNum,
+    size: usize,
+    range: &SourceRange,
+) -> Option<CompileResult<(usize, LookupTable)>> {
+    let mut input = None;
+    let mut nodes = Vec::new();
+    if !find_nodes(statements, expr, &mut input, &mut nodes) {
+        return None;
+    }
+    let input = input?;
+
+    // statements only ever refer to ones before them, so this puts every node after its inputs
+    nodes.sort();
+
+    let size = size.max(2).min(MAX_TABLE_SIZE);
+    let sweep = |lo: f32, hi: f32, index: usize| lo + (hi - lo) * index as f32 / (size - 1) as f32;
+    let sample = |index: usize, form: FormType| {
+        let input_val = ConstantNum::new(
+            sweep(lo.left, hi.left, index),
+            sweep(lo.right, hi.right, index),
+            form,
+        );
+        evaluate(statements, &nodes, input, input_val, range)
+    };
+
+    let values: CompileResult<Vec<_>> = (0..size)
+        .map(|index| sample(index, FormType::None))
+        .collect();
+    Some(values.and_then(|values| {
+        // if the form of the result changes with the form of the input, it's passed through from
+        // the input when looking up
+        let other_form = sample(0, FormType::Oscillator)?.form;
+        let form = if other_form == values[0].form {
+            Some(other_form)
+        } else {
+            None
+        };
+        Ok((
+            input,
+            LookupTable {
+                lo: lo.clone(),
+                hi: hi.clone(),
+                form,
+                values,
+            },
+        ))
+    }))
+}
@@ -55,8 +55,9 @@ QByteArray AudioBackend::serialize(std::optional<std::function<void(QDataStream
     QDataStream stream(&buffer, QIODevice::WriteOnly);
 
     auto project = _editor->window()->project();
-    AxiomModel::ProjectSerializer::serialize(project, stream,
-                                             [project](QDataStream &stream) { stream << project->linkedFile(); });
+    AxiomModel::ProjectSerializer::serialize(
+        project, stream, [project](QDataStream &stream) { stream << project->linkedFile(); },
+        maxSerializedHistoryBytes);
     if (serializeCustomCallback) {
         (*serializeCustomCallback)(stream);
     }
@@ -116,7 +117,12 @@ void AudioBackend::setBpm(float bpm) {
 }
 
 void AudioBackend::setSampleRate(float sampleRate) {
-    _editor->window()->runtime()->setSampleRate(sampleRate);
+    auto runtime = _editor->window()->runtime();
+    if (runtime->getSampleRate() == sampleRate) return;
+    runtime->setSampleRate(sampleRate);
+
+    // impulse responses are resampled to the runtime's rate when they're loaded
+    _editor->window()->project()->loadImpulseResponses();
 }
 
 void AudioBackend::queueMidiEvent(uint64_t deltaFrames, size_t portalId, AxiomBackend::MidiEvent event) {
@@ -48,6 +48,10 @@ namespace AxiomBackend {
         // Returns the main writable data path, guaranteed to exist.
         static std::string getDataPath();
 
+        // The most undo history to include when serializing for a DAW, in bytes. Hosts save state often and keep it
+        // in their own project files, so the full history would bloat them. Set to 0 to leave history out entirely.
+        size_t maxSerializedHistoryBytes = 1024 * 1024;
+
         // Serializes or deserializes the current open project. Use this for saving/loading the project from a DAW
         // project file.
         QByteArray serialize(std::optional<std::function<void(QDataStream &)>> serializeCustomCallback = std::nullopt);
@@ -0,0 +1,145 @@
+#include "ProjectExporter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
+#include <algorithm>
+
+#include "../model/objects/RootSurface.h"
+#include "interface/Runtime.h"
+
+using namespace MaximCompiler;
+
+static std::vector<const AxiomModel::RootSurfacePortal *> getSortedPortals(AxiomModel::RootSurface *rootSurface) {
+    std::vector<const AxiomModel::RootSurfacePortal *> portals;
+    for (const auto &portal : rootSurface->compileMeta()->portals) {
+        portals.push_back(&portal);
+    }
+
+    // portals are ordered by ID, the same as in the audio backend
+    std::sort(portals.begin(), portals.end(),
+              [](const AxiomModel::RootSurfacePortal *a, const AxiomModel::RootSurfacePortal *b) {
+                  return a->id < b->id;
+              });
+    return portals;
+}
+
+static QString toIdentifier(const QString &name) {
+    QString result;
+    for (const auto &c : name.toUpper()) {
+        if (c.isLetterOrNumber() && c.unicode() < 128) {
+            result.append(c);
+        } else if (!result.endsWith('_')) {
+            result.append('_');
+        }
+    }
+    if (result.isEmpty() || result[0].isDigit()) {
+        result.prepend('_');
+    }
+    return result;
+}
+
+static QString escapeString(const QString &str) {
+    QString result = str;
+    result.replace('\\', "\\\\").replace('"', "\\\"");
+    return result;
+}
+
+bool ProjectExporter::exportProject(MaximCompiler::Runtime *runtime, AxiomModel::RootSurface *rootSurface,
+                                    MaximCompiler::ProjectExporter::Profile profile, const QString &objectPath,
+                                    const QString &headerPath, QString *errorOut) {
+    assert(rootSurface->compileMeta());
+
+    std::vector<MaximFrontend::ExportPortal> exportPortals;
+    for (const auto &portal : getSortedPortals(rootSurface)) {
+        MaximFrontend::ExportPortalDirection direction;
+        switch (portal->portalType) {
+        case AxiomModel::PortalControl::PortalType::INPUT:
+            direction = MaximFrontend::ExportPortalDirection::INPUT;
+            break;
+        case AxiomModel::PortalControl::PortalType::OUTPUT:
+            direction = MaximFrontend::ExportPortalDirection::OUTPUT;
+            break;
+        case AxiomModel::PortalControl::PortalType::AUTOMATION:
+            direction = MaximFrontend::ExportPortalDirection::AUTOMATION;
+            break;
+        }
+        exportPortals.push_back({portal->socketIndex, direction});
+    }
+
+    MaximFrontend::ExportConfig config;
+    config.minSize = profile == Profile::SIZE;
+    config.sampleRate = runtime->getSampleRate();
+    config.bpm = runtime->getBpm();
+
+    // exported objects are run on other machines, so can't rely on the features of this one
+    config.isa = MaximFrontend::TargetIsa::BASELINE;
+
+    if (!runtime->exportObject(config, exportPortals, objectPath, errorOut)) {
+        return false;
+    }
+
+    QFile headerFile(headerPath);
+    if (!headerFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        *errorOut = "The header file couldn't be opened for writing.";
+        return false;
+    }
+
+    auto guardName = "AXIOM_EXPORT_" + toIdentifier(QFileInfo(headerPath).completeBaseName()) + "_H";
+    QTextStream stream(&headerFile);
+    stream << buildHeader(rootSurface, guardName, config.sampleRate, config.bpm);
+    headerFile.close();
+
+    return true;
+}
+
+QString ProjectExporter::buildHeader(AxiomModel::RootSurface *rootSurface, const QString &guardName,
+                                     float sampleRate, float bpm) {
+    auto portals = getSortedPortals(rootSurface);
+
+    QString result;
+    QTextStream stream(&result);
+    stream << "// Generated by Axiom " << QString(AXIOM_VERSION) << "\n";
+    stream << "#ifndef " << guardName << "\n";
+    stream << "#define " << guardName << "\n\n";
+    stream << "#include \"Axiom.h\"\n\n";
+    stream << "#define AXIOM_SAMPLERATE " << sampleRate << "\n";
+    stream << "#define AXIOM_BPM " << bpm << "\n\n";
+
+    stream << "#define AXIOM_PORTAL_COUNT " << portals.size() << "\n";
+    QSet<QString> usedNames;
+    for (size_t i = 0; i < portals.size(); i++) {
+        auto baseName = "AXIOM_PORTAL_" + toIdentifier(portals[i]->name);
+        auto name = baseName;
+        for (auto suffix = 2; usedNames.contains(name); suffix++) {
+            name = baseName + "_" + QString::number(suffix);
+        }
+        usedNames.insert(name);
+        stream << "#define " << name << " " << i << "\n";
+    }
+
+    stream << "\nstatic const AxiomPortalInfo axiom_portals[] = {\n";
+    for (const auto &portal : portals) {
+        const char *typeName = "";
+        switch (portal->portalType) {
+        case AxiomModel::PortalControl::PortalType::INPUT:
+            typeName = "AXIOM_PORTAL_INPUT";
+            break;
+        case AxiomModel::PortalControl::PortalType::OUTPUT:
+            typeName = "AXIOM_PORTAL_OUTPUT";
+            break;
+        case AxiomModel::PortalControl::PortalType::AUTOMATION:
+            typeName = "AXIOM_PORTAL_AUTOMATION";
+            break;
+        }
+        auto valueName = portal->valueType == AxiomModel::ConnectionWire::WireType::MIDI ? "AXIOM_PORTAL_MIDI"
+                                                                                           : "AXIOM_PORTAL_AUDIO";
+
+        stream << "    {\"" << escapeString(portal->name) << "\", " << typeName << ", " << valueName << "},\n";
+    }
+    stream << "};\n\n";
+    stream << "#endif\n";
+
+    return result;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QtCore/QString>
+
+namespace MaximCompiler {
+    class Runtime;
+}
+
+namespace AxiomModel {
+    class RootSurface;
+}
+
+namespace MaximCompiler {
+
+    class ProjectExporter {
+    public:
+        enum class Profile { SIZE, SPEED };
+
+        // Writes the runtime's current graph to a relocatable object at `objectPath`, and a header describing its
+        // portals at `headerPath`. The root surface must have been compiled into the runtime.
+        static bool exportProject(Runtime *runtime, AxiomModel::RootSurface *rootSurface, Profile profile,
+                                  const QString &objectPath, const QString &headerPath, QString *errorOut);
+
+        static QString buildHeader(AxiomModel::RootSurface *rootSurface, const QString &guardName, float sampleRate,
+                                   float bpm);
+    };
+}
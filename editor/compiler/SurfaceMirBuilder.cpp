@@ -1,5 +1,6 @@
 #include "SurfaceMirBuilder.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "../model/ModelRoot.h"
@@ -221,8 +222,20 @@ void SurfaceMirBuilder::build(MaximCompiler::Transaction *transaction, AxiomMode
                 assert(numControl);
 
                 auto numVal = numControl->value();
-                if ((numVal.left != 0 || numVal.right != 0 || (int) numVal.form != 0) && !std::isnan(numVal.left) &&
-                    !std::isnan(numVal.right)) {
+                auto isNan = std::isnan(numVal.left) || std::isnan(numVal.right);
+
+                // if every control in the group is fixed, the value can be compiled into the nodes that read it
+                auto isFixed =
+                    std::all_of(controlPointers.begin(), controlPointers.end(), [](AxiomModel::Control *control) {
+                        auto fixedControl = dynamic_cast<AxiomModel::NumControl *>(control);
+                        return fixedControl && fixedControl->isFixed() && !fixedControl->isChangingValue();
+                    });
+                if (isFixed && !isNan) {
+                    mir.addValueGroup(std::move(vartype), ValueGroupSource::fixed(ConstantValue::num(numVal)));
+                    continue;
+                }
+
+                if ((numVal.left != 0 || numVal.right != 0 || (int) numVal.form != 0) && !isNan) {
                     auto constVal = ConstantValue::num(numVal);
                     mir.addValueGroup(std::move(vartype), ValueGroupSource::default_val(std::move(constVal)));
                     continue;
@@ -40,6 +40,8 @@ ControlType MaximCompiler::fromModelType(AxiomModel::Control::ControlType modelT
         return ControlType::MidiExtract;
     case AxiomModel::Control::ControlType::GRAPH:
         return ControlType::Graph;
+    case AxiomModel::Control::ControlType::SCOPE:
+        return ControlType::Scope;
     }
 
     unreachable;
@@ -53,6 +55,8 @@ AxiomModel::Control::ControlType MaximCompiler::toModelType(MaximCompiler::Contr
         return AxiomModel::Control::ControlType::MIDI_SCALAR;
     case ControlType::Graph:
         return AxiomModel::Control::ControlType::GRAPH;
+    case ControlType::Scope:
+        return AxiomModel::Control::ControlType::SCOPE;
     case ControlType::AudioExtract:
         return AxiomModel::Control::ControlType::NUM_EXTRACT;
     case ControlType::MidiExtract:
@@ -13,6 +13,8 @@ namespace MaximFrontend {
     using MaximTransaction = void;
     using MaximTransactionRef = MaximTransaction;
 
+    using MaximFrozenUpdate = void;
+
     using MaximVarType = void;
     using MaximVarTypeRef = MaximVarType;
     using MaximConstantValue = void;
@@ -28,6 +30,9 @@ namespace MaximFrontend {
 
     using MaximValueGroupSource = void;
 
+    using MaximImpulseResponse = void;
+    using MaximSample = void;
+
     struct SourcePos {
         ssize_t line;
         ssize_t column;
@@ -45,6 +50,33 @@ namespace MaximFrontend {
         void *ui;
     };
 
+    struct CommitMetrics {
+        bool rebuilt;
+        double patchSeconds;
+        double layoutSeconds;
+        double codegenSeconds;
+        double optimizeSeconds;
+        double deploySeconds;
+        size_t blockCount;
+        size_t surfaceCount;
+    };
+
+    enum class ExportPortalDirection : uint8_t { INPUT, OUTPUT, AUTOMATION };
+
+    struct ExportPortal {
+        size_t socket;
+        ExportPortalDirection direction;
+    };
+
+    enum class TargetIsa : uint8_t { HOST, BASELINE, AVX2, AVX512 };
+
+    struct ExportConfig {
+        bool minSize;
+        float sampleRate;
+        float bpm;
+        TargetIsa isa;
+    };
+
     extern "C" {
     void maxim_initialize();
 
@@ -57,6 +89,19 @@ namespace MaximFrontend {
     float maxim_get_bpm(MaximRuntimeRef *runtime);
     void maxim_set_sample_rate(MaximRuntimeRef *runtime, float sample_rate);
     float maxim_get_sample_rate(MaximRuntimeRef *runtime);
+    void maxim_set_parallel_tasks(MaximRuntimeRef *runtime, uint32_t parallel_tasks);
+    uint32_t maxim_get_parallel_tasks(MaximRuntimeRef *runtime);
+    MaximImpulseResponse *maxim_create_impulse_response(const char *path, float sampleRate,
+                                                        const char **fail_error_out);
+    void maxim_destroy_impulse_response(MaximImpulseResponse *);
+    void maxim_set_impulse_response(MaximRuntimeRef *runtime, size_t slot, MaximImpulseResponse *response);
+    size_t maxim_get_impulse_response_slot_count();
+    MaximSample *maxim_create_sample(const char *path, const char **fail_error_out);
+    void maxim_destroy_sample(MaximSample *);
+    void maxim_set_sample(MaximRuntimeRef *runtime, size_t slot, MaximSample *sample);
+    size_t maxim_get_sample_slot_count();
+    bool maxim_export(MaximRuntimeRef *runtime, const ExportConfig *config, const ExportPortal *portals,
+                      size_t portalCount, const char *path, const char **fail_error_out);
     bool maxim_is_node_extracted(MaximRuntimeRef *runtime, uint64_t surface, size_t node);
     void maxim_convert_num(MaximRuntimeRef *runtime, void *result, uint8_t targetForm, const void *input);
 
@@ -96,6 +141,7 @@ namespace MaximFrontend {
     MaximValueGroupSource *maxim_valuegroupsource_none();
     MaximValueGroupSource *maxim_valuegroupsource_socket(size_t index);
     MaximValueGroupSource *maxim_valuegroupsource_default(MaximConstantValue *value);
+    MaximValueGroupSource *maxim_valuegroupsource_fixed(MaximConstantValue *value);
     MaximValueGroupSource *maxim_valuegroupsource_clone(MaximValueGroupSource *base);
     void maxim_destroy_valuegroupsource(MaximValueGroupSource *);
     void maxim_build_value_group(MaximSurfaceRef *surface, MaximVarType *vartype, MaximValueGroupSource *source);
@@ -122,7 +168,11 @@ namespace MaximFrontend {
     bool maxim_control_get_written(MaximBlockControlRef *control);
     bool maxim_control_get_read(MaximBlockControlRef *control);
 
-    void maxim_commit(MaximRuntimeRef *runtime, MaximTransaction *transaction);
+    CommitMetrics maxim_commit(MaximRuntimeRef *runtime, MaximTransaction *transaction);
+    bool maxim_commit_will_rebuild(MaximRuntimeRef *runtime, MaximTransactionRef *transaction);
+    MaximFrozenUpdate *maxim_build_frozen(MaximRuntimeRef *runtime);
+    void maxim_apply_frozen(MaximRuntimeRef *runtime, MaximFrozenUpdate *frozen);
+    bool maxim_is_frozen(MaximRuntimeRef *runtime);
 
     size_t maxim_get_function_table_size();
     const char *maxim_get_function_table_entry(size_t index);
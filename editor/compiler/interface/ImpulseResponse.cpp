@@ -0,0 +1,26 @@
+#include "ImpulseResponse.h"
+
+#include "Frontend.h"
+
+using namespace MaximCompiler;
+
+ImpulseResponse::ImpulseResponse(void *handle)
+    : OwnedObject(handle, &MaximFrontend::maxim_destroy_impulse_response) {}
+
+std::optional<ImpulseResponse> ImpulseResponse::fromWavFile(const QString &path, float sampleRate,
+                                                            QString *errorOut) {
+    const char *error = nullptr;
+    auto handle = MaximFrontend::maxim_create_impulse_response(path.toUtf8().constData(), sampleRate, &error);
+
+    if (!handle) {
+        *errorOut = QString::fromUtf8(error);
+        MaximFrontend::maxim_destroy_string(error);
+        return std::nullopt;
+    }
+
+    return ImpulseResponse(handle);
+}
+
+size_t ImpulseResponse::slotCount() {
+    return MaximFrontend::maxim_get_impulse_response_slot_count();
+}
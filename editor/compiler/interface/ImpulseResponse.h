@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <optional>
+
+#include "OwnedObject.h"
+
+namespace MaximCompiler {
+
+    class ImpulseResponse : public OwnedObject {
+    public:
+        explicit ImpulseResponse(void *handle);
+
+        // Reads an uncompressed WAV file, resampled to the rate it'll be convolved at. Returns an empty value and sets
+        // errorOut if it can't be loaded.
+        static std::optional<ImpulseResponse> fromWavFile(const QString &path, float sampleRate, QString *errorOut);
+
+        static size_t slotCount();
+    };
+}
@@ -31,8 +31,55 @@ float Runtime::getSampleRate() {
     return MaximFrontend::maxim_get_sample_rate(get());
 }
 
-void Runtime::commit(MaximCompiler::Transaction transaction) {
-    MaximFrontend::maxim_commit(get(), transaction.release());
+void Runtime::setParallelTasks(uint32_t parallelTasks) {
+    MaximFrontend::maxim_set_parallel_tasks(get(), parallelTasks);
+}
+
+uint32_t Runtime::getParallelTasks() {
+    return MaximFrontend::maxim_get_parallel_tasks(get());
+}
+
+void Runtime::setImpulseResponse(size_t slot, std::optional<MaximCompiler::ImpulseResponse> response) {
+    MaximFrontend::maxim_set_impulse_response(get(), slot, response ? response->release() : nullptr);
+}
+
+void Runtime::setSample(size_t slot, std::optional<MaximCompiler::Sample> sample) {
+    MaximFrontend::maxim_set_sample(get(), slot, sample ? sample->release() : nullptr);
+}
+
+bool Runtime::willRebuild(const MaximCompiler::Transaction &transaction) {
+    return MaximFrontend::maxim_commit_will_rebuild(get(), (MaximFrontend::MaximTransactionRef *) transaction.get());
+}
+
+MaximFrontend::CommitMetrics Runtime::commit(MaximCompiler::Transaction transaction) {
+    return MaximFrontend::maxim_commit(get(), transaction.release());
+}
+
+MaximFrontend::MaximFrozenUpdate *Runtime::buildFrozen() {
+    return MaximFrontend::maxim_build_frozen(get());
+}
+
+void Runtime::applyFrozen(MaximFrontend::MaximFrozenUpdate *frozen) {
+    MaximFrontend::maxim_apply_frozen(get(), frozen);
+}
+
+bool Runtime::isFrozen() {
+    return MaximFrontend::maxim_is_frozen(get());
+}
+
+bool Runtime::exportObject(const MaximFrontend::ExportConfig &config,
+                           const std::vector<MaximFrontend::ExportPortal> &portals, const QString &path,
+                           QString *errorOut) {
+    const char *error = nullptr;
+    auto exportSuccess = MaximFrontend::maxim_export(get(), &config, portals.data(), portals.size(),
+                                                     path.toUtf8().constData(), &error);
+
+    if (!exportSuccess) {
+        *errorOut = QString::fromUtf8(error);
+        MaximFrontend::maxim_destroy_string(error);
+    }
+
+    return exportSuccess;
 }
 
 bool Runtime::isNodeExtracted(uint64_t surface, size_t node) {
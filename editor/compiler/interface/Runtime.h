@@ -1,6 +1,12 @@
 #pragma once
 
+#include <QtCore/QString>
+#include <vector>
+
+#include "Frontend.h"
+#include "ImpulseResponse.h"
 #include "OwnedObject.h"
+#include "Sample.h"
 #include "Transaction.h"
 #include "editor/model/Value.h"
 
@@ -22,7 +28,34 @@ namespace MaximCompiler {
 
         float getSampleRate();
 
-        void commit(Transaction transaction);
+        // takes effect on the next commit
+        void setParallelTasks(uint32_t parallelTasks);
+
+        uint32_t getParallelTasks();
+
+        // replaces the impulse response `convolve` reads from the slot, or empties it
+        void setImpulseResponse(size_t slot, std::optional<ImpulseResponse> response);
+
+        // replaces the sample `sampler` plays from the slot, or empties it
+        void setSample(size_t slot, std::optional<Sample> sample);
+
+        // false if committing the transaction would be skipped, leaving runtime pointers where they are
+        bool willRebuild(const Transaction &transaction);
+
+        MaximFrontend::CommitMetrics commit(Transaction transaction);
+
+        // Links the whole patch into one module so it can be optimized as a unit, without switching to it yet. This
+        // can run while the runtime is being updated. Returns null if there's nothing to freeze.
+        MaximFrontend::MaximFrozenUpdate *buildFrozen();
+
+        // switches updates to the code from `buildFrozen`, undone by the next commit
+        void applyFrozen(MaximFrontend::MaximFrozenUpdate *frozen);
+
+        bool isFrozen();
+
+        bool exportObject(const MaximFrontend::ExportConfig &config,
+                          const std::vector<MaximFrontend::ExportPortal> &portals, const QString &path,
+                          QString *errorOut);
 
         bool isNodeExtracted(uint64_t surface, size_t node);
 
@@ -0,0 +1,24 @@
+#include "Sample.h"
+
+#include "Frontend.h"
+
+using namespace MaximCompiler;
+
+Sample::Sample(void *handle) : OwnedObject(handle, &MaximFrontend::maxim_destroy_sample) {}
+
+std::optional<Sample> Sample::fromWavFile(const QString &path, QString *errorOut) {
+    const char *error = nullptr;
+    auto handle = MaximFrontend::maxim_create_sample(path.toUtf8().constData(), &error);
+
+    if (!handle) {
+        *errorOut = QString::fromUtf8(error);
+        MaximFrontend::maxim_destroy_string(error);
+        return std::nullopt;
+    }
+
+    return Sample(handle);
+}
+
+size_t Sample::slotCount() {
+    return MaximFrontend::maxim_get_sample_slot_count();
+}
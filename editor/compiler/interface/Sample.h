@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <optional>
+
+#include "OwnedObject.h"
+
+namespace MaximCompiler {
+
+    class Sample : public OwnedObject {
+    public:
+        explicit Sample(void *handle);
+
+        // opens a WAV file to be streamed, returning an empty value and setting errorOut if it can't be loaded
+        static std::optional<Sample> fromWavFile(const QString &path, QString *errorOut);
+
+        static size_t slotCount();
+    };
+}
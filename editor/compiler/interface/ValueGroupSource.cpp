@@ -19,6 +19,10 @@ ValueGroupSource ValueGroupSource::default_val(MaximCompiler::ConstantValue valu
     return ValueGroupSource(MaximFrontend::maxim_valuegroupsource_default(value.release()));
 }
 
+ValueGroupSource ValueGroupSource::fixed(MaximCompiler::ConstantValue value) {
+    return ValueGroupSource(MaximFrontend::maxim_valuegroupsource_fixed(value.release()));
+}
+
 ValueGroupSource ValueGroupSource::clone() {
     return ValueGroupSource(MaximFrontend::maxim_valuegroupsource_clone(get()));
 }
@@ -15,6 +15,8 @@ namespace MaximCompiler {
 
         static ValueGroupSource default_val(ConstantValue value);
 
+        static ValueGroupSource fixed(ConstantValue value);
+
         ValueGroupSource clone();
 
     private:
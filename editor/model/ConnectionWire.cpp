@@ -8,20 +8,20 @@ using namespace AxiomModel;
 ConnectionWire::ConnectionWire(AxiomModel::GridSurface *grid, WireGrid *wireGrid, WireType wireType,
                                const QPointF &startPos, const QPointF &endPos)
     : _grid(grid), _wireGrid(wireGrid), _wireType(wireType), _startPos(startPos), _endPos(endPos) {
-    _grid->gridChanged.connect(this, &ConnectionWire::updateRoute);
-    _wireGrid->gridChanged.connect(this, &ConnectionWire::updateLineIndices);
-    updateRoute();
+    _grid->gridChanged.connect(this, &ConnectionWire::gridRegionChanged);
+    setRoute(findRoute());
 }
 
 ConnectionWire::~ConnectionWire() {
     clearWireGrid(_route);
+    _wireGrid->removeWire(this);
 }
 
 void ConnectionWire::setStartPos(const QPointF &startPos) {
     if (startPos != _startPos) {
         _startPos = startPos;
         startPosChanged(startPos);
-        updateRoute();
+        _wireGrid->markRouteDirty(this);
     }
 }
 
@@ -29,7 +29,7 @@ void ConnectionWire::setEndPos(const QPointF &endPos) {
     if (endPos != _endPos) {
         _endPos = endPos;
         endPosChanged(endPos);
-        updateRoute();
+        _wireGrid->markRouteDirty(this);
     }
 }
 
@@ -100,12 +100,34 @@ void ConnectionWire::updateEnabled() {
     }
 }
 
-void ConnectionWire::updateRoute() {
+std::deque<QPoint> ConnectionWire::findRoute() const {
+    return _grid->grid().findPath(QPoint(_startPos.x(), _startPos.y()), QPoint(_endPos.x(), _endPos.y()), 1, 10, 4);
+}
+
+void ConnectionWire::setRoute(std::deque<QPoint> route) {
+    // the endpoints can still move without the route changing, so always update the bounds
+    auto bounds = AxiomUtil::makeRect(QPoint(_startPos.x(), _startPos.y()), QPoint(_endPos.x(), _endPos.y()));
+    for (const auto &point : route) {
+        bounds |= QRect(point, QSize(1, 1));
+    }
+
+    // Expand by a cell, so items moving up against the route (and changing the cost of turning there) are caught.
+    // If an obstacle the route is avoiding is moved, it's always inside these bounds.
+    _routeBounds = bounds.adjusted(-1, -1, 1, 1);
+
+    if (route == _route) return;
+
     clearWireGrid(_route);
-    _route = _grid->grid().findPath(QPoint(_startPos.x(), _startPos.y()), QPoint(_endPos.x(), _endPos.y()), 1, 10, 4);
+    _route = std::move(route);
     setWireGrid(_route);
 }
 
+void ConnectionWire::gridRegionChanged(const QRect &region) {
+    if (_routeBounds.intersects(region)) {
+        _wireGrid->markRouteDirty(this);
+    }
+}
+
 void ConnectionWire::updateLineIndices() {
     _lineIndices = getLineIndices(_route);
     routeChanged(_route, _lineIndices);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QPointF>
+#include <QtCore/QRect>
 #include <deque>
 
 #include "WireGrid.h"
@@ -45,6 +46,16 @@ namespace AxiomModel {
 
         const std::vector<LineIndex> &lineIndices() const { return _lineIndices; }
 
+        // the cells the route passes through or around, changes to the item grid outside of this don't affect it
+        const QRect &routeBounds() const { return _routeBounds; }
+
+        // finds a path between the endpoints without modifying anything, so it's safe to call from a worker thread
+        std::deque<QPoint> findRoute() const;
+
+        void setRoute(std::deque<QPoint> route);
+
+        void updateLineIndices();
+
         bool startActive() const { return _startActive; }
 
         void setStartActive(bool active);
@@ -77,6 +88,7 @@ namespace AxiomModel {
         QPointF _endPos;
         std::deque<QPoint> _route;
         std::vector<LineIndex> _lineIndices;
+        QRect _routeBounds;
         ActiveState activeState = ActiveState::NONE;
         bool _startActive = false;
         bool _endActive = false;
@@ -85,9 +97,7 @@ namespace AxiomModel {
         bool _endEnabled = true;
         bool _enabled = true;
 
-        void updateRoute();
-
-        void updateLineIndices();
+        void gridRegionChanged(const QRect &region);
 
         void updateActive();
 
@@ -1,5 +1,7 @@
 #include "HistoryList.h"
 
+#include <algorithm>
+
 #include "editor/compiler/interface/Transaction.h"
 
 using namespace AxiomModel;
@@ -16,13 +18,11 @@ void HistoryList::append(std::unique_ptr<AxiomModel::Action> action, bool forwar
     // remove items ahead of where we are
     _stack.erase(_stack.begin() + _stackPos, _stack.end());
 
-    // if the stack is going to be longer than max size, remove the first item
-    if (_stack.size() == maxActions) {
-        _stack.erase(_stack.begin());
-    } else
-        _stackPos++;
-
     _stack.push_back(std::move(action));
+    _stackPos++;
+
+    compactColdActions();
+    trimToLimits();
 
     stackChanged();
 }
@@ -42,6 +42,7 @@ void HistoryList::undo() {
     _stackPos--;
     auto undoAction = _stack[_stackPos].get();
     undoAction->backward();
+    compactColdActions();
 
     stackChanged();
 }
@@ -62,6 +63,36 @@ void HistoryList::redo() {
     std::vector<QUuid> compileItems;
     redoAction->forward(false);
     _stackPos++;
+    compactColdActions();
 
     stackChanged();
 }
+
+size_t HistoryList::memoryUsage() const {
+    size_t usage = 0;
+    for (const auto &action : _stack) {
+        usage += action->memoryUsage();
+    }
+    return usage;
+}
+
+void HistoryList::compactColdActions() {
+    for (size_t i = 0; i < _stack.size(); i++) {
+        auto distance = i < _stackPos ? _stackPos - i - 1 : i - _stackPos;
+        if (distance >= hotActions) {
+            _stack[i]->compact();
+        }
+    }
+}
+
+void HistoryList::trimToLimits() {
+    size_t removeCount = 0;
+    auto usage = memoryUsage();
+    while (_stack.size() - removeCount > 1 && (_stack.size() - removeCount > maxActions || usage > maxBytes)) {
+        usage -= _stack[removeCount]->memoryUsage();
+        removeCount++;
+    }
+
+    _stack.erase(_stack.begin(), _stack.begin() + removeCount);
+    _stackPos -= std::min(_stackPos, removeCount);
+}
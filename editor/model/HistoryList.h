@@ -23,6 +23,14 @@ namespace AxiomModel {
 
         size_t maxActions = 256;
 
+        // Roughly how many bytes the actions in the stack can use. The oldest actions are removed once this is
+        // exceeded, although the newest one is always kept.
+        size_t maxBytes = 32 * 1024 * 1024;
+
+        // How many actions either side of the current position are left as-is. Ones further away are unlikely to be
+        // undone or redone soon, so they're compacted to save memory.
+        size_t hotActions = 8;
+
         HistoryList() = default;
 
         HistoryList(size_t stackPos, std::vector<std::unique_ptr<Action>> stack);
@@ -45,8 +53,14 @@ namespace AxiomModel {
 
         void redo();
 
+        size_t memoryUsage() const;
+
     private:
         size_t _stackPos = 0;
         std::vector<std::unique_ptr<Action>> _stack;
+
+        void compactColdActions();
+
+        void trimToLimits();
     };
 }
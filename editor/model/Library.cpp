@@ -80,7 +80,7 @@ void Library::import(
 
         // old entry becomes an entirely different entry, meaning if the library is imported in the future again,
         // the conflict won't show up
-        originalEntry->setBaseUuid(QUuid());
+        originalEntry->setBaseUuid(QUuid::createUuid());
     }
 
     for (const auto &removeEntry : removeEntries) {
@@ -0,0 +1,171 @@
+#include "LibraryStore.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <iostream>
+#include <set>
+
+#include "Library.h"
+#include "LibraryEntry.h"
+#include "serialize/LibrarySerializer.h"
+#include "serialize/ProjectSerializer.h"
+
+using namespace AxiomModel;
+
+LibraryStore::LibraryStore(QString directory) : _directory(std::move(directory)) {}
+
+bool LibraryStore::exists() const {
+    return QDir(_directory).exists();
+}
+
+std::unique_ptr<Library> LibraryStore::load() {
+    storedEntries.clear();
+
+    std::vector<std::unique_ptr<LibraryEntry>> entries;
+    for (const auto &pair : readEntryUuids()) {
+        auto entry = readEntry(pair.first);
+        if (!entry) continue;
+
+        storedEntries.emplace(entry->baseUuid(), entry->modificationUuid());
+        entries.push_back(std::move(entry));
+    }
+
+    return std::make_unique<Library>("", "", std::move(entries));
+}
+
+void LibraryStore::save(AxiomModel::Library *library) {
+    QDir().mkpath(_directory);
+
+    std::set<QUuid> libraryEntries;
+    for (const auto &entry : library->entries()) {
+        libraryEntries.insert(entry->baseUuid());
+
+        auto storedEntry = storedEntries.find(entry->baseUuid());
+        if (storedEntry != storedEntries.end() && storedEntry->second == entry->modificationUuid()) continue;
+
+        if (writeEntry(entry)) {
+            storedEntries[entry->baseUuid()] = entry->modificationUuid();
+        }
+    }
+
+    for (auto i = storedEntries.begin(); i != storedEntries.end();) {
+        if (libraryEntries.find(i->first) == libraryEntries.end()) {
+            QFile::remove(entryPath(i->first));
+            i = storedEntries.erase(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void LibraryStore::sync(AxiomModel::Library *library) {
+    auto diskEntries = readEntryUuids();
+
+    // Only read in entries that are different to both what we last saw on disk and what we have in memory. If the
+    // entry on disk hasn't changed since we last saw it, ours is either the same or newer.
+    std::vector<std::unique_ptr<LibraryEntry>> changedEntries;
+    for (const auto &pair : diskEntries) {
+        auto storedEntry = storedEntries.find(pair.first);
+        if (storedEntry != storedEntries.end() && storedEntry->second == pair.second) continue;
+
+        auto currentEntry = library->findById(pair.first);
+        if (!currentEntry || currentEntry->modificationUuid() != pair.second) {
+            auto entry = readEntry(pair.first);
+            if (!entry) continue;
+            changedEntries.push_back(std::move(entry));
+        }
+        storedEntries[pair.first] = pair.second;
+    }
+
+    // Entries that were removed from disk are removed from the library, unless they've been changed here since, in
+    // which case they'll be written back out on the next save.
+    for (auto i = storedEntries.begin(); i != storedEntries.end();) {
+        if (diskEntries.find(i->first) != diskEntries.end()) {
+            i++;
+            continue;
+        }
+
+        auto currentEntry = library->findById(i->first);
+        if (currentEntry && currentEntry->modificationUuid() == i->second) {
+            currentEntry->remove();
+        }
+        i = storedEntries.erase(i);
+    }
+
+    if (!changedEntries.empty()) {
+        Library changedLibrary("", "", std::move(changedEntries));
+        library->import(&changedLibrary, [](LibraryEntry *, LibraryEntry *) {
+            return Library::ConflictResolution::KEEP_NEW;
+        });
+    }
+}
+
+QString LibraryStore::entryPath(const QUuid &baseUuid) const {
+    return QDir(_directory).filePath(baseUuid.toString() + ".axl");
+}
+
+std::map<QUuid, QUuid> LibraryStore::readEntryUuids() const {
+    std::map<QUuid, QUuid> result;
+
+    QDir storeDir(_directory);
+    for (const auto &fileName : storeDir.entryList({"*.axl"}, QDir::Files)) {
+        QFile file(storeDir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly)) continue;
+
+        QDataStream stream(&file);
+        uint32_t readVersion = 0;
+        if (!ProjectSerializer::readHeader(stream, ProjectSerializer::librarySchemaMagic, &readVersion)) continue;
+
+        uint32_t entryCount;
+        stream >> entryCount;
+        if (entryCount != 1) continue;
+
+        QUuid baseUuid, modificationUuid;
+        LibrarySerializer::deserializeEntryUuids(stream, &baseUuid, &modificationUuid);
+        result.emplace(baseUuid, modificationUuid);
+    }
+
+    return result;
+}
+
+std::unique_ptr<LibraryEntry> LibraryStore::readEntry(const QUuid &baseUuid) const {
+    QFile file(entryPath(baseUuid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    QDataStream stream(&file);
+    uint32_t readVersion = 0;
+    if (!ProjectSerializer::readHeader(stream, ProjectSerializer::librarySchemaMagic, &readVersion)) {
+        std::cout << "Failed to load library entry '" << file.fileName().toStdString() << "' (";
+        if (readVersion) {
+            std::cout << "schema version is " << readVersion << ", expected between "
+                      << ProjectSerializer::minSchemaVersion << " and " << ProjectSerializer::schemaVersion;
+        } else {
+            std::cout << "bad magic header";
+        }
+        std::cout << "), skipping it" << std::endl;
+        return nullptr;
+    }
+
+    uint32_t entryCount;
+    stream >> entryCount;
+    if (entryCount != 1) return nullptr;
+
+    return LibrarySerializer::deserializeEntry(stream, readVersion);
+}
+
+bool LibraryStore::writeEntry(AxiomModel::LibraryEntry *entry) const {
+    // write to a temporary file and then move it over the old one, so other processes never see half-written files
+    QSaveFile file(entryPath(entry->baseUuid()));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    ProjectSerializer::writeHeader(stream, ProjectSerializer::librarySchemaMagic);
+    LibrarySerializer::serializeEntries(1, &entry, &entry + 1, stream);
+    return file.commit();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+#include <map>
+#include <memory>
+
+namespace AxiomModel {
+
+    class Library;
+
+    class LibraryEntry;
+
+    // Stores a library on disk as a directory with one file per entry, so saving after a change only has to write the
+    // entries that were modified, and other processes sharing the directory only have to read those entries back in.
+    // Callers are responsible for making sure only one process accesses the directory at a time.
+    class LibraryStore {
+    public:
+        explicit LibraryStore(QString directory);
+
+        const QString &directory() const { return _directory; }
+
+        bool exists() const;
+
+        std::unique_ptr<Library> load();
+
+        // Writes entries that have changed since they were last saved or loaded, and removes files of entries that
+        // have been removed from the library.
+        void save(Library *library);
+
+        // Applies changes made to the directory by other processes: entries whose files have changed are imported into
+        // the library, and entries whose files have been removed are removed.
+        void sync(Library *library);
+
+    private:
+        QString _directory;
+
+        // The modification UUID of each entry as it was when we last wrote or read it, keyed by base UUID. Anything
+        // in here that's different to what's in the library or on disk has changed since then.
+        std::map<QUuid, QUuid> storedEntries;
+
+        QString entryPath(const QUuid &baseUuid) const;
+
+        std::map<QUuid, QUuid> readEntryUuids() const;
+
+        std::unique_ptr<LibraryEntry> readEntry(const QUuid &baseUuid) const;
+
+        bool writeEntry(LibraryEntry *entry) const;
+    };
+}
@@ -10,6 +10,7 @@
 #include "Project.h"
 #include "editor/compiler/interface/Runtime.h"
 #include "objects/Connection.h"
+#include "objects/Control.h"
 #include "objects/ControlSurface.h"
 #include "objects/Node.h"
 #include "objects/RootSurface.h"
@@ -91,22 +92,60 @@ void ModelRoot::applyTransaction(MaximCompiler::Transaction transaction) {
     auto lock = lockRuntime();
 
     if (_runtime) {
-        auto allObjects = AxiomCommon::dynamicCast<ModelObject *>(_pool.sequence().sequence());
-        for (const auto &obj : allObjects) {
-            obj->saveState();
+        CommitReport report;
+
+        // Only controls keep state in the runtime, and only the ones already pointing into it have anything to save.
+        // Nothing moves if the runtime skips the commit, so there's no need to save anything then either.
+        std::vector<Control *> stateControls;
+        if (_runtime->willRebuild(transaction)) {
+            auto saveStartTime = std::chrono::high_resolution_clock::now();
+            stateControls = AxiomCommon::collect(AxiomCommon::filter(
+                controls().sequence(), [](Control *control) { return control->runtimePointers().has_value(); }));
+            for (const auto &control : stateControls) {
+                control->saveState();
+            }
+            report.saveSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::high_resolution_clock::now() - saveStartTime)
+                                     .count() /
+                                 1000000000.;
+            report.stateControlCount = stateControls.size();
         }
 
-        _runtime->commit(std::move(transaction));
-        rootSurface()->updateRuntimePointers(_runtime, _runtime->getRootPtr());
+        report.runtime = _runtime->commit(std::move(transaction));
 
-        for (const auto &obj : allObjects) {
-            obj->restoreState();
+        // The runtime builds its state from scratch whenever it rebuilds anything, so every control's pointers move
+        // and setting the new ones restores each control's state. Otherwise the old pointers are still valid.
+        if (report.runtime.rebuilt) {
+            auto restoreStartTime = std::chrono::high_resolution_clock::now();
+            rootSurface()->updateRuntimePointers(_runtime, _runtime->getRootPtr());
+            report.restoreSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::high_resolution_clock::now() - restoreStartTime)
+                                        .count() /
+                                    1000000000.;
+
+            std::cout << "State save (" << report.stateControlCount << " controls) took " << report.saveSeconds
+                      << "s, restore took " << report.restoreSeconds << "s" << std::endl;
         }
+
+        _lastCommit = report;
     }
 
     configurationChanged();
 }
 
+void ModelRoot::freezeRuntime() {
+    if (!_runtime || _runtime->isFrozen()) return;
+
+    // Building the frozen code takes a while, and the audio thread needs the lock to run updates, so it's only taken
+    // to swap the code in. Commits only happen on this thread too, so nothing can change the patch in between.
+    auto frozen = _runtime->buildFrozen();
+    if (!frozen) return;
+
+    // freezing only swaps out the code that runs updates, the runtime's state and pointers stay the same
+    auto lock = lockRuntime();
+    _runtime->applyFrozen(frozen);
+}
+
 void ModelRoot::destroy() {
     _pool.destroy();
 }
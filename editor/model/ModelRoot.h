@@ -6,6 +6,7 @@
 #include "HistoryList.h"
 #include "Pool.h"
 #include "common/WatchSequence.h"
+#include "editor/compiler/interface/Frontend.h"
 #include "editor/compiler/interface/Transaction.h"
 
 namespace MaximCompiler {
@@ -32,6 +33,14 @@ namespace AxiomModel {
 
     class RootSurface;
 
+    // timings of the last transaction applied to the runtime, including the editor's side of it
+    struct CommitReport {
+        MaximFrontend::CommitMetrics runtime = {};
+        double saveSeconds = 0;
+        double restoreSeconds = 0;
+        size_t stateControlCount = 0;
+    };
+
     class ModelRoot : public AxiomCommon::TrackedObject {
     public:
         template<class CollectionType>
@@ -82,6 +91,10 @@ namespace AxiomModel {
 
         void applyTransaction(MaximCompiler::Transaction transaction);
 
+        const CommitReport &lastCommit() const { return _lastCommit; }
+
+        void freezeRuntime();
+
         void destroy();
 
     private:
@@ -95,5 +108,6 @@ namespace AxiomModel {
 
         std::mutex _runtimeLock;
         MaximCompiler::Runtime *_runtime = nullptr;
+        CommitReport _lastCommit;
     };
 }
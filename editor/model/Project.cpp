@@ -1,10 +1,13 @@
 #include "Project.h"
 
+#include <iostream>
+
 #include "../backend/AudioBackend.h"
 #include "../backend/AudioConfiguration.h"
 #include "ModelRoot.h"
 #include "PoolOperators.h"
 #include "actions/CreatePortalNodeAction.h"
+#include "editor/compiler/interface/Runtime.h"
 #include "objects/PortalNode.h"
 #include "objects/RootSurface.h"
 
@@ -78,8 +81,11 @@ Project::Project(const AxiomBackend::DefaultConfiguration &defaultConfiguration)
     }
 }
 
-Project::Project(QString linkedFile, std::unique_ptr<AxiomModel::ModelRoot> mainRoot)
-    : _mainRoot(std::move(mainRoot)), _linkedFile(std::move(linkedFile)), _rootSurface(_mainRoot->rootSurface()) {
+Project::Project(QString linkedFile, std::unique_ptr<AxiomModel::ModelRoot> mainRoot, uint32_t parallelTasks,
+                 QMap<uint32_t, QString> impulseResponses, QMap<uint32_t, QString> samples)
+    : _mainRoot(std::move(mainRoot)), _linkedFile(std::move(linkedFile)), _parallelTasks(parallelTasks),
+      _impulseResponses(std::move(impulseResponses)), _samples(std::move(samples)),
+      _rootSurface(_mainRoot->rootSurface()) {
     addRootListeners();
 }
 
@@ -101,6 +107,107 @@ void Project::setIsDirty(bool isDirty) {
     }
 }
 
+void Project::setParallelTasks(uint32_t parallelTasks) {
+    if (parallelTasks == _parallelTasks) return;
+    _parallelTasks = parallelTasks;
+
+    // the runtime rebuilds everything on the next commit, so send an empty one to apply the change now
+    if (auto runtime = _mainRoot->runtime()) {
+        {
+            auto lock = _mainRoot->lockRuntime();
+            runtime->setParallelTasks(parallelTasks);
+        }
+        _mainRoot->applyTransaction(MaximCompiler::Transaction());
+    }
+
+    parallelTasksChanged(parallelTasks);
+    rootModified();
+}
+
+bool Project::setImpulseResponse(uint32_t slot, const QString &path, QString *errorOut) {
+    // The response is prepared here so the runtime only needs to be locked to swap it in. Without a runtime it's only
+    // loaded to check that it can be, so the rate it's resampled to doesn't matter.
+    auto runtime = _mainRoot->runtime();
+    std::optional<MaximCompiler::ImpulseResponse> response;
+    if (!path.isEmpty()) {
+        auto sampleRate = runtime ? runtime->getSampleRate() : 44100.f;
+        response = MaximCompiler::ImpulseResponse::fromWavFile(path, sampleRate, errorOut);
+        if (!response) return false;
+    }
+
+    if (runtime) {
+        auto lock = _mainRoot->lockRuntime();
+        runtime->setImpulseResponse(slot, std::move(response));
+    }
+
+    if (path.isEmpty()) {
+        _impulseResponses.remove(slot);
+    } else {
+        _impulseResponses.insert(slot, path);
+    }
+    rootModified();
+    return true;
+}
+
+void Project::loadImpulseResponses() {
+    auto runtime = _mainRoot->runtime();
+    if (!runtime) return;
+
+    for (auto slot : _impulseResponses.keys()) {
+        QString error;
+        auto response =
+            MaximCompiler::ImpulseResponse::fromWavFile(_impulseResponses[slot], runtime->getSampleRate(), &error);
+        if (!response) {
+            std::cout << "Failed to load impulse response '" << _impulseResponses[slot].toStdString()
+                      << "': " << error.toStdString() << std::endl;
+            continue;
+        }
+
+        auto lock = _mainRoot->lockRuntime();
+        runtime->setImpulseResponse(slot, std::move(response));
+    }
+}
+
+bool Project::setSample(uint32_t slot, const QString &path, QString *errorOut) {
+    // the file is opened and its start is read here so the runtime only needs to be locked to swap it in
+    std::optional<MaximCompiler::Sample> sample;
+    if (!path.isEmpty()) {
+        sample = MaximCompiler::Sample::fromWavFile(path, errorOut);
+        if (!sample) return false;
+    }
+
+    if (auto runtime = _mainRoot->runtime()) {
+        auto lock = _mainRoot->lockRuntime();
+        runtime->setSample(slot, std::move(sample));
+    }
+
+    if (path.isEmpty()) {
+        _samples.remove(slot);
+    } else {
+        _samples.insert(slot, path);
+    }
+    rootModified();
+    return true;
+}
+
+void Project::loadSamples() {
+    auto runtime = _mainRoot->runtime();
+    if (!runtime) return;
+
+    for (auto slot : _samples.keys()) {
+        QString error;
+        auto sample = MaximCompiler::Sample::fromWavFile(_samples[slot], &error);
+        if (!sample) {
+            std::cout << "Failed to load sample '" << _samples[slot].toStdString() << "': " << error.toStdString()
+                      << std::endl;
+            continue;
+        }
+
+        auto lock = _mainRoot->lockRuntime();
+        runtime->setSample(slot, std::move(sample));
+    }
+}
+
 void Project::addRootListeners() {
     _mainRoot->modified.connect(this, &Project::rootModified);
     _mainRoot->configurationChanged.connect(this, &Project::rootConfigurationChanged);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QtCore/QMap>
 #include <QtCore/QString>
 #include <memory>
 #include <optional>
@@ -20,10 +21,12 @@ namespace AxiomModel {
     public:
         AxiomCommon::Event<const QString &> linkedFileChanged;
         AxiomCommon::Event<bool> isDirtyChanged;
+        AxiomCommon::Event<uint32_t> parallelTasksChanged;
 
         explicit Project(const AxiomBackend::DefaultConfiguration &defaultConfiguration);
 
-        Project(QString linkedFile, std::unique_ptr<ModelRoot> mainRoot);
+        Project(QString linkedFile, std::unique_ptr<ModelRoot> mainRoot, uint32_t parallelTasks,
+                QMap<uint32_t, QString> impulseResponses, QMap<uint32_t, QString> samples);
 
         ~Project() override;
 
@@ -39,6 +42,33 @@ namespace AxiomModel {
 
         void setIsDirty(bool isDirty);
 
+        const uint32_t &parallelTasks() const { return _parallelTasks; }
+
+        // The number of threads the project's runtime can spread surface updates across, or 1 to update serially.
+        void setParallelTasks(uint32_t parallelTasks);
+
+        // Maps impulse response slots that `convolve` can read from to the WAV files loaded into them.
+        const QMap<uint32_t, QString> &impulseResponses() const { return _impulseResponses; }
+
+        // Loads a WAV file into an impulse response slot, or empties the slot if the path is empty. Returns false and
+        // sets errorOut if the file can't be loaded.
+        bool setImpulseResponse(uint32_t slot, const QString &path, QString *errorOut);
+
+        // Loads every impulse response into the runtime, e.g after it's attached or its sample rate changes. Files that
+        // can't be loaded leave their slot empty.
+        void loadImpulseResponses();
+
+        // Maps sample slots that `sampler` can play from to the WAV files loaded into them.
+        const QMap<uint32_t, QString> &samples() const { return _samples; }
+
+        // Opens a WAV file to stream into a sample slot, or empties the slot if the path is empty. Returns false and
+        // sets errorOut if the file can't be opened.
+        bool setSample(uint32_t slot, const QString &path, QString *errorOut);
+
+        // Loads every sample into the runtime, e.g after it's attached. Files that can't be opened leave their slot
+        // empty.
+        void loadSamples();
+
         void attachBackend(AxiomBackend::AudioBackend *backend) { _backend = backend; }
 
         AxiomBackend::AudioBackend *backend() const { return _backend; }
@@ -47,6 +77,9 @@ namespace AxiomModel {
         std::unique_ptr<ModelRoot> _mainRoot;
         QString _linkedFile;
         bool _isDirty = false;
+        uint32_t _parallelTasks = 1;
+        QMap<uint32_t, QString> _impulseResponses;
+        QMap<uint32_t, QString> _samples;
 
         AxiomBackend::AudioBackend *_backend = nullptr;
         RootSurface *_rootSurface;
@@ -60,7 +60,8 @@ namespace AxiomModel {
     };
 
     struct MidiValue {
-        static constexpr size_t MAX_EVENTS = 32;
+        // Must match MIDI_EVENT_COUNT in the compiler, since the runtime's MIDI values are written through this struct.
+        static constexpr size_t MAX_EVENTS = 16;
 
         uint8_t count = 0;
         MidiEventValue events[MAX_EVENTS];
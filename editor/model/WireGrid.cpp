@@ -1,55 +1,70 @@
 #include "WireGrid.h"
 
 #include <algorithm>
+#include <future>
+#include <thread>
 
 #include "../util.h"
+#include "ConnectionWire.h"
 
 using namespace AxiomModel;
 
-inline uint qHash(const QPoint &key) {
-    return qHash(QPair(key.x(), key.y()));
+// below this many wires, spinning up worker threads costs more than routing on the calling thread
+static const size_t PARALLEL_ROUTE_THRESHOLD = 16;
+
+void WireGrid::WireList::push_back(AxiomModel::ConnectionWire *wire) {
+    if (_spilled.empty() && _size < inlineCapacity) {
+        _inline[_size] = wire;
+        _size++;
+        return;
+    }
+
+    if (_spilled.empty()) {
+        _spilled.assign(_inline.begin(), _inline.begin() + _size);
+    }
+    _spilled.push_back(wire);
+    _size++;
 }
 
-void WireGrid::addPoint(QPoint point, AxiomModel::ConnectionWire *wire, Direction direction) {
-    auto index = cells.find(point);
-    if (index == cells.end()) {
-        CellLists lists;
-        switch (direction) {
-        case Direction::HORIZONTAL:
-            lists.horizontal.push_back(wire);
-            break;
-        case Direction::VERTICAL:
-            lists.vertical.push_back(wire);
-            break;
-        }
-        cells[point] = std::move(lists);
+void WireGrid::WireList::erase(AxiomModel::ConnectionWire *const *pos) {
+    auto index = (size_t)(pos - data());
+    if (_spilled.empty()) {
+        std::copy(_inline.begin() + index + 1, _inline.begin() + _size, _inline.begin() + index);
     } else {
-        std::vector<ConnectionWire *> *collection;
-        switch (direction) {
-        case Direction::HORIZONTAL:
-            collection = &index.value().horizontal;
-            break;
-        case Direction::VERTICAL:
-            collection = &index.value().vertical;
-            break;
-        }
-
-        // make sure it isn't already in the collection
-        auto currentIndex = std::find(collection->begin(), collection->end(), wire);
-        if (currentIndex != collection->end()) return;
+        _spilled.erase(_spilled.begin() + index);
+    }
+    _size--;
+}
 
-        collection->push_back(wire);
+void WireGrid::addPoint(QPoint point, AxiomModel::ConnectionWire *wire, Direction direction) {
+    auto &lists = cells.get(point);
+    WireList *collection;
+    switch (direction) {
+    case Direction::HORIZONTAL:
+        collection = &lists.horizontal;
+        break;
+    case Direction::VERTICAL:
+        collection = &lists.vertical;
+        break;
     }
 
-    _isDirty = true;
+    // make sure it isn't already in the collection
+    auto currentIndex = std::find(collection->begin(), collection->end(), wire);
+    if (currentIndex != collection->end()) return;
+
+    collection->push_back(wire);
+    markCellDirty(lists);
 }
 
 void WireGrid::removePoint(QPoint point, AxiomModel::ConnectionWire *wire) {
-    auto index = cells.find(point);
-    if (index == cells.end()) return;
+    auto lists = cells.find(point);
+    if (!lists) return;
 
-    auto &horizontal = index.value().horizontal;
-    auto &vertical = index.value().vertical;
+    // the wires that remain in this cell will need to shift over
+    markCellDirty(*lists);
+
+    auto &horizontal = lists->horizontal;
+    auto &vertical = lists->vertical;
 
     auto horizontalIndex = std::find(horizontal.begin(), horizontal.end(), wire);
     if (horizontalIndex != horizontal.end()) horizontal.erase(horizontalIndex);
@@ -57,10 +72,8 @@ void WireGrid::removePoint(QPoint point, AxiomModel::ConnectionWire *wire) {
     if (verticalIndex != vertical.end()) vertical.erase(verticalIndex);
 
     if (horizontal.empty() && vertical.empty()) {
-        cells.erase(index);
+        cells.erase(point);
     }
-
-    _isDirty = true;
 }
 
 void WireGrid::addRegion(QRect region, AxiomModel::ConnectionWire *wire) {
@@ -103,15 +116,15 @@ LineIndex WireGrid::getRegionIndex(QRect region, AxiomModel::ConnectionWire *wir
     for (auto x = region.left(); x <= region.right(); x++) {
         for (auto y = region.top(); y <= region.bottom(); y++) {
             auto cellWires = cells.find(QPoint(x, y));
-            if (cellWires == cells.end()) continue;
+            if (!cellWires) continue;
 
-            std::vector<ConnectionWire *> *collection;
+            const WireList *collection;
             switch (direction) {
             case Direction::HORIZONTAL:
-                collection = &cellWires.value().horizontal;
+                collection = &cellWires->horizontal;
                 break;
             case Direction::VERTICAL:
-                collection = &cellWires.value().vertical;
+                collection = &cellWires->vertical;
                 break;
             }
 
@@ -128,9 +141,70 @@ LineIndex WireGrid::getRegionIndex(QRect region, AxiomModel::ConnectionWire *wir
     return {biggestCount, biggestIndex};
 }
 
+void WireGrid::markRouteDirty(AxiomModel::ConnectionWire *wire) {
+    if (_dirtyRouteSet.insert(wire).second) {
+        _dirtyRoutes.push_back(wire);
+    }
+}
+
+void WireGrid::removeWire(AxiomModel::ConnectionWire *wire) {
+    if (_dirtyRouteSet.erase(wire)) {
+        _dirtyRoutes.erase(std::find(_dirtyRoutes.begin(), _dirtyRoutes.end(), wire));
+    }
+    _dirtyIndices.erase(wire);
+}
+
 void WireGrid::tryFlush() {
-    if (_isDirty) {
-        gridChanged();
-        _isDirty = false;
+    if (!_dirtyRoutes.empty()) {
+        rerouteDirty();
+    }
+
+    if (_dirtyIndices.empty()) return;
+
+    auto updateWires = std::move(_dirtyIndices);
+    _dirtyIndices.clear();
+    for (const auto &wire : updateWires) {
+        wire->updateLineIndices();
+    }
+}
+
+void WireGrid::markCellDirty(const AxiomModel::WireGrid::CellLists &lists) {
+    _dirtyIndices.insert(lists.horizontal.begin(), lists.horizontal.end());
+    _dirtyIndices.insert(lists.vertical.begin(), lists.vertical.end());
+}
+
+void WireGrid::rerouteDirty() {
+    auto wires = std::move(_dirtyRoutes);
+    _dirtyRoutes.clear();
+    _dirtyRouteSet.clear();
+
+    std::vector<std::deque<QPoint>> routes(wires.size());
+    auto workerCount = (size_t) std::thread::hardware_concurrency();
+    if (!_parallelRouting || wires.size() < PARALLEL_ROUTE_THRESHOLD || workerCount <= 1) {
+        for (size_t i = 0; i < wires.size(); i++) {
+            routes[i] = wires[i]->findRoute();
+        }
+    } else {
+        // Path finding only reads the item grid, so each wire can be routed independently. The results are applied
+        // in order afterwards, since that modifies this grid.
+        auto chunkSize = (wires.size() + workerCount - 1) / workerCount;
+        std::vector<std::future<void>> workers;
+        for (size_t chunkStart = 0; chunkStart < wires.size(); chunkStart += chunkSize) {
+            auto chunkEnd = std::min(chunkStart + chunkSize, wires.size());
+            workers.push_back(std::async(std::launch::async, [&wires, &routes, chunkStart, chunkEnd]() {
+                for (auto i = chunkStart; i < chunkEnd; i++) {
+                    routes[i] = wires[i]->findRoute();
+                }
+            }));
+        }
+        for (auto &worker : workers) {
+            worker.get();
+        }
+    }
+
+    // re-routed wires are always redrawn, as their endpoints may have moved within a cell
+    for (size_t i = 0; i < wires.size(); i++) {
+        wires[i]->setRoute(std::move(routes[i]));
+        _dirtyIndices.insert(wires[i]);
     }
 }
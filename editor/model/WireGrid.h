@@ -1,14 +1,14 @@
 #pragma once
 
-#include <QtCore/QHash>
 #include <QtCore/QPoint>
 #include <QtCore/QRect>
+#include <array>
+#include <unordered_set>
 #include <vector>
 
 #include "common/Event.h"
 #include "common/TrackedObject.h"
-
-inline uint qHash(const QPoint &);
+#include "grid/ChunkedGrid.h"
 
 namespace AxiomModel {
 
@@ -23,8 +23,6 @@ namespace AxiomModel {
     public:
         enum class Direction { HORIZONTAL, VERTICAL };
 
-        AxiomCommon::Event<> gridChanged;
-
         void addPoint(QPoint point, ConnectionWire *wire, Direction direction);
 
         void removePoint(QPoint point, ConnectionWire *wire);
@@ -35,16 +33,58 @@ namespace AxiomModel {
 
         LineIndex getRegionIndex(QRect region, ConnectionWire *wire);
 
+        // queues the wire to be re-routed on the next flush
+        void markRouteDirty(ConnectionWire *wire);
+
+        void removeWire(ConnectionWire *wire);
+
+        bool parallelRouting() const { return _parallelRouting; }
+
+        void setParallelRouting(bool parallelRouting) { _parallelRouting = parallelRouting; }
+
+        // re-routes queued wires, then updates the line indices of wires sharing a changed cell
         void tryFlush();
 
     private:
+        // most cells only have one or two wires running through them, so store those inline before using the heap
+        class WireList {
+        public:
+            ConnectionWire *const *begin() const { return data(); }
+
+            ConnectionWire *const *end() const { return data() + _size; }
+
+            size_t size() const { return _size; }
+
+            bool empty() const { return _size == 0; }
+
+            void push_back(ConnectionWire *wire);
+
+            void erase(ConnectionWire *const *pos);
+
+        private:
+            static constexpr size_t inlineCapacity = 2;
+
+            std::array<ConnectionWire *, inlineCapacity> _inline = {};
+            std::vector<ConnectionWire *> _spilled;
+            size_t _size = 0;
+
+            ConnectionWire *const *data() const { return _spilled.empty() ? _inline.data() : _spilled.data(); }
+        };
+
         struct CellLists {
-            std::vector<ConnectionWire *> horizontal;
-            std::vector<ConnectionWire *> vertical;
+            WireList horizontal;
+            WireList vertical;
         };
 
-        QHash<QPoint, CellLists> cells;
+        ChunkedGrid<CellLists, 4> cells;
+
+        std::vector<ConnectionWire *> _dirtyRoutes;
+        std::unordered_set<ConnectionWire *> _dirtyRouteSet;
+        std::unordered_set<ConnectionWire *> _dirtyIndices;
+        bool _parallelRouting = true;
+
+        void markCellDirty(const CellLists &lists);
 
-        bool _isDirty = false;
+        void rerouteDirty();
     };
 }
@@ -75,7 +75,13 @@ QString Action::typeToString(AxiomModel::Action::ActionType type) {
         return "Set Graph Tension";
     case ActionType::SET_NUM_RANGE:
         return "Set Num Range";
+    case ActionType::SET_NUM_FIXED:
+        return "Fix/Unfix Value";
     }
 
     unreachable;
 }
+
+size_t Action::memoryUsage() const {
+    return sizeof(*this);
+}
@@ -40,7 +40,8 @@ namespace AxiomModel {
             MOVE_GRAPH_POINT,
             SET_GRAPH_TAG,
             SET_GRAPH_TENSION,
-            SET_NUM_RANGE
+            SET_NUM_RANGE,
+            SET_NUM_FIXED
         };
 
         Action(ActionType actionType, ModelRoot *root);
@@ -55,6 +56,13 @@ namespace AxiomModel {
 
         virtual void backward() = 0;
 
+        // Roughly how many bytes the action is keeping alive, so the history can stay within a memory budget.
+        virtual size_t memoryUsage() const;
+
+        // Called when the action is far enough from the top of the history that it's unlikely to be run again soon,
+        // so it can trade speed for memory (e.g by compressing any snapshots it holds).
+        virtual void compact() {}
+
     private:
         ActionType _actionType;
         ModelRoot *_root;
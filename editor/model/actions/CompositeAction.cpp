@@ -21,3 +21,17 @@ void CompositeAction::backward() {
         (*i)->backward();
     }
 }
+
+size_t CompositeAction::memoryUsage() const {
+    auto usage = sizeof(*this);
+    for (const auto &action : _actions) {
+        usage += action->memoryUsage();
+    }
+    return usage;
+}
+
+void CompositeAction::compact() {
+    for (const auto &action : _actions) {
+        action->compact();
+    }
+}
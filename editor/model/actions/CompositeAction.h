@@ -16,6 +16,10 @@ namespace AxiomModel {
 
         void backward() override;
 
+        size_t memoryUsage() const override;
+
+        void compact() override;
+
         std::vector<std::unique_ptr<Action>> &actions() { return _actions; }
 
         const std::vector<std::unique_ptr<Action>> &actions() const { return _actions; }
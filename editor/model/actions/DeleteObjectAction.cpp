@@ -9,21 +9,25 @@
 
 using namespace AxiomModel;
 
-DeleteObjectAction::DeleteObjectAction(const QUuid &uuid, QByteArray buffer, AxiomModel::ModelRoot *root)
-    : Action(ActionType::DELETE_OBJECT, root), _uuid(uuid), _buffer(std::move(buffer)) {}
+DeleteObjectAction::DeleteObjectAction(const QUuid &uuid, QByteArray buffer, bool isBufferCompressed,
+                                       AxiomModel::ModelRoot *root)
+    : Action(ActionType::DELETE_OBJECT, root), _uuid(uuid), _buffer(std::move(buffer)),
+      _isBufferCompressed(isBufferCompressed) {}
 
 std::unique_ptr<DeleteObjectAction> DeleteObjectAction::create(const QUuid &uuid, QByteArray buffer,
-                                                               AxiomModel::ModelRoot *root) {
-    return std::make_unique<DeleteObjectAction>(uuid, std::move(buffer), root);
+                                                               bool isBufferCompressed, AxiomModel::ModelRoot *root) {
+    return std::make_unique<DeleteObjectAction>(uuid, std::move(buffer), isBufferCompressed, root);
 }
 
 std::unique_ptr<DeleteObjectAction> DeleteObjectAction::create(const QUuid &uuid, AxiomModel::ModelRoot *root) {
-    return create(uuid, QByteArray(), root);
+    return create(uuid, QByteArray(), false, root);
 }
 
 void DeleteObjectAction::forward(bool) {
     auto sortedItems = heapSort(getLinkedItems(_uuid));
 
+    _buffer.clear();
+    _isBufferCompressed = false;
     QDataStream stream(&_buffer, QIODevice::WriteOnly);
     ModelObjectSerializer::serializeChunk(stream, QUuid(), sortedItems);
 
@@ -46,11 +50,24 @@ void DeleteObjectAction::forward(bool) {
 }
 
 void DeleteObjectAction::backward() {
-    QDataStream stream(&_buffer, QIODevice::ReadOnly);
+    auto buffer = _isBufferCompressed ? qUncompress(_buffer) : _buffer;
+    QDataStream stream(&buffer, QIODevice::ReadOnly);
     IdentityReferenceMapper ref;
     auto addedObjects =
         ModelObjectSerializer::deserializeChunk(stream, ProjectSerializer::schemaVersion, root(), QUuid(), &ref, false);
     _buffer.clear();
+    _isBufferCompressed = false;
+}
+
+size_t DeleteObjectAction::memoryUsage() const {
+    return sizeof(*this) + (size_t) _buffer.capacity();
+}
+
+void DeleteObjectAction::compact() {
+    if (_isBufferCompressed || _buffer.isEmpty()) return;
+
+    _buffer = qCompress(_buffer);
+    _isBufferCompressed = true;
 }
 
 std::vector<ModelObject *> DeleteObjectAction::getLinkedItems(const QUuid &seed) const {
@@ -11,9 +11,9 @@ namespace AxiomModel {
 
     class DeleteObjectAction : public Action {
     public:
-        DeleteObjectAction(const QUuid &uuid, QByteArray buffer, AxiomModel::ModelRoot *root);
+        DeleteObjectAction(const QUuid &uuid, QByteArray buffer, bool isBufferCompressed, AxiomModel::ModelRoot *root);
 
-        static std::unique_ptr<DeleteObjectAction> create(const QUuid &uuid, QByteArray buffer,
+        static std::unique_ptr<DeleteObjectAction> create(const QUuid &uuid, QByteArray buffer, bool isBufferCompressed,
                                                           AxiomModel::ModelRoot *root);
 
         static std::unique_ptr<DeleteObjectAction> create(const QUuid &uuid, AxiomModel::ModelRoot *root);
@@ -22,13 +22,21 @@ namespace AxiomModel {
 
         void backward() override;
 
+        size_t memoryUsage() const override;
+
+        void compact() override;
+
         const QUuid &uuid() const { return _uuid; }
 
         const QByteArray &buffer() const { return _buffer; }
 
+        // Whether the buffer has been compressed with qCompress, which happens once the action is compacted.
+        bool isBufferCompressed() const { return _isBufferCompressed; }
+
     private:
         QUuid _uuid;
         QByteArray _buffer;
+        bool _isBufferCompressed;
 
         std::vector<ModelObject *> getLinkedItems(const QUuid &seed) const;
     };
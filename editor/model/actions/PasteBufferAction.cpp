@@ -13,27 +13,31 @@
 using namespace AxiomModel;
 
 PasteBufferAction::PasteBufferAction(const QUuid &surfaceUuid, bool isBufferFormatted, QByteArray buffer,
-                                     QVector<QUuid> usedUuids, QPoint center, AxiomModel::ModelRoot *root)
+                                     bool isBufferCompressed, QVector<QUuid> usedUuids, QPoint center,
+                                     AxiomModel::ModelRoot *root)
     : Action(ActionType::PASTE_BUFFER, root), _surfaceUuid(surfaceUuid), _isBufferFormatted(isBufferFormatted),
-      _buffer(std::move(buffer)), _usedUuids(std::move(usedUuids)), _center(center) {}
+      _buffer(std::move(buffer)), _isBufferCompressed(isBufferCompressed), _usedUuids(std::move(usedUuids)),
+      _center(center) {}
 
 std::unique_ptr<PasteBufferAction> PasteBufferAction::create(const QUuid &surfaceUuid, bool isBufferFormatted,
-                                                             QByteArray buffer, QVector<QUuid> usedUuids, QPoint center,
+                                                             QByteArray buffer, bool isBufferCompressed,
+                                                             QVector<QUuid> usedUuids, QPoint center,
                                                              AxiomModel::ModelRoot *root) {
-    return std::make_unique<PasteBufferAction>(surfaceUuid, isBufferFormatted, std::move(buffer), std::move(usedUuids),
-                                               center, root);
+    return std::make_unique<PasteBufferAction>(surfaceUuid, isBufferFormatted, std::move(buffer), isBufferCompressed,
+                                               std::move(usedUuids), center, root);
 }
 
 std::unique_ptr<PasteBufferAction> PasteBufferAction::create(const QUuid &surfaceUuid, QByteArray buffer, QPoint center,
                                                              AxiomModel::ModelRoot *root) {
-    return create(surfaceUuid, false, std::move(buffer), QVector<QUuid>(), center, root);
+    return create(surfaceUuid, false, std::move(buffer), false, QVector<QUuid>(), center, root);
 }
 
 void PasteBufferAction::forward(bool) {
     assert(!_buffer.isEmpty());
     assert(_usedUuids.isEmpty());
 
-    QDataStream stream(&_buffer, QIODevice::ReadOnly);
+    auto buffer = _isBufferCompressed ? qUncompress(_buffer) : _buffer;
+    QDataStream stream(&buffer, QIODevice::ReadOnly);
     QPoint objectCenter;
     stream >> objectCenter;
 
@@ -55,6 +59,7 @@ void PasteBufferAction::forward(bool) {
 
     _isBufferFormatted = true;
     _buffer.clear();
+    _isBufferCompressed = false;
 
     for (const auto &obj : used) {
         if (auto node = dynamic_cast<Node *>(obj); node && obj->parentUuid() == _surfaceUuid) {
@@ -92,3 +97,14 @@ void PasteBufferAction::backward() {
         (*objs.begin())->remove();
     }
 }
+
+size_t PasteBufferAction::memoryUsage() const {
+    return sizeof(*this) + (size_t) _buffer.capacity() + (size_t) _usedUuids.capacity() * sizeof(QUuid);
+}
+
+void PasteBufferAction::compact() {
+    if (_isBufferCompressed || _buffer.isEmpty()) return;
+
+    _buffer = qCompress(_buffer);
+    _isBufferCompressed = true;
+}
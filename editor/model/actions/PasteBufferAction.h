@@ -11,12 +11,12 @@ namespace AxiomModel {
 
     class PasteBufferAction : public Action {
     public:
-        PasteBufferAction(const QUuid &surfaceUuid, bool isBufferFormatted, QByteArray buffer, QVector<QUuid> usedUuids,
-                          QPoint center, ModelRoot *root);
+        PasteBufferAction(const QUuid &surfaceUuid, bool isBufferFormatted, QByteArray buffer, bool isBufferCompressed,
+                          QVector<QUuid> usedUuids, QPoint center, ModelRoot *root);
 
         static std::unique_ptr<PasteBufferAction> create(const QUuid &surfaceUuid, bool isBufferFormatted,
-                                                         QByteArray buffer, QVector<QUuid> usedUuids, QPoint center,
-                                                         ModelRoot *root);
+                                                         QByteArray buffer, bool isBufferCompressed,
+                                                         QVector<QUuid> usedUuids, QPoint center, ModelRoot *root);
 
         static std::unique_ptr<PasteBufferAction> create(const QUuid &surfaceUuid, QByteArray buffer, QPoint center,
                                                          ModelRoot *root);
@@ -25,12 +25,19 @@ namespace AxiomModel {
 
         void backward() override;
 
+        size_t memoryUsage() const override;
+
+        void compact() override;
+
         const QUuid &surfaceUuid() const { return _surfaceUuid; }
 
         const bool &isBufferFormatted() const { return _isBufferFormatted; }
 
         const QByteArray &buffer() const { return _buffer; }
 
+        // Whether the buffer has been compressed with qCompress, which happens once the action is compacted.
+        bool isBufferCompressed() const { return _isBufferCompressed; }
+
         const QVector<QUuid> &usedUuids() const { return _usedUuids; }
 
         const QPoint &center() const { return _center; }
@@ -39,6 +46,7 @@ namespace AxiomModel {
         QUuid _surfaceUuid;
         bool _isBufferFormatted;
         QByteArray _buffer;
+        bool _isBufferCompressed;
         QVector<QUuid> _usedUuids;
         QPoint _center;
     };
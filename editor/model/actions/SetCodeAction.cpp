@@ -38,3 +38,17 @@ void SetCodeAction::backward() {
         (*rit)->backward();
     }
 }
+
+size_t SetCodeAction::memoryUsage() const {
+    auto usage = sizeof(*this) + (size_t)(_oldCode.capacity() + _newCode.capacity()) * sizeof(QChar);
+    for (const auto &action : _controlActions) {
+        usage += action->memoryUsage();
+    }
+    return usage;
+}
+
+void SetCodeAction::compact() {
+    for (const auto &action : _controlActions) {
+        action->compact();
+    }
+}
@@ -20,6 +20,10 @@ namespace AxiomModel {
 
         void backward() override;
 
+        size_t memoryUsage() const override;
+
+        void compact() override;
+
         const QUuid &uuid() const { return _uuid; }
 
         const QString &oldCode() const { return _oldCode; }
@@ -0,0 +1,23 @@
+#include "SetNumFixedAction.h"
+
+#include "../ModelRoot.h"
+#include "../PoolOperators.h"
+#include "../objects/NumControl.h"
+
+using namespace AxiomModel;
+
+SetNumFixedAction::SetNumFixedAction(const QUuid &uuid, bool beforeVal, bool afterVal, AxiomModel::ModelRoot *root)
+    : Action(ActionType::SET_NUM_FIXED, root), _uuid(uuid), _beforeVal(beforeVal), _afterVal(afterVal) {}
+
+std::unique_ptr<SetNumFixedAction> SetNumFixedAction::create(const QUuid &uuid, bool beforeVal, bool afterVal,
+                                                             AxiomModel::ModelRoot *root) {
+    return std::make_unique<SetNumFixedAction>(uuid, beforeVal, afterVal, root);
+}
+
+void SetNumFixedAction::forward(bool) {
+    find(AxiomCommon::dynamicCast<NumControl *>(root()->controls().sequence()), _uuid)->setFixed(_afterVal);
+}
+
+void SetNumFixedAction::backward() {
+    find(AxiomCommon::dynamicCast<NumControl *>(root()->controls().sequence()), _uuid)->setFixed(_beforeVal);
+}
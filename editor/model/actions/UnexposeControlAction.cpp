@@ -32,3 +32,11 @@ void UnexposeControlAction::forward(bool first) {
 void UnexposeControlAction::backward() {
     _deleteExposerAction->backward();
 }
+
+size_t UnexposeControlAction::memoryUsage() const {
+    return sizeof(*this) + _deleteExposerAction->memoryUsage();
+}
+
+void UnexposeControlAction::compact() {
+    _deleteExposerAction->compact();
+}
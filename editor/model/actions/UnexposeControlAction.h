@@ -20,6 +20,10 @@ namespace AxiomModel {
 
         void backward() override;
 
+        size_t memoryUsage() const override;
+
+        void compact() override;
+
         const QUuid &controlUuid() const { return _controlUuid; }
 
         DeleteObjectAction *deleteExposerAction() const { return _deleteExposerAction.get(); }
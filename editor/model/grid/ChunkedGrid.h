@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QtCore/QPoint>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace std {
+    template<>
+    struct hash<QPoint> {
+        std::size_t operator()(const QPoint &p) const {
+            // pack both coordinates so nearby points don't collide
+            return std::hash<uint64_t>()(((uint64_t)(uint32_t) p.x() << 32) | (uint32_t) p.y());
+        }
+    };
+}
+
+namespace AxiomModel {
+
+    // Sparse grid storage split into dense square tiles, so that looking up a cell is one hash lookup for the tile
+    // followed by an array index, and neighbouring cells share the same tile. Tiles are allocated when a cell in them
+    // is first set, and freed once all of their cells have been erased.
+    template<class T, int TileBits = 6>
+    class ChunkedGrid {
+    public:
+        static constexpr int tileSize = 1 << TileBits;
+        static constexpr size_t tileCellCount = (size_t) tileSize * tileSize;
+
+        bool isSet(QPoint pos) const { return find(pos) != nullptr; }
+
+        const T *find(QPoint pos) const {
+            auto tile = tiles.find(tileIndex(pos));
+            if (tile == tiles.end()) return nullptr;
+
+            auto index = cellIndex(pos);
+            if (!tile->second->occupied[index]) return nullptr;
+            return &tile->second->cells[index];
+        }
+
+        T *find(QPoint pos) {
+            return const_cast<T *>(static_cast<const ChunkedGrid *>(this)->find(pos));
+        }
+
+        // returns the cell at the position, default-constructing it if it isn't set
+        T &get(QPoint pos) {
+            auto &tile = tiles[tileIndex(pos)];
+            if (!tile) tile = std::make_unique<Tile>();
+
+            auto index = cellIndex(pos);
+            tile->occupied[index] = true;
+            return tile->cells[index];
+        }
+
+        void erase(QPoint pos) {
+            auto tile = tiles.find(tileIndex(pos));
+            if (tile == tiles.end()) return;
+
+            auto index = cellIndex(pos);
+            if (!tile->second->occupied[index]) return;
+
+            tile->second->occupied[index] = false;
+            if (tile->second->occupied.none()) {
+                tiles.erase(tile);
+            } else {
+                tile->second->cells[index] = T();
+            }
+        }
+
+        void clear() { tiles.clear(); }
+
+    private:
+        struct Tile {
+            std::array<T, tileCellCount> cells = {};
+            std::bitset<tileCellCount> occupied;
+        };
+
+        std::unordered_map<QPoint, std::unique_ptr<Tile>> tiles;
+
+        static QPoint tileIndex(QPoint pos) { return QPoint(pos.x() >> TileBits, pos.y() >> TileBits); }
+
+        static size_t cellIndex(QPoint pos) {
+            return (size_t)(pos.y() & (tileSize - 1)) * tileSize + (size_t)(pos.x() & (tileSize - 1));
+        }
+    };
+}
@@ -11,14 +11,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
-namespace std {
-    template<>
-    struct hash<QPoint> {
-        std::size_t operator()(const QPoint &p) const {
-            return std::hash<int>()(p.x()) ^ (std::hash<int>()(p.y()) >> 1);
-        }
-    };
-}
+#include "ChunkedGrid.h"
 
 namespace AxiomModel {
 
@@ -147,8 +140,7 @@ namespace AxiomModel {
             if (!isInsideRect(pos)) return nullptr;
 
             auto cell = cells.find(pos);
-            if (cell == cells.end()) return nullptr;
-            return cell->second;
+            return cell ? *cell : nullptr;
         }
 
         void setCell(QPoint pos, T *item) {
@@ -156,8 +148,8 @@ namespace AxiomModel {
 
             if (item == nullptr)
                 cells.erase(pos);
-            else
-                cells.emplace(pos, item);
+            else if (!cells.isSet(pos))
+                cells.get(pos) = item;
         }
 
         void setRect(QPoint pos, QSize size, T *item) {
@@ -214,6 +206,6 @@ namespace AxiomModel {
             VisitedCell(QPoint from, float cost) : from(from), cost(cost) {}
         };
 
-        std::unordered_map<QPoint, T *> cells;
+        ChunkedGrid<T *> cells;
     };
 }
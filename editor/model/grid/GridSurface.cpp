@@ -46,8 +46,10 @@ void GridSurface::startDragging() {
 void GridSurface::dragTo(QPoint delta) {
     if (delta == lastDragDelta) return;
 
+    QRect changedRegion;
     auto selectedItms = selectedItems();
     for (auto &item : selectedItms.sequence()) {
+        changedRegion |= QRect(item->pos(), item->size());
         _grid.setRect(item->pos(), item->size(), nullptr);
     }
 
@@ -58,9 +60,10 @@ void GridSurface::dragTo(QPoint delta) {
     }
 
     for (auto &item : selectedItms.sequence()) {
+        changedRegion |= QRect(item->pos(), item->size());
         _grid.setRect(item->pos(), item->size(), item);
     }
-    setDirty();
+    setDirty(changedRegion);
 }
 
 void GridSurface::finishDragging() {
@@ -70,19 +73,19 @@ void GridSurface::finishDragging() {
     }
 }
 
-void GridSurface::setDirty() {
-    if (_deferDirty) {
-        _isDirty = true;
-    } else {
-        gridChanged();
-        _isDirty = false;
+void GridSurface::setDirty(QRect region) {
+    _dirtyRegion |= region;
+    if (!_deferDirty) {
+        tryFlush();
     }
 }
 
 void GridSurface::tryFlush() {
-    if (_isDirty) {
-        gridChanged();
-        _isDirty = false;
+    if (!_dirtyRegion.isNull()) {
+        // reset before emitting, so listeners that modify the grid queue up a new region
+        auto region = _dirtyRegion;
+        _dirtyRegion = QRect();
+        gridChanged(region);
     }
 }
 
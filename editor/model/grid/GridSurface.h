@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QPointF>
+#include <QtCore/QRect>
 #include <QtCore/QString>
 #include <climits>
 #include <memory>
@@ -26,7 +27,7 @@ namespace AxiomModel {
 
         AxiomCommon::Event<GridItem *> itemAdded;
         AxiomCommon::Event<bool> hasSelectionChanged;
-        AxiomCommon::Event<> gridChanged;
+        AxiomCommon::Event<const QRect &> gridChanged;
 
         GridSurface(BoxedItemCollection view, bool deferDirty, QPoint minRect = QPoint(INT_MIN, INT_MIN),
                     QPoint maxRect = QPoint(INT_MAX, INT_MAX));
@@ -62,7 +63,8 @@ namespace AxiomModel {
 
         void finishDragging();
 
-        void setDirty();
+        // marks the provided cells as changed, gridChanged is emitted with the union of all changed regions
+        void setDirty(QRect region);
 
         void tryFlush();
 
@@ -71,7 +73,7 @@ namespace AxiomModel {
         BoxedItemCollection _items;
         BoxedItemCollection _selectedItems;
         bool _deferDirty;
-        bool _isDirty = false;
+        QRect _dirtyRegion;
 
         QPoint lastDragDelta;
 
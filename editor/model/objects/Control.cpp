@@ -14,6 +14,7 @@
 #include "MidiControl.h"
 #include "NumControl.h"
 #include "PortalControl.h"
+#include "ScopeControl.h"
 #include "editor/compiler/interface/Runtime.h"
 
 using namespace AxiomModel;
@@ -67,6 +68,8 @@ QSize Control::getDefaultSize(AxiomModel::Control::ControlType controlType) {
         return QSize(2, 2);
     case ControlType::GRAPH:
         return QSize(6, 4);
+    case ControlType::SCOPE:
+        return QSize(6, 4);
     }
     unreachable;
 }
@@ -78,7 +81,7 @@ std::unique_ptr<Control> Control::createDefault(AxiomModel::Control::ControlType
     case Control::ControlType::NUM_SCALAR:
         return NumControl::create(uuid, parentUuid, pos, size, false, name, true, QUuid(), exposingUuid,
                                   isWrittenTo ? NumControl::DisplayMode::PLUG : NumControl::DisplayMode::KNOB, 0, 1, 0,
-                                  {0, 0, FormType::CONTROL}, root);
+                                  {0, 0, FormType::CONTROL}, false, root);
     case Control::ControlType::MIDI_SCALAR:
         return MidiControl::create(uuid, parentUuid, pos, size, false, name, true, QUuid(), exposingUuid, root);
     case Control::ControlType::NUM_EXTRACT:
@@ -90,6 +93,8 @@ std::unique_ptr<Control> Control::createDefault(AxiomModel::Control::ControlType
     case Control::ControlType::GRAPH:
         return GraphControl::create(uuid, parentUuid, pos, size, false, name, true, QUuid(), exposingUuid,
                                     std::make_unique<GraphControlCurveState>(), root);
+    case Control::ControlType::SCOPE:
+        return ScopeControl::create(uuid, parentUuid, pos, size, false, name, true, QUuid(), exposingUuid, root);
     default:
         unreachable;
     }
@@ -100,7 +105,8 @@ std::unique_ptr<Control> Control::createExposed(AxiomModel::Control *base, const
     if (auto numControl = dynamic_cast<NumControl *>(base)) {
         return NumControl::create(uuid, parentUuid, pos, size, false, numControl->name(), numControl->showName(),
                                   QUuid(), numControl->uuid(), numControl->displayMode(), numControl->minValue(),
-                                  numControl->maxValue(), numControl->step(), numControl->value(), numControl->root());
+                                  numControl->maxValue(), numControl->step(), numControl->value(),
+                                  numControl->isFixed(), numControl->root());
     } else {
         auto isWrittenTo = base->compileMeta() ? base->compileMeta()->writtenTo : false;
         return createDefault(base->controlType(), uuid, parentUuid, base->name(), base->uuid(), pos, size, isWrittenTo,
@@ -41,7 +41,16 @@ namespace AxiomModel {
 
     class Control : public GridItem, public ModelObject {
     public:
-        enum class ControlType { NUM_SCALAR, MIDI_SCALAR, NUM_EXTRACT, MIDI_EXTRACT, NUM_PORTAL, MIDI_PORTAL, GRAPH };
+        enum class ControlType {
+            NUM_SCALAR,
+            MIDI_SCALAR,
+            NUM_EXTRACT,
+            MIDI_EXTRACT,
+            NUM_PORTAL,
+            MIDI_PORTAL,
+            GRAPH,
+            SCOPE
+        };
 
         AxiomCommon::Event<const QString &> nameChanged;
         AxiomCommon::Event<bool> showNameChanged;
@@ -18,6 +18,9 @@
 
 using namespace AxiomModel;
 
+// how long to wait after the last edit before compiling in the background
+static constexpr std::chrono::milliseconds buildDebounce(200);
+
 CustomNode::CustomNode(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size, bool selected, QString name,
                        const QUuid &controlsUuid, QString code, bool panelOpen, float panelHeight,
                        AxiomModel::ModelRoot *root)
@@ -43,14 +46,20 @@ void CustomNode::setCode(const QString &code) {
     if (_code != code) {
         _code = code;
         codeChanged(code);
-        buildCode();
+        queueBuild();
     }
 }
 
 void CustomNode::promoteStaging() {
+    // the staging block needs to match the current code, if the background build hasn't caught up do it now
+    if (!_stagingCurrent) {
+        buildCode();
+    }
+
     if (_stagingBlock) {
         _compiledBlock = std::move(_stagingBlock);
         _stagingBlock = std::nullopt;
+        _stagingCurrent = false;
         setDirty();
         surface()->forceCompile();
     } else {
@@ -122,6 +131,11 @@ void CustomNode::build(MaximCompiler::Transaction *transaction) {
     transaction->buildBlock(_compiledBlock->clone());
 }
 
+void CustomNode::doRuntimeUpdate() {
+    Node::doRuntimeUpdate();
+    pollBuild();
+}
+
 struct NewControl {
     Control::ControlType type;
     QString name;
@@ -238,20 +252,54 @@ void CustomNode::surfaceControlAdded(AxiomModel::Control *control) {
     }
 }
 
+void CustomNode::queueBuild() {
+    _codeGeneration++;
+    _stagingCurrent = false;
+    _buildQueued = true;
+    _buildQueuedUntil = std::chrono::steady_clock::now() + buildDebounce;
+}
+
+void CustomNode::pollBuild() {
+    if (_pendingBuild && _pendingBuild->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        auto build = _pendingBuild->get();
+        _pendingBuild.reset();
+        if (build.generation == _codeGeneration) {
+            applyBuild(std::move(build));
+        }
+    }
+
+    // only one build runs at a time, a queued one starts once the running one is done
+    if (_buildQueued && !_pendingBuild && std::chrono::steady_clock::now() >= _buildQueuedUntil) {
+        _buildQueued = false;
+        _pendingBuild = std::async(std::launch::async, &CustomNode::compileCode, _codeGeneration, getRuntimeId(),
+                                   name(), code());
+    }
+}
+
 void CustomNode::buildCode() {
-    MaximCompiler::Block block;
-    MaximCompiler::Error error;
+    // anything queued or running is now out of date
+    _codeGeneration++;
+    _buildQueued = false;
+    applyBuild(compileCode(_codeGeneration, getRuntimeId(), name(), code()));
+}
+
+CustomNode::CodeBuild CustomNode::compileCode(uint64_t generation, uint64_t runtimeId, QString name, QString code) {
+    CodeBuild build{generation, false, MaximCompiler::Block(), MaximCompiler::Error()};
+    build.success = MaximCompiler::Block::compile(runtimeId, name, code, &build.block, &build.error);
+    return build;
+}
 
-    auto compileSuccess = MaximCompiler::Block::compile(getRuntimeId(), name(), code(), &block, &error);
+void CustomNode::applyBuild(AxiomModel::CustomNode::CodeBuild build) {
+    _stagingCurrent = true;
 
-    if (compileSuccess) {
-        _stagingBlock = std::move(block);
+    if (build.success) {
+        _stagingBlock = std::move(build.block);
         _compileError.reset();
         codeCompileSuccess();
         setInErrorState(false);
     } else {
-        auto errorDescription = error.getDescription();
-        auto errorRange = error.getRange();
+        auto errorDescription = build.error.getDescription();
+        auto errorRange = build.error.getRange();
         std::cerr << "Error at " << errorRange.front.line << ":" << errorRange.front.column << " -> "
                   << errorRange.back.line << ":" << errorRange.back.column << " : " << errorDescription.toStdString()
                   << std::endl;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <future>
 #include <optional>
 
 #include "Node.h"
@@ -68,7 +70,16 @@ namespace AxiomModel {
 
         void build(MaximCompiler::Transaction *transaction) override;
 
+        void doRuntimeUpdate() override;
+
     private:
+        struct CodeBuild {
+            uint64_t generation;
+            bool success;
+            MaximCompiler::Block block;
+            MaximCompiler::Error error;
+        };
+
         QString _code;
         bool _isPanelOpen;
         float _panelHeight;
@@ -80,10 +91,26 @@ namespace AxiomModel {
         std::optional<MaximCompiler::Block> _stagingBlock;
         std::optional<CustomNodeError> _compileError;
 
+        // Edits are compiled on a worker once typing has paused. Every edit bumps the generation, and a build is only
+        // applied if it was started from the current generation, so results for outdated code are thrown away.
+        uint64_t _codeGeneration = 0;
+        bool _stagingCurrent = false;
+        bool _buildQueued = false;
+        std::chrono::steady_clock::time_point _buildQueuedUntil;
+        std::optional<std::future<CodeBuild>> _pendingBuild;
+
         void updateControls(SetCodeAction *action);
 
         void surfaceControlAdded(Control *control);
 
+        void queueBuild();
+
+        void pollBuild();
+
         void buildCode();
+
+        void applyBuild(CodeBuild build);
+
+        static CodeBuild compileCode(uint64_t generation, uint64_t runtimeId, QString name, QString code);
     };
 }
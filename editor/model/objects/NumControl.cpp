@@ -2,20 +2,25 @@
 
 #include "../ModelRoot.h"
 #include "../PoolOperators.h"
+#include "ControlSurface.h"
+#include "Node.h"
+#include "NodeSurface.h"
 
 using namespace AxiomModel;
 
 NumControl::NumControl(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size, bool selected, QString name,
                        bool showName, const QUuid &exposerUuid, const QUuid &exposingUuid, DisplayMode displayMode,
-                       float minValue, float maxValue, uint32_t step, NumValue value, ModelRoot *root)
+                       float minValue, float maxValue, uint32_t step, NumValue value, bool isFixed, ModelRoot *root)
     : Control(ControlType::NUM_SCALAR, ConnectionWire::WireType::NUM, QSize(1, 1), uuid, parentUuid, pos, size,
               selected, std::move(name), showName, exposerUuid, exposingUuid, root),
-      _displayMode(displayMode), _minValue(minValue), _maxValue(maxValue), _step(step), _value(value) {
+      _displayMode(displayMode), _minValue(minValue), _maxValue(maxValue), _step(step), _value(value),
+      _isFixed(isFixed) {
     if (!exposingUuid.isNull()) {
         findLater(AxiomCommon::dynamicCastWatch<NumControl *>(root->controls()), exposingUuid)
             ->then([this](NumControl *exposing) {
                 exposing->displayModeChanged.connect(this, &NumControl::setDisplayMode);
                 exposing->rangeChanged.connect(this, &NumControl::setRange);
+                exposing->isFixedChanged.connect(this, &NumControl::setFixed);
             });
     }
 }
@@ -24,10 +29,10 @@ std::unique_ptr<NumControl> NumControl::create(const QUuid &uuid, const QUuid &p
                                                bool selected, QString name, bool showName, const QUuid &exposerUuid,
                                                const QUuid &exposingUuid,
                                                AxiomModel::NumControl::DisplayMode displayMode, float minValue,
-                                               float maxValue, uint32_t step, NumValue value,
+                                               float maxValue, uint32_t step, NumValue value, bool isFixed,
                                                AxiomModel::ModelRoot *root) {
     return std::make_unique<NumControl>(uuid, parentUuid, pos, size, selected, std::move(name), showName, exposerUuid,
-                                        exposingUuid, displayMode, minValue, maxValue, step, value, root);
+                                        exposingUuid, displayMode, minValue, maxValue, step, value, isFixed, root);
 }
 
 QString NumControl::debugName() {
@@ -64,7 +69,63 @@ void NumControl::setRange(float minValue, float maxValue, uint32_t step) {
     }
 }
 
+void NumControl::setFixed(bool isFixed) {
+    // if we're exposing, set it on the underlying control
+    if (!exposingUuid().isNull()) {
+        auto exposingControl = dynamic_cast<NumControl *>(find(root()->controls().sequence(), exposingUuid()));
+        assert(exposingControl);
+        exposingControl->setFixed(isFixed);
+    }
+
+    if (isFixed != _isFixed) {
+        _isFixed = isFixed;
+        isFixedChanged(isFixed);
+        surface()->node()->surface()->forceCompile();
+    }
+}
+
+void NumControl::beginValueChange() {
+    // if we're exposing, set it on the underlying control
+    if (!exposingUuid().isNull()) {
+        auto exposingControl = dynamic_cast<NumControl *>(find(root()->controls().sequence(), exposingUuid()));
+        assert(exposingControl);
+        exposingControl->beginValueChange();
+    }
+
+    if (!_isChangingValue) {
+        _isChangingValue = true;
+
+        // switch to the generic code right away, so the change can be heard while it's happening
+        if (_isFixed) {
+            surface()->node()->surface()->forceCompile();
+            root()->compileDirtyItems();
+        }
+    }
+}
+
+void NumControl::endValueChange() {
+    // if we're exposing, set it on the underlying control
+    if (!exposingUuid().isNull()) {
+        auto exposingControl = dynamic_cast<NumControl *>(find(root()->controls().sequence(), exposingUuid()));
+        assert(exposingControl);
+        exposingControl->endValueChange();
+    }
+
+    if (_isChangingValue) {
+        _isChangingValue = false;
+
+        if (_isFixed) {
+            surface()->node()->surface()->forceCompile();
+            root()->compileDirtyItems();
+        }
+    }
+}
+
 void NumControl::setValue(NumValue value) {
+    if (_isFixed && !_isChangingValue && value != _value) {
+        surface()->node()->surface()->forceCompile();
+    }
+
     setInternalValue(value);
     restoreState();
 }
@@ -13,15 +13,17 @@ namespace AxiomModel {
         AxiomCommon::Event<DisplayMode> displayModeChanged;
         AxiomCommon::Event<float, float, uint32_t> rangeChanged;
         AxiomCommon::Event<const NumValue &> valueChanged;
+        AxiomCommon::Event<bool> isFixedChanged;
 
         NumControl(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size, bool selected, QString name,
                    bool showName, const QUuid &exposerUuid, const QUuid &exposingUuid, DisplayMode displayMode,
-                   float minValue, float maxValue, uint32_t step, NumValue value, ModelRoot *root);
+                   float minValue, float maxValue, uint32_t step, NumValue value, bool isFixed, ModelRoot *root);
 
         static std::unique_ptr<NumControl> create(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size,
                                                   bool selected, QString name, bool showName, const QUuid &exposerUuid,
                                                   const QUuid &exposingUuid, DisplayMode displayMode, float minValue,
-                                                  float maxValue, uint32_t step, NumValue value, ModelRoot *root);
+                                                  float maxValue, uint32_t step, NumValue value, bool isFixed,
+                                                  ModelRoot *root);
 
         QString debugName() override;
 
@@ -39,6 +41,19 @@ namespace AxiomModel {
 
         const NumValue &value() const { return _value; }
 
+        // A fixed control's value is compiled into the nodes that read it, so changing it needs a recompile.
+        bool isFixed() const { return _isFixed; }
+
+        void setFixed(bool isFixed);
+
+        // While the user is dragging or scrolling the value it changes too often to recompile each time, so a fixed
+        // control is compiled like any other until the change ends, and then specialized on the final value.
+        bool isChangingValue() const { return _isChangingValue; }
+
+        void beginValueChange();
+
+        void endValueChange();
+
         void doRuntimeUpdate() override;
 
         void saveState() override;
@@ -53,6 +68,8 @@ namespace AxiomModel {
         float _maxValue;
         uint32_t _step;
         NumValue _value;
+        bool _isFixed;
+        bool _isChangingValue = false;
 
         void setInternalValue(NumValue value);
     };
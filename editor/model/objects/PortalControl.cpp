@@ -1,6 +1,7 @@
 #include "PortalControl.h"
 
 #include "../../util.h"
+#include "../ModelRoot.h"
 
 using namespace AxiomModel;
 
@@ -21,7 +22,10 @@ PortalControl::PortalControl(const QUuid &uuid, const QUuid &parentUuid, QPoint
                              AxiomModel::ModelRoot *root)
     : Control(typeFromWireType(wireType), wireType, QSize(1, 1), uuid, parentUuid, pos, size, selected, std::move(name),
               showName, exposerUuid, exposingUuid, root),
-      _portalType(portalType), _portalId(portalId) {}
+      _portalType(portalType), _portalId(portalId) {
+    // the backend remaps portals whenever the runtime is reconfigured, which can change the label
+    root->configurationChanged.connect(this, &PortalControl::invalidateLabel);
+}
 
 std::unique_ptr<PortalControl> PortalControl::create(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size,
                                                      bool selected, QString name, bool showName,
@@ -37,7 +41,7 @@ QString PortalControl::debugName() {
     return "PortalControl '" + name() + "'";
 }
 
-void PortalControl::restoreState() {
+void PortalControl::invalidateLabel() {
     _needsLabelUpdate = true;
     labelWillChange();
 }
@@ -31,8 +31,6 @@ namespace AxiomModel {
 
         void doRuntimeUpdate() override {}
 
-        void restoreState() override;
-
         bool needsLabelUpdate() const { return _needsLabelUpdate; }
 
         const QString &portalLabel() const { return _portalLabel; }
@@ -44,5 +42,7 @@ namespace AxiomModel {
         uint64_t _portalId;
         bool _needsLabelUpdate = true;
         QString _portalLabel;
+
+        void invalidateLabel();
     };
 }
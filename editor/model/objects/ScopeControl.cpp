@@ -0,0 +1,175 @@
+#include "ScopeControl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+using namespace AxiomModel;
+
+static constexpr float PI = 3.14159265358979f;
+
+// Pairs with the release store of the index on the audio thread, so every point before it can be read.
+static uint32_t loadWriteIndex(const ScopeControlCapture *capture) {
+    return capture->writeIndex.load(std::memory_order_acquire);
+}
+
+// In-place radix-2 FFT, the same as the one used to load impulse responses in the compiler.
+static void transform(std::vector<std::complex<float>> &values) {
+    auto size = values.size();
+    size_t reversed = 0;
+    for (size_t index = 0; index < size; index++) {
+        if (index < reversed) std::swap(values[index], values[reversed]);
+        auto bit = size >> 1;
+        while (reversed & bit) {
+            reversed ^= bit;
+            bit >>= 1;
+        }
+        reversed |= bit;
+    }
+
+    for (size_t half = 1; half < size; half *= 2) {
+        for (size_t start = 0; start < size; start += half * 2) {
+            for (size_t offset = 0; offset < half; offset++) {
+                auto twiddle = std::polar(1.f, -PI * offset / half);
+                auto top = start + offset;
+                auto bottom = top + half;
+                auto t = values[bottom] * twiddle;
+                values[bottom] = values[top] - t;
+                values[top] += t;
+            }
+        }
+    }
+}
+
+ScopeControl::ScopeControl(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size, bool selected,
+                           QString name, bool showName, const QUuid &exposerUuid, const QUuid &exposingUuid,
+                           AxiomModel::ModelRoot *root)
+    : Control(ControlType::SCOPE, ConnectionWire::WireType::NUM, QSize(4, 3), uuid, parentUuid, pos, size, selected,
+              std::move(name), showName, exposerUuid, exposingUuid, root),
+      _history(SCOPE_CONTROL_BUFFER_SIZE) {}
+
+std::unique_ptr<ScopeControl> ScopeControl::create(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size,
+                                                   bool selected, QString name, bool showName, const QUuid &exposerUuid,
+                                                   const QUuid &exposingUuid, AxiomModel::ModelRoot *root) {
+    return std::make_unique<ScopeControl>(uuid, parentUuid, pos, size, selected, std::move(name), showName, exposerUuid,
+                                          exposingUuid, root);
+}
+
+QString ScopeControl::debugName() {
+    return "ScopeControl '" + name() + "'";
+}
+
+void ScopeControl::doRuntimeUpdate() {
+    auto capture = getCapture();
+    if (!capture) return;
+
+    auto writeIndex = loadWriteIndex(capture);
+    auto newPoints = std::min((size_t) (writeIndex - _lastWriteIndex), SCOPE_CONTROL_BUFFER_SIZE);
+    if (newPoints == 0) return;
+
+    for (auto index = writeIndex - (uint32_t) newPoints; index != writeIndex; index++) {
+        _history[_historyEnd] = capture->points[index % SCOPE_CONTROL_BUFFER_SIZE];
+        _historyEnd = (_historyEnd + 1) % SCOPE_CONTROL_BUFFER_SIZE;
+    }
+    _lastWriteIndex = writeIndex;
+    _validPoints = std::min(_validPoints + newPoints, SCOPE_CONTROL_BUFFER_SIZE);
+
+    // The audio thread keeps writing while points are copied, replacing the oldest ones in the buffer. If any of those
+    // were copied they're out of order, so they're dropped along with everything before them.
+    auto writtenWhileCopying = (size_t) (loadWriteIndex(capture) - writeIndex);
+    auto untouchedPoints = SCOPE_CONTROL_BUFFER_SIZE - newPoints;
+    if (writtenWhileCopying > untouchedPoints) {
+        auto overwrittenPoints = std::min(writtenWhileCopying - untouchedPoints, newPoints);
+        _validPoints = std::min(_validPoints, newPoints - overwrittenPoints);
+    }
+
+    captureChanged();
+}
+
+void ScopeControl::restoreState() {
+    auto capture = getCapture();
+    if (!capture) return;
+
+    capture->decimation.store(_decimation, std::memory_order_relaxed);
+
+    // the capture buffer is new if the patch was rebuilt, so only points written after this are read from it
+    if (capture != _lastCapture) {
+        _lastCapture = capture;
+        _lastWriteIndex = loadWriteIndex(capture);
+    }
+}
+
+ScopeControlCapture *ScopeControl::getCapture() const {
+    if (runtimePointers()) {
+        return (ScopeControlCapture *) runtimePointers()->ui;
+    } else {
+        return nullptr;
+    }
+}
+
+void ScopeControl::setDisplayMode(AxiomModel::ScopeControl::DisplayMode displayMode) {
+    if (displayMode != _displayMode) {
+        _displayMode = displayMode;
+        displayModeChanged(displayMode);
+    }
+}
+
+void ScopeControl::setDecimation(uint32_t decimation) {
+    if (decimation != _decimation) {
+        _decimation = decimation;
+        if (auto capture = getCapture()) capture->decimation.store(decimation, std::memory_order_relaxed);
+
+        // points at the old rate would look squashed or stretched next to the new ones
+        _validPoints = 0;
+        decimationChanged(decimation);
+    }
+}
+
+std::vector<ScopeControlPoint> ScopeControl::waveform(size_t pointCount) const {
+    pointCount = std::min(pointCount, _validPoints);
+    if (pointCount == 0) return {};
+
+    // Find the newest point where the left channel rises through the trigger level that still has enough points after
+    // it to fill the view, so periodic signals stay in the same place. Without one the newest points are shown.
+    auto startAge = pointCount - 1;
+    for (auto age = startAge; age + 1 < _validPoints; age++) {
+        if (historyPoint(age + 1).left < _triggerLevel && historyPoint(age).left >= _triggerLevel) {
+            startAge = age;
+            break;
+        }
+    }
+
+    std::vector<ScopeControlPoint> points;
+    points.reserve(pointCount);
+    for (size_t i = 0; i < pointCount; i++) {
+        points.push_back(historyPoint(startAge - i));
+    }
+    return points;
+}
+
+std::vector<float> ScopeControl::spectrum(size_t transformSize) const {
+    auto windowPoints = std::min(transformSize, _validPoints);
+
+    // a Hann window keeps loud frequencies from smearing across the whole spectrum
+    std::vector<std::complex<float>> values(transformSize);
+    for (size_t i = 0; i < windowPoints; i++) {
+        auto point = historyPoint(windowPoints - 1 - i);
+        auto window = 0.5f - 0.5f * cosf(2 * PI * i / (transformSize - 1));
+        values[i] = (point.left + point.right) / 2 * window;
+    }
+    transform(values);
+
+    // the window halves the level of a sine, and half its energy is in the mirrored bins that aren't returned
+    auto scale = 4.f / transformSize;
+    std::vector<float> magnitudes;
+    magnitudes.reserve(transformSize / 2 + 1);
+    for (size_t bin = 0; bin <= transformSize / 2; bin++) {
+        auto magnitude = std::abs(values[bin]) * scale;
+        magnitudes.push_back(20 * log10f(std::max(magnitude, 1e-6f)));
+    }
+    return magnitudes;
+}
+
+ScopeControlPoint ScopeControl::historyPoint(size_t age) const {
+    return _history[(_historyEnd + SCOPE_CONTROL_BUFFER_SIZE - 1 - age) % SCOPE_CONTROL_BUFFER_SIZE];
+}
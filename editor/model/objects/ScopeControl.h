@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Control.h"
+
+namespace AxiomModel {
+
+    // Must match `SCOPE_BUFFER_SIZE` in the compiler.
+    constexpr size_t SCOPE_CONTROL_BUFFER_SIZE = 4096;
+
+    struct ScopeControlPoint {
+        float left;
+        float right;
+    };
+
+    // The UI data of a scope control. The audio thread writes a point every `decimation` samples, and only moves
+    // `writeIndex` past a point once it's been written (with a release store), so the editor can read it without
+    // locking anything.
+    struct ScopeControlCapture {
+        std::atomic<uint32_t> writeIndex;
+        std::atomic<uint32_t> decimation;
+        uint32_t decimationCounter;
+        alignas(8) ScopeControlPoint points[SCOPE_CONTROL_BUFFER_SIZE];
+    };
+
+    class ScopeControl : public Control {
+    public:
+        enum class DisplayMode { WAVEFORM, SPECTRUM };
+
+        AxiomCommon::Event<> captureChanged;
+        AxiomCommon::Event<DisplayMode> displayModeChanged;
+        AxiomCommon::Event<uint32_t> decimationChanged;
+
+        ScopeControl(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size, bool selected, QString name,
+                     bool showName, const QUuid &exposerUuid, const QUuid &exposingUuid, ModelRoot *root);
+
+        static std::unique_ptr<ScopeControl> create(const QUuid &uuid, const QUuid &parentUuid, QPoint pos, QSize size,
+                                                    bool selected, QString name, bool showName,
+                                                    const QUuid &exposerUuid, const QUuid &exposingUuid,
+                                                    ModelRoot *root);
+
+        QString debugName() override;
+
+        void doRuntimeUpdate() override;
+
+        void restoreState() override;
+
+        ScopeControlCapture *getCapture() const;
+
+        DisplayMode displayMode() const { return _displayMode; }
+
+        void setDisplayMode(DisplayMode displayMode);
+
+        uint32_t decimation() const { return _decimation; }
+
+        void setDecimation(uint32_t decimation);
+
+        float triggerLevel() const { return _triggerLevel; }
+
+        void setTriggerLevel(float triggerLevel) { _triggerLevel = triggerLevel; }
+
+        // Returns the last `pointCount` points that have been captured, lined up so the left channel rises through
+        // the trigger level at the start if it does anywhere in the history.
+        std::vector<ScopeControlPoint> waveform(size_t pointCount) const;
+
+        // Returns the magnitude in decibels of each frequency in the last `transformSize` points, averaged across both
+        // channels. `transformSize` must be a power of two no larger than the capture buffer.
+        std::vector<float> spectrum(size_t transformSize) const;
+
+    private:
+        DisplayMode _displayMode = DisplayMode::WAVEFORM;
+        uint32_t _decimation = 1;
+        float _triggerLevel = 0;
+
+        // Points are copied out of the capture buffer on each runtime update, so the history survives the buffer
+        // moving when the patch is rebuilt.
+        std::vector<ScopeControlPoint> _history;
+        size_t _historyEnd = 0;
+        size_t _validPoints = 0;
+        ScopeControlCapture *_lastCapture = nullptr;
+        uint32_t _lastWriteIndex = 0;
+
+        ScopeControlPoint historyPoint(size_t age) const;
+    };
+}
@@ -14,6 +14,7 @@
 #include "../objects/NumControl.h"
 #include "../objects/PortalControl.h"
 #include "../objects/RootSurface.h"
+#include "../objects/ScopeControl.h"
 #include "ValueSerializer.h"
 
 using namespace AxiomModel;
@@ -38,6 +39,8 @@ void ControlSerializer::serialize(AxiomModel::Control *control, QDataStream &str
         serializePortal(portal, stream);
     else if (auto graph = dynamic_cast<GraphControl *>(control))
         serializeGraph(graph, stream);
+    else if (auto scope = dynamic_cast<ScopeControl *>(control))
+        serializeScope(scope, stream);
     else
         unreachable;
 }
@@ -115,6 +118,9 @@ std::unique_ptr<Control> ControlSerializer::deserialize(QDataStream &stream, uin
     case Control::ControlType::GRAPH:
         return deserializeGraph(stream, version, uuid, parentUuid, pos, size, selected, std::move(name), showName,
                                 exposerUuid, exposingUuid, ref, root);
+    case Control::ControlType::SCOPE:
+        return deserializeScope(stream, version, uuid, parentUuid, pos, size, selected, std::move(name), showName,
+                                exposerUuid, exposingUuid, ref, root);
     default:
         unreachable;
     }
@@ -152,6 +158,7 @@ void ControlSerializer::serializeNum(AxiomModel::NumControl *control, QDataStrea
     stream << control->maxValue();
     stream << control->step();
     ValueSerializer::serializeNum(control->value(), stream);
+    stream << control->isFixed();
 }
 
 std::unique_ptr<NumControl> ControlSerializer::deserializeNum(QDataStream &stream, uint32_t version, const QUuid &uuid,
@@ -184,9 +191,16 @@ std::unique_ptr<NumControl> ControlSerializer::deserializeNum(QDataStream &strea
     }
 
     auto value = ValueSerializer::deserializeNum(stream, version);
+
+    // Fixed values were added in schema version 6.
+    bool isFixed = false;
+    if (version >= 6) {
+        stream >> isFixed;
+    }
+
     return NumControl::create(uuid, parentUuid, pos, size, selected, std::move(name), showName, exposerUuid,
                               exposingUuid, (NumControl::DisplayMode) displayModeInt, minValue, maxValue, step, value,
-                              root);
+                              isFixed, root);
 }
 
 void ControlSerializer::serializePortal(AxiomModel::PortalControl *control, QDataStream &stream) {
@@ -256,3 +270,15 @@ std::unique_ptr<GraphControl> ControlSerializer::deserializeGraph(QDataStream &s
     return GraphControl::create(uuid, parentUuid, pos, size, selected, std::move(name), showName, exposerUuid,
                                 exposingUuid, std::move(savedState), root);
 }
+
+void ControlSerializer::serializeScope(ScopeControl *control, QDataStream &stream) {}
+
+std::unique_ptr<ScopeControl> ControlSerializer::deserializeScope(QDataStream &stream, uint32_t version,
+                                                                  const QUuid &uuid, const QUuid &parentUuid,
+                                                                  QPoint pos, QSize size, bool selected, QString name,
+                                                                  bool showName, QUuid exposerUuid, QUuid exposingUuid,
+                                                                  AxiomModel::ReferenceMapper *ref,
+                                                                  AxiomModel::ModelRoot *root) {
+    return ScopeControl::create(uuid, parentUuid, pos, size, selected, std::move(name), showName, exposerUuid,
+                                exposingUuid, root);
+}
@@ -14,6 +14,7 @@ namespace AxiomModel {
     class NumControl;
     class PortalControl;
     class GraphControl;
+    class ScopeControl;
     class ReferenceMapper;
 
     namespace ControlSerializer {
@@ -59,5 +60,12 @@ namespace AxiomModel {
                                                        const QUuid &parentUuid, QPoint pos, QSize size, bool selected,
                                                        QString name, bool showName, QUuid exposerUuid,
                                                        QUuid exposingUuid, ReferenceMapper *ref, ModelRoot *root);
+
+        void serializeScope(ScopeControl *control, QDataStream &stream);
+
+        std::unique_ptr<ScopeControl> deserializeScope(QDataStream &stream, uint32_t version, const QUuid &uuid,
+                                                       const QUuid &parentUuid, QPoint pos, QSize size, bool selected,
+                                                       QString name, bool showName, QUuid exposerUuid,
+                                                       QUuid exposingUuid, ReferenceMapper *ref, ModelRoot *root);
     }
 }
@@ -1,5 +1,6 @@
 #include "HistorySerializer.h"
 
+#include <deque>
 #include <iostream>
 
 #include "../../util.h"
@@ -26,6 +27,7 @@
 #include "../actions/SetCodeAction.h"
 #include "../actions/SetGraphTagAction.h"
 #include "../actions/SetGraphTensionAction.h"
+#include "../actions/SetNumFixedAction.h"
 #include "../actions/SetNumModeAction.h"
 #include "../actions/SetNumRangeAction.h"
 #include "../actions/SetNumValueAction.h"
@@ -36,13 +38,39 @@
 
 using namespace AxiomModel;
 
-void HistorySerializer::serialize(const AxiomModel::HistoryList &history, QDataStream &stream) {
-    stream << (uint32_t) history.stackPos();
-    stream << (uint32_t) history.stack().size();
-    for (const auto &action : history.stack()) {
+void HistorySerializer::serialize(const AxiomModel::HistoryList &history, QDataStream &stream, size_t maxBytes) {
+    auto serializeToBuffer = [](Action *action) {
         QByteArray actionBuffer;
         QDataStream actionStream(&actionBuffer, QIODevice::WriteOnly);
-        serializeAction(action.get(), actionStream);
+        serializeAction(action, actionStream);
+        return actionBuffer;
+    };
+
+    // Keep as many actions around the current position as fit in the limit, preferring ones that can be undone over
+    // ones that can be redone. Actions are kept in one contiguous block so the stack stays consistent.
+    std::deque<QByteArray> actionBuffers;
+    size_t totalBytes = 0;
+    auto stackPos = history.stackPos();
+    auto firstAction = stackPos;
+    while (firstAction > 0) {
+        auto actionBuffer = serializeToBuffer(history.stack()[firstAction - 1].get());
+        if (totalBytes + (size_t) actionBuffer.size() > maxBytes) break;
+
+        totalBytes += (size_t) actionBuffer.size();
+        actionBuffers.push_front(std::move(actionBuffer));
+        firstAction--;
+    }
+    for (auto i = stackPos; i < history.stack().size(); i++) {
+        auto actionBuffer = serializeToBuffer(history.stack()[i].get());
+        if (totalBytes + (size_t) actionBuffer.size() > maxBytes) break;
+
+        totalBytes += (size_t) actionBuffer.size();
+        actionBuffers.push_back(std::move(actionBuffer));
+    }
+
+    stream << (uint32_t)(stackPos - firstAction);
+    stream << (uint32_t) actionBuffers.size();
+    for (const auto &actionBuffer : actionBuffers) {
         stream << actionBuffer;
     }
 }
@@ -116,6 +144,8 @@ void HistorySerializer::serializeAction(AxiomModel::Action *action, QDataStream
         serializeSetGraphTensionAction(setGraphTension, stream);
     else if (auto setNumRange = dynamic_cast<SetNumRangeAction *>(action))
         serializeSetNumRangeAction(setNumRange, stream);
+    else if (auto setNumFixed = dynamic_cast<SetNumFixedAction *>(action))
+        serializeSetNumFixedAction(setNumFixed, stream);
     else
         unreachable;
 }
@@ -176,6 +206,8 @@ std::unique_ptr<Action> HistorySerializer::deserializeAction(QDataStream &stream
         return deserializeSetGraphTensionAction(stream, version, root);
     case Action::ActionType::SET_NUM_RANGE:
         return deserializeSetNumRangeAction(stream, version, root);
+    case Action::ActionType::SET_NUM_FIXED:
+        return deserializeSetNumFixedAction(stream, version, root);
     }
 
     unreachable;
@@ -220,6 +252,7 @@ std::unique_ptr<Action> HistorySerializer::deserializeCompositeAction(QDataStrea
 void HistorySerializer::serializeDeleteObjectAction(AxiomModel::DeleteObjectAction *action, QDataStream &stream) {
     stream << action->uuid();
     stream << action->buffer();
+    stream << action->isBufferCompressed();
 }
 
 std::unique_ptr<DeleteObjectAction> HistorySerializer::deserializeDeleteObjectAction(QDataStream &stream,
@@ -229,8 +262,12 @@ std::unique_ptr<DeleteObjectAction> HistorySerializer::deserializeDeleteObjectAc
     stream >> uuid;
     QByteArray buffer;
     stream >> buffer;
+    bool isBufferCompressed = false;
+    if (version >= 6) {
+        stream >> isBufferCompressed;
+    }
 
-    return DeleteObjectAction::create(uuid, std::move(buffer), root);
+    return DeleteObjectAction::create(uuid, std::move(buffer), isBufferCompressed, root);
 }
 
 void HistorySerializer::serializeCreateCustomNodeAction(AxiomModel::CreateCustomNodeAction *action,
@@ -598,6 +635,7 @@ void HistorySerializer::serializePasteBufferAction(AxiomModel::PasteBufferAction
     stream << action->surfaceUuid();
     stream << action->isBufferFormatted();
     stream << action->buffer();
+    stream << action->isBufferCompressed();
     stream << action->usedUuids();
     stream << action->center();
 }
@@ -611,13 +649,17 @@ std::unique_ptr<PasteBufferAction> HistorySerializer::deserializePasteBufferActi
     stream >> isBufferFormatted;
     QByteArray buffer;
     stream >> buffer;
+    bool isBufferCompressed = false;
+    if (version >= 6) {
+        stream >> isBufferCompressed;
+    }
     QVector<QUuid> usedUuids;
     stream >> usedUuids;
     QPoint center;
     stream >> center;
 
-    return PasteBufferAction::create(surfaceUuid, isBufferFormatted, std::move(buffer), std::move(usedUuids), center,
-                                     root);
+    return PasteBufferAction::create(surfaceUuid, isBufferFormatted, std::move(buffer), isBufferCompressed,
+                                     std::move(usedUuids), center, root);
 }
 
 void HistorySerializer::serializeUnexposeControlAction(AxiomModel::UnexposeControlAction *action, QDataStream &stream) {
@@ -788,3 +830,22 @@ std::unique_ptr<SetNumRangeAction> HistorySerializer::deserializeSetNumRangeActi
 
     return SetNumRangeAction::create(uuid, beforeMin, beforeMax, beforeStep, afterMin, afterMax, afterStep, root);
 }
+
+void HistorySerializer::serializeSetNumFixedAction(AxiomModel::SetNumFixedAction *action, QDataStream &stream) {
+    stream << action->uuid();
+    stream << action->beforeVal();
+    stream << action->afterVal();
+}
+
+std::unique_ptr<SetNumFixedAction> HistorySerializer::deserializeSetNumFixedAction(QDataStream &stream,
+                                                                                   uint32_t version,
+                                                                                   AxiomModel::ModelRoot *root) {
+    QUuid uuid;
+    stream >> uuid;
+    bool beforeVal;
+    stream >> beforeVal;
+    bool afterVal;
+    stream >> afterVal;
+
+    return SetNumFixedAction::create(uuid, beforeVal, afterVal, root);
+}
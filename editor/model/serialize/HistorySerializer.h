@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QDataStream>
+#include <cstdint>
 #include <memory>
 
 #include "../HistoryList.h"
@@ -32,9 +33,12 @@ namespace AxiomModel {
     class SetGraphTagAction;
     class SetGraphTensionAction;
     class SetNumRangeAction;
+    class SetNumFixedAction;
 
     namespace HistorySerializer {
-        void serialize(const HistoryList &history, QDataStream &stream);
+        // Writes out the history, trimming actions furthest from the current position so no more than maxBytes of
+        // actions are written.
+        void serialize(const HistoryList &history, QDataStream &stream, size_t maxBytes = SIZE_MAX);
 
         HistoryList deserialize(QDataStream &stream, uint32_t version, ModelRoot *root);
 
@@ -159,5 +163,10 @@ namespace AxiomModel {
 
         std::unique_ptr<SetNumRangeAction> deserializeSetNumRangeAction(QDataStream &stream, uint32_t version,
                                                                         ModelRoot *root);
+
+        void serializeSetNumFixedAction(SetNumFixedAction *action, QDataStream &stream);
+
+        std::unique_ptr<SetNumFixedAction> deserializeSetNumFixedAction(QDataStream &stream, uint32_t version,
+                                                                        ModelRoot *root);
     }
 }
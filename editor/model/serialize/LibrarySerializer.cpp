@@ -69,3 +69,10 @@ std::unique_ptr<LibraryEntry> LibrarySerializer::deserializeEntry(QDataStream &s
     return LibraryEntry::create(std::move(name), baseUuid, modificationUuid, modificationDateTime, std::move(tags),
                                 std::move(root));
 }
+
+void LibrarySerializer::deserializeEntryUuids(QDataStream &stream, QUuid *baseUuidOut, QUuid *modificationUuidOut) {
+    QString name;
+    stream >> name;
+    stream >> *baseUuidOut;
+    stream >> *modificationUuidOut;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QDataStream>
+#include <QtCore/QUuid>
 #include <memory>
 
 namespace AxiomModel {
@@ -18,6 +19,9 @@ namespace AxiomModel {
 
         std::unique_ptr<LibraryEntry> deserializeEntry(QDataStream &stream, uint32_t version);
 
+        // reads just enough of an entry to identify it, without deserializing its contents
+        void deserializeEntryUuids(QDataStream &stream, QUuid *baseUuidOut, QUuid *modificationUuidOut);
+
         template<class Iterator>
         void serializeEntries(uint32_t count, Iterator begin, Iterator end, QDataStream &stream) {
             stream << count;
@@ -17,10 +17,11 @@
 
 using namespace AxiomModel;
 
-void ModelObjectSerializer::serializeRoot(AxiomModel::ModelRoot *root, bool includeHistory, QDataStream &stream) {
+void ModelObjectSerializer::serializeRoot(AxiomModel::ModelRoot *root, bool includeHistory, QDataStream &stream,
+                                          size_t maxHistoryBytes) {
     serializeChunk(stream, QUuid(), AxiomCommon::dynamicCast<ModelObject *>(root->pool().sequence().sequence()));
     if (includeHistory) {
-        HistorySerializer::serialize(root->history(), stream);
+        HistorySerializer::serialize(root->history(), stream, maxHistoryBytes);
     }
 }
 
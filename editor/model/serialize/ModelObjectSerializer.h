@@ -3,6 +3,7 @@
 #include "../ModelObject.h"
 #include "common/SequenceOperators.h"
 #include <QtCore/QDataStream>
+#include <cstdint>
 #include <memory>
 
 namespace AxiomModel {
@@ -14,7 +15,8 @@ namespace AxiomModel {
         std::vector<ModelObject *> deserializeChunk(QDataStream &stream, uint32_t version, ModelRoot *root,
                                                     const QUuid &parent, ReferenceMapper *ref, bool isLibrary);
 
-        void serializeRoot(ModelRoot *root, bool includeHistory, QDataStream &stream);
+        void serializeRoot(ModelRoot *root, bool includeHistory, QDataStream &stream,
+                           size_t maxHistoryBytes = SIZE_MAX);
 
         std::unique_ptr<ModelRoot> deserializeRoot(QDataStream &stream, bool includeHistory, bool isLibrary,
                                                    uint32_t version);
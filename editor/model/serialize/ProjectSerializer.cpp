@@ -25,10 +25,13 @@ bool ProjectSerializer::readHeader(QDataStream &stream, uint64_t expectedMagic,
 }
 
 void ProjectSerializer::serialize(AxiomModel::Project *project, QDataStream &stream,
-                                  std::function<void(QDataStream &)> writeLinkedFile) {
+                                  std::function<void(QDataStream &)> writeLinkedFile, size_t maxHistoryBytes) {
     writeHeader(stream, projectSchemaMagic);
     writeLinkedFile(stream);
-    ModelObjectSerializer::serializeRoot(&project->mainRoot(), true, stream);
+    ModelObjectSerializer::serializeRoot(&project->mainRoot(), true, stream, maxHistoryBytes);
+    stream << project->parallelTasks();
+    stream << project->impulseResponses();
+    stream << project->samples();
 }
 
 std::unique_ptr<Project> ProjectSerializer::deserialize(QDataStream &stream, uint32_t *versionOut,
@@ -43,7 +46,17 @@ std::unique_ptr<Project> ProjectSerializer::deserialize(QDataStream &stream, uin
 
     auto linkedFile = getLinkedFile(stream, version);
     auto modelRoot = ModelObjectSerializer::deserializeRoot(stream, true, false, version);
-    auto project = std::make_unique<Project>(linkedFile, std::move(modelRoot));
+
+    uint32_t parallelTasks = 1;
+    QMap<uint32_t, QString> impulseResponses;
+    QMap<uint32_t, QString> samples;
+    if (version >= 6) {
+        stream >> parallelTasks;
+        stream >> impulseResponses;
+        stream >> samples;
+    }
+    auto project = std::make_unique<Project>(linkedFile, std::move(modelRoot), parallelTasks,
+                                             std::move(impulseResponses), std::move(samples));
 
     // Before schema version 5, the module library was included in the project file. To ensure modules aren't lost,
     // merge the library in.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QDataStream>
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -17,7 +18,8 @@ namespace AxiomModel {
         //                = 3 in 0.3.0
         //                = 4 in 0.3.2
         //                = 5 in 0.4.0
-        static constexpr uint32_t schemaVersion = 5;
+        //                = 6 in 0.5.0
+        static constexpr uint32_t schemaVersion = 6;
         static constexpr uint32_t minSchemaVersion = 2;
         static constexpr uint64_t projectSchemaMagic = 0x4D4F4E4144415850; // "MONADAXP"
         static constexpr uint64_t librarySchemaMagic = 0x4D4F4E414441584C; // "MONADAXL"
@@ -26,7 +28,9 @@ namespace AxiomModel {
 
         bool readHeader(QDataStream &stream, uint64_t expectedMagic, uint32_t *versionOut);
 
-        void serialize(Project *project, QDataStream &stream, std::function<void(QDataStream &)> writeLinkedFile);
+        // maxHistoryBytes limits how much of the undo history is written, with 0 leaving it out entirely.
+        void serialize(Project *project, QDataStream &stream, std::function<void(QDataStream &)> writeLinkedFile,
+                       size_t maxHistoryBytes = SIZE_MAX);
 
         std::unique_ptr<Project> deserialize(QDataStream &stream, uint32_t *versionOut,
                                              std::function<void(Library *)> importLibrary,
@@ -56,10 +56,12 @@ MidiValue ValueSerializer::deserializeMidi(QDataStream &stream, uint32_t version
         stream >> dummy;
     }
 
+    // values can have been saved with a larger capacity, so any extra events are read and dropped
+    uint8_t count;
+    stream >> count;
     MidiValue val;
-    stream >> val.count;
-    for (uint8_t i = 0; i < val.count; i++) {
-        val.events[i] = deserializeMidiEvent(stream, version);
+    for (uint8_t i = 0; i < count; i++) {
+        val.pushEvent(deserializeMidiEvent(stream, version));
     }
     return val;
 }
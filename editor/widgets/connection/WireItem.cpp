@@ -74,13 +74,18 @@ static QPointF getRealPos(size_t index, QPointF routePos, const std::deque<QPoin
 }
 
 void WireItem::updateRoute(const std::deque<QPoint> &route, const std::vector<AxiomModel::LineIndex> &lineIndices) {
+    setPath(routePath(wire->startPos(), wire->endPos(), route, lineIndices));
+}
+
+QPainterPath WireItem::routePath(const QPointF &startPos, const QPointF &endPos, const std::deque<QPoint> &route,
+                                 const std::vector<AxiomModel::LineIndex> &lineIndices) {
     QPainterPath path;
 
     auto halfNodeSize =
         QPointF(NodeSurfaceCanvas::nodeGridSize.width() / 2, NodeSurfaceCanvas::nodeGridSize.height() / 2);
 
-    auto firstPos = getRealPos(0, NodeSurfaceCanvas::nodeRealPos(wire->startPos()), route, lineIndices);
-    auto lastPos = getRealPos(route.size() - 1, NodeSurfaceCanvas::nodeRealPos(wire->endPos()), route, lineIndices);
+    auto firstPos = getRealPos(0, NodeSurfaceCanvas::nodeRealPos(startPos), route, lineIndices);
+    auto lastPos = getRealPos(route.size() - 1, NodeSurfaceCanvas::nodeRealPos(endPos), route, lineIndices);
 
     if (route.size() <= 2 && firstPos.x() != lastPos.x() && firstPos.y() != lastPos.y()) {
         path.moveTo(firstPos);
@@ -115,7 +120,7 @@ void WireItem::updateRoute(const std::deque<QPoint> &route, const std::vector<Ax
         }
     }
 
-    setPath(path);
+    return path;
 }
 
 void WireItem::setIsActive(bool active) {
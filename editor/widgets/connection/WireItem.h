@@ -23,6 +23,9 @@ namespace AxiomGui {
 
         void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
+        static QPainterPath routePath(const QPointF &startPos, const QPointF &endPos, const std::deque<QPoint> &route,
+                                      const std::vector<AxiomModel::LineIndex> &lineIndices);
+
     private slots:
 
         void triggerUpdate();
@@ -21,6 +21,7 @@
 #include "editor/model/ModelRoot.h"
 #include "editor/model/Project.h"
 #include "editor/model/actions/CompositeAction.h"
+#include "editor/model/actions/SetNumFixedAction.h"
 #include "editor/model/actions/SetNumModeAction.h"
 #include "editor/model/actions/SetNumRangeAction.h"
 #include "editor/model/actions/SetNumValueAction.h"
@@ -46,6 +47,9 @@ NumControlItem::NumControlItem(NumControl *control, NodeSurfaceCanvas *canvas, M
     control->connections().events().itemRemoved().connect(this, &NumControlItem::triggerUpdate);
 
     connect(&showValueTimer, &QTimer::timeout, this, &NumControlItem::showValueExpired);
+
+    scrollEndTimer.setSingleShot(true);
+    connect(&scrollEndTimer, &QTimer::timeout, this, &NumControlItem::scrollEnded);
 }
 
 QRegularExpression numRegex("^\\s*(-?[e\\d\\.]+)\\s*([kmgt])*?(v|a|q|hz|b|beat|beats|ms|s|samples|sample|μ|db)?\\s*$",
@@ -203,6 +207,7 @@ void NumControlItem::mousePressEvent(QGraphicsSceneMouseEvent *event) {
             SetNumValueAction::create(control->uuid(), cv, control->value(), control->root()));
     } else if (!isDragging) {
         isDragging = true;
+        control->beginValueChange();
         beforeDragVal = control->value();
         beforeDragNormalizedVal = clampValue(getNormalizedValue());
         mouseStartPoint = event->pos();
@@ -262,6 +267,7 @@ void NumControlItem::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
             control->root()->history().append(
                 SetNumValueAction::create(control->uuid(), beforeDragVal, control->value(), control->root()));
         }
+        control->endValueChange();
     }
 }
 
@@ -271,6 +277,10 @@ void NumControlItem::wheelEvent(QGraphicsSceneWheelEvent *event) {
         return;
     }
 
+    // scrolling has no end event, so the change is ended once it's been idle for a moment
+    control->beginValueChange();
+    scrollEndTimer.start(500);
+
     auto oldValue = control->value();
     auto numClicks = event->delta() / 120.f;
 
@@ -331,6 +341,9 @@ void NumControlItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *event) {
     menu.addSeparator();
     auto setRangeAction = menu.addAction("Set &Range...");
     auto setStepAction = menu.addAction("Set &Step...");
+    auto fixedAction = menu.addAction("&Fixed Value");
+    fixedAction->setCheckable(true);
+    fixedAction->setChecked(control->isFixed());
     menu.addSeparator();
     buildMenuEnd(menu);
 
@@ -354,6 +367,9 @@ void NumControlItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *event) {
         editNumRange(false, event->scenePos());
     } else if (selectedAction == setStepAction) {
         editNumRange(true, event->scenePos());
+    } else if (selectedAction == fixedAction) {
+        control->root()->history().append(
+            SetNumFixedAction::create(control->uuid(), control->isFixed(), !control->isFixed(), control->root()));
     }
 }
 
@@ -388,6 +404,10 @@ void NumControlItem::showValueExpired() {
     update();
 }
 
+void NumControlItem::scrollEnded() {
+    control->endValueChange();
+}
+
 void NumControlItem::setValue(NumValue value) {
     if (value != control->value()) {
         control->root()->history().append(
@@ -66,6 +66,8 @@ namespace AxiomGui {
 
         void showValueExpired();
 
+        void scrollEnded();
+
     private:
         bool isDragging = false;
         bool isShowingValue = false;
@@ -74,6 +76,7 @@ namespace AxiomGui {
         bool dragIsSpreading = false;
         QImage _plugImage;
         QTimer showValueTimer;
+        QTimer scrollEndTimer;
         AxiomModel::NumValue beforeDragVal;
         AxiomModel::NumValue beforeDragNormalizedVal;
         QPointF mouseStartPoint;
@@ -0,0 +1,146 @@
+#include "ScopeControlItem.h"
+
+#include <QtGui/QPainter>
+#include <QtWidgets/QGraphicsSceneMouseEvent>
+#include <QtWidgets/QMenu>
+#include <cmath>
+
+#include "../CommonColors.h"
+#include "editor/model/objects/ScopeControl.h"
+
+using namespace AxiomGui;
+using namespace AxiomModel;
+
+static constexpr size_t SPECTRUM_TRANSFORM_SIZE = 1024;
+static constexpr float SPECTRUM_MIN_DECIBELS = -90;
+
+static std::vector<std::pair<QString, ScopeControl::DisplayMode>> modes = {
+    std::make_pair("&Waveform", ScopeControl::DisplayMode::WAVEFORM),
+    std::make_pair("&Spectrum", ScopeControl::DisplayMode::SPECTRUM)};
+
+static std::vector<std::pair<QString, uint32_t>> decimations = {
+    std::make_pair("Every Sample", 1),      std::make_pair("Every 2 Samples", 2),
+    std::make_pair("Every 4 Samples", 4),   std::make_pair("Every 8 Samples", 8),
+    std::make_pair("Every 16 Samples", 16), std::make_pair("Every 64 Samples", 64),
+    std::make_pair("Every 256 Samples", 256)};
+
+ScopeControlItem::ScopeControlItem(AxiomModel::ScopeControl *control, NodeSurfaceCanvas *canvas)
+    : ControlItem(control, canvas), control(control) {
+    control->captureChanged.connect(this, &ScopeControlItem::triggerUpdate);
+    control->displayModeChanged.connect(this, &ScopeControlItem::triggerUpdate);
+    control->decimationChanged.connect(this, &ScopeControlItem::triggerUpdate);
+}
+
+QRectF ScopeControlItem::useBoundingRect() const {
+    return drawBoundingRect().marginsRemoved(QMarginsF(3, 3, 3, 3));
+}
+
+QPainterPath ScopeControlItem::controlPath() const {
+    QPainterPath path;
+    path.addRect(useBoundingRect());
+    return path;
+}
+
+void ScopeControlItem::paintControl(QPainter *painter) {
+    auto rect = useBoundingRect();
+    painter->fillRect(rect, QBrush(QColor::fromRgb(10, 10, 10)));
+
+    painter->save();
+    painter->setClipRect(rect);
+    painter->setRenderHint(QPainter::Antialiasing);
+    switch (control->displayMode()) {
+    case ScopeControl::DisplayMode::WAVEFORM:
+        paintWaveform(painter, rect);
+        break;
+    case ScopeControl::DisplayMode::SPECTRUM:
+        paintSpectrum(painter, rect);
+        break;
+    }
+    painter->restore();
+}
+
+void ScopeControlItem::contextMenuEvent(QGraphicsSceneContextMenuEvent *event) {
+    event->accept();
+
+    QMenu menu;
+    buildMenuStart(menu);
+
+    auto modeMenu = menu.addMenu("&Display as...");
+    for (const auto &modePair : modes) {
+        auto action = modeMenu->addAction(modePair.first);
+        action->setCheckable(true);
+        action->setChecked(control->displayMode() == modePair.second);
+
+        connect(action, &QAction::triggered, [this, modePair]() { control->setDisplayMode(modePair.second); });
+    }
+
+    auto decimationMenu = menu.addMenu("&Capture...");
+    for (const auto &decimationPair : decimations) {
+        auto action = decimationMenu->addAction(decimationPair.first);
+        action->setCheckable(true);
+        action->setChecked(control->decimation() == decimationPair.second);
+
+        connect(action, &QAction::triggered,
+                [this, decimationPair]() { control->setDecimation(decimationPair.second); });
+    }
+
+    menu.addSeparator();
+    buildMenuEnd(menu);
+
+    menu.exec(event->screenPos());
+}
+
+void ScopeControlItem::paintWaveform(QPainter *painter, QRectF rect) {
+    auto centerY = rect.center().y();
+    painter->setPen(QPen(QColor(40, 40, 40)));
+    painter->drawLine(QPointF(rect.left(), centerY), QPointF(rect.right(), centerY));
+
+    // one point per pixel, with values between -1 and 1 filling the height
+    auto points = control->waveform((size_t) rect.width());
+    if (points.size() < 2) return;
+
+    auto halfHeight = rect.height() / 2;
+    auto xStep = rect.width() / (points.size() - 1);
+    QPainterPath leftPath;
+    QPainterPath rightPath;
+    for (size_t i = 0; i < points.size(); i++) {
+        auto x = rect.left() + i * xStep;
+        auto leftPoint = QPointF(x, centerY - points[i].left * halfHeight);
+        auto rightPoint = QPointF(x, centerY - points[i].right * halfHeight);
+        if (i == 0) {
+            leftPath.moveTo(leftPoint);
+            rightPath.moveTo(rightPoint);
+        } else {
+            leftPath.lineTo(leftPoint);
+            rightPath.lineTo(rightPoint);
+        }
+    }
+
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(QPen(CommonColors::numNormal));
+    painter->drawPath(rightPath);
+    painter->setPen(QPen(CommonColors::numActive));
+    painter->drawPath(leftPath);
+}
+
+void ScopeControlItem::paintSpectrum(QPainter *painter, QRectF rect) {
+    // the FFT is done here on the UI thread, so the audio thread only ever has to capture points
+    auto magnitudes = control->spectrum(SPECTRUM_TRANSFORM_SIZE);
+
+    // frequencies are spread logarithmically, skipping the DC bin
+    auto logBinCount = logf((float) magnitudes.size() - 1);
+    QPainterPath path;
+    path.moveTo(rect.bottomLeft());
+    for (size_t bin = 1; bin < magnitudes.size(); bin++) {
+        auto x = rect.left() + logf((float) bin) / logBinCount * rect.width();
+        auto level = std::max(0.f, 1 - magnitudes[bin] / SPECTRUM_MIN_DECIBELS);
+        path.lineTo(QPointF(x, rect.bottom() - std::min(level, 1.f) * rect.height()));
+    }
+    path.lineTo(rect.bottomRight());
+
+    auto fillColor = CommonColors::numNormal;
+    fillColor.setAlpha(100);
+    painter->setBrush(QBrush(fillColor));
+    painter->setPen(QPen(CommonColors::numActive));
+    painter->drawPath(path);
+}
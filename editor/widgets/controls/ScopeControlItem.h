@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ControlItem.h"
+
+namespace AxiomModel {
+    class ScopeControl;
+}
+
+namespace AxiomGui {
+
+    class ScopeControlItem : public ControlItem {
+    public:
+        AxiomModel::ScopeControl *control;
+
+        ScopeControlItem(AxiomModel::ScopeControl *control, NodeSurfaceCanvas *canvas);
+
+    protected:
+        bool showLabelInCenter() const override { return false; }
+
+        QRectF useBoundingRect() const override;
+
+        QPainterPath controlPath() const override;
+
+        void paintControl(QPainter *painter) override;
+
+        void contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
+
+    private:
+        void paintWaveform(QPainter *painter, QRectF rect);
+
+        void paintSpectrum(QPainter *painter, QRectF rect);
+    };
+}
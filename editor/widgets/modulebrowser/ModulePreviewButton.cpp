@@ -4,15 +4,13 @@
 #include <QtGui/QContextMenuEvent>
 #include <QtGui/QDrag>
 #include <QtWidgets/QFileDialog>
-#include <QtWidgets/QGraphicsView>
 #include <QtWidgets/QGridLayout>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QMessageBox>
 
-#include "../node/NodeItem.h"
 #include "../windows/MainWindow.h"
 #include "../windows/ModulePropertiesWindow.h"
-#include "ModulePreviewCanvas.h"
+#include "ModuleThumbnailCache.h"
 #include "editor/model/Library.h"
 #include "editor/model/LibraryEntry.h"
 #include "editor/model/objects/ModuleSurface.h"
@@ -23,8 +21,9 @@
 using namespace AxiomGui;
 
 ModulePreviewButton::ModulePreviewButton(MainWindow *window, AxiomModel::Library *library,
-                                         AxiomModel::LibraryEntry *entry, QWidget *parent)
-    : QFrame(parent), window(window), library(library), _entry(entry) {
+                                         AxiomModel::LibraryEntry *entry, ModuleThumbnailCache *thumbnails,
+                                         QWidget *parent)
+    : QFrame(parent), window(window), library(library), _entry(entry), thumbnails(thumbnails) {
     setFixedWidth(110);
 
     auto mainLayout = new QGridLayout(this);
@@ -38,6 +37,11 @@ ModulePreviewButton::ModulePreviewButton(MainWindow *window, AxiomModel::Library
     image->setMargin(0);
     image->setContentsMargins(0, 0, 0, 0);
 
+    // keep the layout stable until the thumbnail has been loaded
+    QPixmap placeholder(ModuleThumbnailCache::thumbnailSize);
+    placeholder.fill(QColor(17, 17, 17));
+    image->setPixmap(placeholder);
+
     label = new QLabel(this);
     label->setObjectName("label");
     mainLayout->addWidget(label, 1, 0);
@@ -52,12 +56,22 @@ ModulePreviewButton::ModulePreviewButton(MainWindow *window, AxiomModel::Library
     library->activeTagChanged.connect(this, &ModulePreviewButton::updateIsVisible);
     library->activeSearchChanged.connect(this, &ModulePreviewButton::updateIsVisible);
 
-    entry->root()->history().stackChanged.connect(this, &ModulePreviewButton::updateImage);
+    // Thumbnails are only requested once we're painted, so entries that are scrolled out of view or filtered out
+    // don't get rendered. If the entry changes while it's visible, the repaint will request a new thumbnail.
+    entry->changed.connect(this, [this]() { update(); });
+    thumbnails->thumbnailReady.connect(this, &ModulePreviewButton::setThumbnail);
 
-    updateImage();
     updateIsVisible();
 }
 
+void ModulePreviewButton::paintEvent(QPaintEvent *event) {
+    QFrame::paintEvent(event);
+
+    if (thumbnailKey != _entry->modificationUuid()) {
+        thumbnails->request(_entry, devicePixelRatioF());
+    }
+}
+
 void ModulePreviewButton::mousePressEvent(QMouseEvent *event) {
     QFrame::mousePressEvent(event);
 
@@ -172,34 +186,12 @@ void ModulePreviewButton::updateIsVisible() {
     setVisible(hasTag && hasSearch);
 }
 
-void ModulePreviewButton::updateImage() {
-    ModulePreviewCanvas canvas(_entry->rootSurface(), window->runtime());
-    QGraphicsView view(&canvas);
-    view.setInteractive(false);
-    view.setRenderHint(QPainter::Antialiasing);
-    view.setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    view.setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    view.setFixedSize(100, 100);
-    view.setStyleSheet("* { border: none; }");
-
-    // figure out the bounding box size of the scene
-    QRectF boundingRect;
-    for (const auto &item : view.scene()->items()) {
-        if (auto node = dynamic_cast<NodeItem *>(item)) {
-            auto br = node->drawBoundingRect();
-            br.moveTopLeft(node->scenePos());
-            boundingRect = boundingRect.united(br);
-        }
-    }
-    view.setSceneRect(boundingRect);
+void ModulePreviewButton::setThumbnail(const QUuid &key, const QImage &thumbnail) {
+    if (key != _entry->modificationUuid() || key == thumbnailKey) return;
 
-    // figure out correct scaling with some padding
-    auto viewWidth = view.width() - 30;
-    auto viewHeight = view.height() - 30;
-    auto scaleFactor = boundingRect.width() > boundingRect.height() ? viewWidth / boundingRect.width()
-                                                                    : viewHeight / boundingRect.height();
-    view.centerOn(boundingRect.center());
-    view.scale(scaleFactor, scaleFactor);
+    // the previous thumbnail won't be used again, so there's no point keeping it around
+    if (!thumbnailKey.isNull()) thumbnails->discard(thumbnailKey);
 
-    image->setPixmap(view.grab());
+    thumbnailKey = key;
+    image->setPixmap(QPixmap::fromImage(thumbnail));
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QtCore/QUuid>
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QLabel>
 
@@ -15,16 +16,20 @@ namespace AxiomGui {
 
     class MainWindow;
 
+    class ModuleThumbnailCache;
+
     class ModulePreviewButton : public QFrame, public AxiomCommon::TrackedObject {
         Q_OBJECT
 
     public:
         explicit ModulePreviewButton(MainWindow *window, AxiomModel::Library *library, AxiomModel::LibraryEntry *entry,
-                                     QWidget *parent = nullptr);
+                                     ModuleThumbnailCache *thumbnails, QWidget *parent = nullptr);
 
         AxiomModel::LibraryEntry *entry() { return _entry; }
 
     protected:
+        void paintEvent(QPaintEvent *event) override;
+
         void mousePressEvent(QMouseEvent *event) override;
 
         void mouseDoubleClickEvent(QMouseEvent *event) override;
@@ -35,6 +40,8 @@ namespace AxiomGui {
         MainWindow *window;
         AxiomModel::Library *library;
         AxiomModel::LibraryEntry *_entry;
+        ModuleThumbnailCache *thumbnails;
+        QUuid thumbnailKey;
         QLabel *image;
         QLabel *label;
 
@@ -42,6 +49,6 @@ namespace AxiomGui {
 
         void updateIsVisible();
 
-        void updateImage();
+        void setThumbnail(const QUuid &key, const QImage &thumbnail);
     };
 }
@@ -1,5 +1,8 @@
 #include "ModulePreviewList.h"
 
+#include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
+
 #include "../layouts/FlowLayout.h"
 #include "ModulePreviewButton.h"
 #include "editor/model/Library.h"
@@ -9,16 +12,22 @@
 using namespace AxiomGui;
 
 ModulePreviewList::ModulePreviewList(MainWindow *window, AxiomModel::Library *library, QWidget *parent)
-    : QScrollArea(parent), window(window), library(library) {
+    : QScrollArea(parent), window(window), library(library),
+      thumbnails(QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("thumbnails")) {
     setStyleSheet(AxiomUtil::loadStylesheet(":/styles/ModulePreviewList.qss"));
 
     auto widget = new QWidget(this);
     layout = new FlowLayout(this, 0, 0, 0, &sorter);
 
+    std::set<QUuid> thumbnailKeys;
     for (const auto &entry : library->entries()) {
         addEntry(entry);
+        thumbnailKeys.insert(entry->modificationUuid());
     }
 
+    // clean up thumbnails left over from entries that have since changed or been removed
+    thumbnails.prune(thumbnailKeys);
+
     library->entryAdded.connect(this, &ModulePreviewList::addEntry);
 
     widget->setLayout(layout);
@@ -27,7 +36,7 @@ ModulePreviewList::ModulePreviewList(MainWindow *window, AxiomModel::Library *li
 }
 
 void ModulePreviewList::addEntry(AxiomModel::LibraryEntry *entry) {
-    auto widget = new ModulePreviewButton(window, library, entry, this);
+    auto widget = new ModulePreviewButton(window, library, entry, &thumbnails, this);
     widget->setObjectName("preview-button");
     layout->addWidget(widget);
     entry->removed.connect(this, [this, widget]() {
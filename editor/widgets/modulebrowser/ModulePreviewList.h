@@ -3,6 +3,7 @@
 #include <QtWidgets/QScrollArea>
 
 #include "../layouts/FlowLayout.h"
+#include "ModuleThumbnailCache.h"
 #include "common/TrackedObject.h"
 
 namespace AxiomModel {
@@ -34,6 +35,7 @@ namespace AxiomGui {
         Sorter sorter;
         MainWindow *window;
         AxiomModel::Library *library;
+        ModuleThumbnailCache thumbnails;
         FlowLayout *layout;
     };
 }
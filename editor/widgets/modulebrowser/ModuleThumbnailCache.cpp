@@ -0,0 +1,231 @@
+#include "ModuleThumbnailCache.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QRunnable>
+#include <QtGui/QPainter>
+#include <functional>
+
+#include "../CommonColors.h"
+#include "../connection/WireItem.h"
+#include "../node/NodeItem.h"
+#include "../surface/NodeSurfaceCanvas.h"
+#include "editor/model/LibraryEntry.h"
+#include "editor/model/objects/Connection.h"
+#include "editor/model/objects/Control.h"
+#include "editor/model/objects/ControlSurface.h"
+#include "editor/model/objects/ModuleSurface.h"
+#include "editor/model/objects/Node.h"
+#include "editor/model/objects/NodeSurface.h"
+
+using namespace AxiomGui;
+using namespace AxiomModel;
+
+const QSize ModuleThumbnailCache::thumbnailSize = QSize(100, 100);
+
+static const int THUMBNAIL_PADDING = 30;
+
+ModuleThumbnailSnapshot ModuleThumbnailSnapshot::capture(AxiomModel::NodeSurface *surface) {
+    ModuleThumbnailSnapshot snapshot;
+
+    for (const auto &node : surface->nodes().sequence()) {
+        NodeShape shape;
+        shape.rect = QRectF(NodeSurfaceCanvas::nodeRealPos(node->pos()), NodeSurfaceCanvas::nodeRealSize(node->size()));
+
+        switch (node->nodeType()) {
+        case Node::NodeType::PORTAL_NODE:
+        case Node::NodeType::CUSTOM_NODE:
+            shape.fillColor = CommonColors::customNodeNormal;
+            shape.headerColor = CommonColors::customNodeSelected;
+            shape.outlineColor = CommonColors::customNodeBorder;
+            break;
+        case Node::NodeType::GROUP_NODE:
+            shape.fillColor = CommonColors::groupNodeNormal;
+            shape.headerColor = CommonColors::groupNodeSelected;
+            shape.outlineColor = CommonColors::groupNodeBorder;
+            break;
+        }
+
+        if (node->isInErrorState()) {
+            shape.fillColor = CommonColors::errorNodeNormal;
+            shape.outlineColor = CommonColors::errorNodeBorder;
+        }
+
+        shape.outlineWidth = node->isExtracted() ? 3 : 1;
+        shape.nameAbove = false;
+        shape.name = node->name();
+
+        if (node->controls().value()) {
+            auto controlSurface = *node->controls().value();
+            shape.nameAbove = controlSurface->controlsOnTopRow();
+
+            for (const auto &control : controlSurface->controls().sequence()) {
+                ControlShape controlShape;
+                controlShape.rect = QRectF(shape.rect.topLeft() + NodeSurfaceCanvas::controlRealPos(control->pos()),
+                                           NodeSurfaceCanvas::controlRealSize(control->size()));
+                controlShape.color = control->wireType() == ConnectionWire::WireType::NUM ? CommonColors::numNormal
+                                                                                            : CommonColors::midiNormal;
+                snapshot.controls.push_back(controlShape);
+            }
+        }
+
+        snapshot.bounds = snapshot.bounds.united(shape.rect);
+        snapshot.nodes.push_back(std::move(shape));
+    }
+
+    for (const auto &connection : surface->connections().sequence()) {
+        if (!connection->wire().value()) continue;
+        auto &wire = *connection->wire().value();
+        wire->wireGrid()->tryFlush();
+
+        auto wireColor = CommonColors::disabledNormal;
+        if (wire->enabled()) {
+            wireColor =
+                wire->wireType() == ConnectionWire::WireType::NUM ? CommonColors::numNormal : CommonColors::midiNormal;
+        }
+        snapshot.wires.push_back(
+            {WireItem::routePath(wire->startPos(), wire->endPos(), wire->route(), wire->lineIndices()), wireColor});
+    }
+
+    return snapshot;
+}
+
+QImage ModuleThumbnailSnapshot::render(QSize size, qreal devicePixelRatio) const {
+    QImage image(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(QColor(17, 17, 17));
+    if (bounds.isEmpty()) return image;
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // scale the surface to fit with some padding, keeping it centered
+    auto viewWidth = size.width() - THUMBNAIL_PADDING;
+    auto viewHeight = size.height() - THUMBNAIL_PADDING;
+    auto scaleFactor = bounds.width() > bounds.height() ? viewWidth / bounds.width() : viewHeight / bounds.height();
+    painter.translate(size.width() / 2., size.height() / 2.);
+    painter.scale(scaleFactor, scaleFactor);
+    painter.translate(-bounds.center());
+
+    for (const auto &wire : wires) {
+        QPen pen(QColor(20, 20, 20), 4);
+        pen.setJoinStyle(Qt::MiterJoin);
+        painter.setPen(pen);
+        painter.drawPath(wire.path);
+
+        pen.setColor(wire.color);
+        pen.setWidth(2);
+        painter.setPen(pen);
+        painter.drawPath(wire.path);
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    for (const auto &node : nodes) {
+        painter.setPen(QPen(node.outlineColor, node.outlineWidth));
+        painter.setBrush(QBrush(node.fillColor));
+        painter.drawRect(node.rect);
+
+        if (node.nameAbove) {
+            painter.setPen(QPen(QColor(100, 100, 100)));
+            auto textBound = QRectF(node.rect.topLeft() - QPointF(0, NodeItem::textOffset),
+                                    QSizeF(node.rect.width(), NodeItem::textOffset));
+            painter.drawText(textBound, Qt::AlignLeft | Qt::AlignTop, node.name);
+        } else {
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(node.headerColor);
+            auto headerBr = node.rect;
+            headerBr.setHeight(NodeSurfaceCanvas::controlGridSize.height());
+            headerBr.setTopLeft(headerBr.topLeft() + QPointF(1, 1));
+            painter.drawRect(headerBr);
+            painter.setPen(QColor(200, 200, 200));
+            headerBr.setLeft(headerBr.left() + 8);
+            painter.drawText(headerBr, Qt::AlignLeft | Qt::AlignVCenter, node.name);
+        }
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(Qt::NoBrush);
+    for (const auto &control : controls) {
+        painter.setPen(QPen(control.color, 2));
+        painter.drawRoundedRect(control.rect.adjusted(2, 2, -2, -2), 3, 3);
+    }
+
+    return image;
+}
+
+class ThumbnailTask : public QRunnable {
+public:
+    using FinishedCallback = std::function<void(QImage)>;
+
+    ThumbnailTask(ModuleThumbnailSnapshot snapshot, QString path, qreal devicePixelRatio, FinishedCallback finished)
+        : snapshot(std::move(snapshot)), path(std::move(path)), devicePixelRatio(devicePixelRatio),
+          finished(std::move(finished)) {}
+
+    void run() override {
+        QImage image(path);
+        if (image.isNull()) {
+            image = snapshot.render(ModuleThumbnailCache::thumbnailSize, devicePixelRatio);
+            image.save(path, "PNG");
+        } else {
+            image.setDevicePixelRatio(devicePixelRatio);
+        }
+        finished(std::move(image));
+    }
+
+private:
+    ModuleThumbnailSnapshot snapshot;
+    QString path;
+    qreal devicePixelRatio;
+    FinishedCallback finished;
+};
+
+ModuleThumbnailCache::ModuleThumbnailCache(QString directory) : directory(std::move(directory)) {
+    QDir().mkpath(this->directory);
+}
+
+ModuleThumbnailCache::~ModuleThumbnailCache() {
+    // wait for tasks to finish so none of them post back to a dead context
+    pool.clear();
+    pool.waitForDone();
+}
+
+void ModuleThumbnailCache::request(AxiomModel::LibraryEntry *entry, qreal devicePixelRatio) {
+    auto key = entry->modificationUuid();
+    if (!pendingKeys.insert(key).second) return;
+
+    // The snapshot is captured here since the model can only be accessed from the UI thread. Capturing is cheap
+    // compared to rendering, so we don't bother checking the disk first.
+    auto snapshot = ModuleThumbnailSnapshot::capture(entry->rootSurface());
+    auto finished = [this, key](QImage image) {
+        QMetaObject::invokeMethod(&context, [this, key, image]() { finishRequest(key, image); }, Qt::QueuedConnection);
+    };
+    pool.start(new ThumbnailTask(std::move(snapshot), thumbnailPath(key, devicePixelRatio), devicePixelRatio,
+                                 std::move(finished)));
+}
+
+void ModuleThumbnailCache::discard(const QUuid &key) {
+    QDir thumbnailDir(directory);
+    for (const auto &fileName : thumbnailDir.entryList({"*.png"}, QDir::Files)) {
+        if (QUuid(fileName.section('@', 0, 0)) == key) {
+            QFile::remove(thumbnailDir.filePath(fileName));
+        }
+    }
+}
+
+void ModuleThumbnailCache::prune(const std::set<QUuid> &keepKeys) {
+    QDir thumbnailDir(directory);
+    for (const auto &fileName : thumbnailDir.entryList({"*.png"}, QDir::Files)) {
+        if (keepKeys.find(QUuid(fileName.section('@', 0, 0))) == keepKeys.end()) {
+            QFile::remove(thumbnailDir.filePath(fileName));
+        }
+    }
+}
+
+QString ModuleThumbnailCache::thumbnailPath(const QUuid &key, qreal devicePixelRatio) const {
+    return QDir(directory).filePath(QString("%1@%2x.png").arg(key.toString()).arg(devicePixelRatio));
+}
+
+void ModuleThumbnailCache::finishRequest(QUuid key, QImage image) {
+    pendingKeys.erase(key);
+    thumbnailReady(key, image);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+#include <QtCore/QUuid>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+#include <QtGui/QPainterPath>
+#include <set>
+#include <vector>
+
+#include "common/Event.h"
+#include "common/TrackedObject.h"
+
+namespace AxiomModel {
+    class NodeSurface;
+
+    class LibraryEntry;
+}
+
+namespace AxiomGui {
+
+    // A geometry-only copy of a surface, with just enough information to draw a thumbnail of it. Unlike the surface
+    // itself this doesn't reference the model, so it can be rendered on a background thread.
+    struct ModuleThumbnailSnapshot {
+        struct NodeShape {
+            QRectF rect;
+            QColor fillColor;
+            QColor headerColor;
+            QColor outlineColor;
+            int outlineWidth;
+            bool nameAbove;
+            QString name;
+        };
+
+        struct ControlShape {
+            QRectF rect;
+            QColor color;
+        };
+
+        struct WireShape {
+            QPainterPath path;
+            QColor color;
+        };
+
+        std::vector<NodeShape> nodes;
+        std::vector<ControlShape> controls;
+        std::vector<WireShape> wires;
+        QRectF bounds;
+
+        static ModuleThumbnailSnapshot capture(AxiomModel::NodeSurface *surface);
+
+        QImage render(QSize size, qreal devicePixelRatio) const;
+    };
+
+    // Thumbnails are stored on disk keyed by the entry's modification UUID, so they only need to be rendered again
+    // after the entry has changed. Loading and rendering both happen on a thread pool, with thumbnailReady being
+    // emitted on the UI thread when the image is available.
+    class ModuleThumbnailCache : public AxiomCommon::TrackedObject {
+    public:
+        AxiomCommon::Event<const QUuid &, const QImage &> thumbnailReady;
+
+        static const QSize thumbnailSize;
+
+        explicit ModuleThumbnailCache(QString directory);
+
+        ~ModuleThumbnailCache() override;
+
+        void request(AxiomModel::LibraryEntry *entry, qreal devicePixelRatio);
+
+        void discard(const QUuid &key);
+
+        // removes thumbnails on disk that don't belong to any of the provided keys
+        void prune(const std::set<QUuid> &keepKeys);
+
+    private:
+        QString directory;
+        QObject context;
+        QThreadPool pool;
+        std::set<QUuid> pendingKeys;
+
+        QString thumbnailPath(const QUuid &key, qreal devicePixelRatio) const;
+
+        void finishRequest(QUuid key, QImage image);
+    };
+}
@@ -32,6 +32,7 @@
 #include "editor/model/objects/PortalControl.h"
 #include "editor/model/objects/PortalNode.h"
 #include "editor/model/objects/RootSurface.h"
+#include "editor/model/objects/ScopeControl.h"
 #include "editor/model/serialize/ModelObjectSerializer.h"
 #include "editor/model/serialize/ProjectSerializer.h"
 #include "editor/widgets/controls/ExtractControlItem.h"
@@ -39,6 +40,7 @@
 #include "editor/widgets/controls/MidiControlItem.h"
 #include "editor/widgets/controls/NumControlItem.h"
 #include "editor/widgets/controls/PortalControlItem.h"
+#include "editor/widgets/controls/ScopeControlItem.h"
 
 using namespace AxiomGui;
 using namespace AxiomModel;
@@ -363,6 +365,8 @@ void NodeItem::addControl(Control *control) {
         item = new PortalControlItem(outputControl, canvas);
     } else if (auto graphControl = dynamic_cast<GraphControl *>(control)) {
         item = new GraphControlItem(graphControl, canvas);
+    } else if (auto scopeControl = dynamic_cast<ScopeControl *>(control)) {
+        item = new ScopeControlItem(scopeControl, canvas);
     }
 
     assert(item);
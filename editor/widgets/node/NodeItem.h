@@ -22,6 +22,8 @@ namespace AxiomGui {
         Q_OBJECT
 
     public:
+        static const int textOffset = 15;
+
         NodeSurfaceCanvas *canvas;
 
         MaximCompiler::Runtime *runtime;
@@ -80,7 +82,5 @@ namespace AxiomGui {
     private:
         bool isDragging = false;
         QPointF mouseStartPoint;
-
-        static const int textOffset = 15;
     };
 }
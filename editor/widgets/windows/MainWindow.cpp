@@ -3,10 +3,14 @@
 #include <QIODevice>
 #include <QStandardPaths>
 #include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QStringBuilder>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
+#include <QtWidgets/QActionGroup>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QLineEdit>
 #include <QtWidgets/QMenuBar>
 #include <QtWidgets/QMessageBox>
@@ -23,6 +27,7 @@
 #include "AboutWindow.h"
 #include "editor/AxiomApplication.h"
 #include "editor/backend/AudioBackend.h"
+#include "editor/compiler/ProjectExporter.h"
 #include "editor/model/Library.h"
 #include "editor/model/LibraryEntry.h"
 #include "editor/model/PoolOperators.h"
@@ -35,7 +40,8 @@
 using namespace AxiomGui;
 
 MainWindow::MainWindow(AxiomBackend::AudioBackend *backend)
-    : _backend(backend), _runtime(true, true), libraryLock(globalLibraryLockPath()) {
+    : _backend(backend), _runtime(true, true), libraryLock(globalLibraryLockPath()),
+      libraryStore(globalLibraryStorePath()) {
     setCentralWidget(nullptr);
     setWindowTitle(tr(VER_PRODUCTNAME_STR));
     setWindowIcon(QIcon(":/application.ico"));
@@ -48,8 +54,26 @@ MainWindow::MainWindow(AxiomBackend::AudioBackend *backend)
 
     auto startTime = std::chrono::high_resolution_clock::now();
     lockGlobalLibrary();
-    // load the library - if the file does not exist, use an empty project
-    auto library = loadGlobalLibrary();
+    // load the library - if the store doesn't exist yet, migrate from the old single-file library, or if that doesn't
+    // exist either, use an empty library
+    std::unique_ptr<AxiomModel::Library> library;
+    if (libraryStore.exists()) {
+        library = libraryStore.load();
+    } else {
+        library = loadGlobalLibrary();
+
+        // The store names each entry's file after its base UUID, but entries in the old library could share one (or
+        // all have a null one), so those are given fresh UUIDs to stop them overwriting each other.
+        if (library) {
+            std::set<QUuid> seenUuids;
+            for (const auto &entry : library->entries()) {
+                if (entry->baseUuid().isNull() || seenUuids.count(entry->baseUuid())) {
+                    entry->setBaseUuid(QUuid::createUuid());
+                }
+                seenUuids.insert(entry->baseUuid());
+            }
+        }
+    }
     if (!library) {
         library = std::make_unique<AxiomModel::Library>();
     }
@@ -73,13 +97,18 @@ MainWindow::MainWindow(AxiomBackend::AudioBackend *backend)
     saveDebounceTimer.setInterval(500);
     connect(&saveDebounceTimer, &QTimer::timeout, this, &MainWindow::triggerLibraryChangeDebounce);
 
-    globalLibraryWatcher.addPath(globalLibraryFilePath());
-    connect(&globalLibraryWatcher, &QFileSystemWatcher::fileChanged, this, &MainWindow::triggerLibraryReload);
+    globalLibraryWatcher.addPath(globalLibraryStorePath());
+    connect(&globalLibraryWatcher, &QFileSystemWatcher::directoryChanged, this, &MainWindow::triggerLibraryReload);
 
     loadDebounceTimer.setSingleShot(true);
     loadDebounceTimer.setInterval(500);
     connect(&loadDebounceTimer, &QTimer::timeout, this, &MainWindow::triggerLibraryReloadDebounce);
 
+    // freezing the runtime rebuilds the whole patch, so it's only done once editing has stopped for a while
+    freezeDebounceTimer.setSingleShot(true);
+    freezeDebounceTimer.setInterval(3000);
+    connect(&freezeDebounceTimer, &QTimer::timeout, this, &MainWindow::triggerFreezeDebounce);
+
     _modulePanel = std::make_unique<ModuleBrowserPanel>(this, _library.get(), this);
     dockManager->addDockWidget(ads::BottomDockWidgetArea, _modulePanel.get());
 
@@ -116,6 +145,24 @@ MainWindow::MainWindow(AxiomBackend::AudioBackend *backend)
     editMenu->addAction(GlobalActions::editSelectAll);
     editMenu->addSeparator();
 
+    // offer thread counts up to the number of cores, the project's runtime is rebuilt when one is picked
+    auto parallelMenu = editMenu->addMenu(tr("&Parallel Processing"));
+    _parallelTasksGroup = new QActionGroup(this);
+    for (uint32_t parallelTasks = 1; parallelTasks == 1 || parallelTasks <= (uint32_t) QThread::idealThreadCount();
+         parallelTasks *= 2) {
+        auto action = parallelMenu->addAction(parallelTasks == 1 ? tr("Off") : tr("%1 Threads").arg(parallelTasks));
+        action->setCheckable(true);
+        action->setData(parallelTasks);
+        _parallelTasksGroup->addAction(action);
+    }
+    connect(_parallelTasksGroup, &QActionGroup::triggered, this,
+            [this](QAction *action) { _project->setParallelTasks(action->data().toUInt()); });
+    auto impulseResponseAction = editMenu->addAction(tr("Load &Impulse Response..."));
+    connect(impulseResponseAction, &QAction::triggered, this, &MainWindow::loadImpulseResponse);
+    auto sampleAction = editMenu->addAction(tr("Load &Sample..."));
+    connect(sampleAction, &QAction::triggered, this, &MainWindow::loadSample);
+    editMenu->addSeparator();
+
     editMenu->addAction(GlobalActions::editPreferences);
 
     _viewMenu = menuBar()->addMenu(tr("&View"));
@@ -247,9 +294,19 @@ void MainWindow::setProject(std::unique_ptr<AxiomModel::Project> project) {
         _modulePanel->close();
     }
 
-    // attach the backend and our runtime
+    // attach the backend and our runtime, the runtime picks up the project's thread count when it's attached
     _project->attachBackend(_backend);
+    {
+        auto lock = _project->mainRoot().lockRuntime();
+        runtime()->setParallelTasks(_project->parallelTasks());
+    }
     _project->mainRoot().attachRuntime(runtime());
+    _project->loadImpulseResponses();
+    _project->loadSamples();
+    _project->mainRoot().configurationChanged.connect([this]() { freezeDebounceTimer.start(); });
+    freezeDebounceTimer.start();
+    updateParallelTasksMenu(_project->parallelTasks());
+    _project->parallelTasksChanged.connect(this, &MainWindow::updateParallelTasksMenu);
 
     // find root surface and show it
     auto defaultSurface =
@@ -272,6 +329,12 @@ void MainWindow::setProject(std::unique_ptr<AxiomModel::Project> project) {
     _project->isDirtyChanged.connect([this](bool isDirty) { updateWindowTitle(_project->linkedFile(), isDirty); });
 }
 
+void MainWindow::updateParallelTasksMenu(uint32_t parallelTasks) {
+    for (const auto &action : _parallelTasksGroup->actions()) {
+        action->setChecked(action->data().toUInt() == parallelTasks);
+    }
+}
+
 QString MainWindow::globalLibraryLockPath() {
     return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("library.lock");
 }
@@ -280,6 +343,10 @@ QString MainWindow::globalLibraryFilePath() {
     return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("library.axl");
 }
 
+QString MainWindow::globalLibraryStorePath() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("library");
+}
+
 void MainWindow::lockGlobalLibrary() {
     if (isLibraryLocked) return;
     isLibraryLocked = true;
@@ -358,15 +425,7 @@ std::unique_ptr<AxiomModel::Library> MainWindow::loadDefaultLibrary() {
 }
 
 void MainWindow::saveGlobalLibrary() {
-    QFile file(globalLibraryFilePath());
-    if (!file.open(QIODevice::WriteOnly)) {
-        return;
-    }
-
-    QDataStream stream(&file);
-    AxiomModel::ProjectSerializer::writeHeader(stream, AxiomModel::ProjectSerializer::librarySchemaMagic);
-    AxiomModel::LibrarySerializer::serialize(_library.get(), stream);
-    file.close();
+    libraryStore.save(_library.get());
 }
 
 void MainWindow::triggerLibraryChanged() {
@@ -380,8 +439,6 @@ void MainWindow::triggerLibraryChanged() {
 }
 
 void MainWindow::triggerLibraryChangeDebounce() {
-    didJustSaveLibrary = true;
-
     std::cout << "Saving module library after internal change" << std::endl;
     saveGlobalLibrary();
     unlockGlobalLibrary();
@@ -392,27 +449,24 @@ void MainWindow::triggerLibraryReload() {
 }
 
 void MainWindow::triggerLibraryReloadDebounce() {
-    // ignore any changes if they were caused by the library being saved
-    if (didJustSaveLibrary) {
-        didJustSaveLibrary = false;
-        return;
-    }
-
     isLoadingLibrary = true;
-    std::cout << "Reloading module library after filesystem change" << std::endl;
+    std::cout << "Syncing module library after filesystem change" << std::endl;
 
+    // changes caused by our own saves are picked up here too, but since the store only reads in entries that are
+    // different to ours they're cheap to ignore
     lockGlobalLibrary();
-    auto library = loadGlobalLibrary();
-    if (library) {
-        _library->import(library.get(), [](AxiomModel::LibraryEntry *, AxiomModel::LibraryEntry *) {
-            return AxiomModel::Library::ConflictResolution::KEEP_NEW;
-        });
-    }
+    libraryStore.sync(_library.get());
     unlockGlobalLibrary();
 
     isLoadingLibrary = false;
 }
 
+void MainWindow::triggerFreezeDebounce() {
+    if (_project) {
+        _project->mainRoot().freezeRuntime();
+    }
+}
+
 void MainWindow::saveProjectTo(const QString &path) {
     QFile file(path);
     if (!file.open(QIODevice::WriteOnly)) {
@@ -479,13 +533,70 @@ void MainWindow::openProject() {
 }
 
 void MainWindow::exportProject() {
-    /*project()->rootSurface()->saveValue();
-    MaximRuntime::Exporter exporter(runtime->ctx(), &runtime->libModule());
-    exporter.addRuntime(runtime, "definition");
-    std::error_code err;
-    llvm::raw_fd_ostream dest("output.o", err, llvm::sys::fs::F_None);
-    exporter.exportObject(dest, 2, 2);
-    project()->rootSurface()->restoreValue();*/
+    auto selectedFile = QFileDialog::getSaveFileName(this, "Export Project", QString(),
+                                                     tr("Object Files (*.o *.obj);;All Files (*.*)"));
+    if (selectedFile.isNull()) return;
+
+    QMessageBox profileBox(QMessageBox::Question, "Export Project",
+                           "Should the exported code be optimized for size or for speed?");
+    auto sizeBtn = profileBox.addButton("Size", QMessageBox::AcceptRole);
+    auto speedBtn = profileBox.addButton("Speed", QMessageBox::AcceptRole);
+    profileBox.addButton(QMessageBox::Cancel);
+    profileBox.setDefaultButton(sizeBtn);
+    profileBox.exec();
+
+    MaximCompiler::ProjectExporter::Profile profile;
+    if (profileBox.clickedButton() == sizeBtn) {
+        profile = MaximCompiler::ProjectExporter::Profile::SIZE;
+    } else if (profileBox.clickedButton() == speedBtn) {
+        profile = MaximCompiler::ProjectExporter::Profile::SPEED;
+    } else {
+        return;
+    }
+
+    // the header is written next to the object, with the same name
+    QFileInfo objectInfo(selectedFile);
+    auto headerPath = objectInfo.dir().filePath(objectInfo.completeBaseName() + ".h");
+
+    QString exportError;
+    if (!MaximCompiler::ProjectExporter::exportProject(runtime(), _project->rootSurface(), profile, selectedFile,
+                                                       headerPath, &exportError)) {
+        QMessageBox(QMessageBox::Critical, "Failed to export project", exportError, QMessageBox::Ok).exec();
+    }
+}
+
+void MainWindow::loadImpulseResponse() {
+    bool slotSelected = false;
+    auto maxSlot = (int) MaximCompiler::ImpulseResponse::slotCount() - 1;
+    auto slot = QInputDialog::getInt(this, "Load Impulse Response", "Slot to load into:", 0, 0, maxSlot, 1,
+                                     &slotSelected);
+    if (!slotSelected) return;
+
+    auto selectedFile = QFileDialog::getOpenFileName(this, "Load Impulse Response",
+                                                     _project->impulseResponses().value((uint32_t) slot),
+                                                     tr("WAV Files (*.wav);;All Files (*.*)"));
+    if (selectedFile.isNull()) return;
+
+    QString loadError;
+    if (!_project->setImpulseResponse((uint32_t) slot, selectedFile, &loadError)) {
+        QMessageBox(QMessageBox::Critical, "Failed to load impulse response", loadError, QMessageBox::Ok).exec();
+    }
+}
+
+void MainWindow::loadSample() {
+    bool slotSelected = false;
+    auto maxSlot = (int) MaximCompiler::Sample::slotCount() - 1;
+    auto slot = QInputDialog::getInt(this, "Load Sample", "Slot to load into:", 0, 0, maxSlot, 1, &slotSelected);
+    if (!slotSelected) return;
+
+    auto selectedFile = QFileDialog::getOpenFileName(this, "Load Sample", _project->samples().value((uint32_t) slot),
+                                                     tr("WAV Files (*.wav);;All Files (*.*)"));
+    if (selectedFile.isNull()) return;
+
+    QString loadError;
+    if (!_project->setSample((uint32_t) slot, selectedFile, &loadError)) {
+        QMessageBox(QMessageBox::Critical, "Failed to load sample", loadError, QMessageBox::Ok).exec();
+    }
 }
 
 void MainWindow::importLibrary() {
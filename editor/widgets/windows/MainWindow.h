@@ -9,6 +9,7 @@
 
 #include "editor/backend/AudioBackend.h"
 #include "editor/compiler/interface/Runtime.h"
+#include "editor/model/LibraryStore.h"
 #include "editor/model/Project.h"
 
 namespace AxiomModel {
@@ -19,6 +20,8 @@ namespace AxiomModel {
     class NodeSurface;
 }
 
+class QActionGroup;
+
 namespace ads{
     class CDockManager;
 }
@@ -51,6 +54,8 @@ namespace AxiomGui {
 
         static QString globalLibraryFilePath();
 
+        static QString globalLibraryStorePath();
+
         void lockGlobalLibrary();
 
         void unlockGlobalLibrary();
@@ -85,6 +90,10 @@ namespace AxiomGui {
 
         void exportProject();
 
+        void loadImpulseResponse();
+
+        void loadSample();
+
         void importLibrary();
 
         void exportLibrary();
@@ -101,15 +110,18 @@ namespace AxiomGui {
         std::unique_ptr<HistoryPanel> _historyPanel;
         std::unique_ptr<ModuleBrowserPanel> _modulePanel;
         QMenu *_viewMenu;
+        QActionGroup *_parallelTasksGroup;
         QLockFile libraryLock;
         bool isLibraryLocked = false;
+        AxiomModel::LibraryStore libraryStore;
         QTimer saveDebounceTimer;
         QTimer loadDebounceTimer;
+        QTimer freezeDebounceTimer;
         QFileSystemWatcher globalLibraryWatcher;
 
-        bool didJustSaveLibrary = false;
         bool isLoadingLibrary = false;
 
+        // the global library used to be stored in a single file, which is only read now to migrate it to the store
         static std::unique_ptr<AxiomModel::Library> loadGlobalLibrary();
         static std::unique_ptr<AxiomModel::Library> loadDefaultLibrary();
 
@@ -123,6 +135,8 @@ namespace AxiomGui {
 
         void updateWindowTitle(const QString &linkedFile, bool isDirty);
 
+        void updateParallelTasksMenu(uint32_t parallelTasks);
+
         bool isInputFieldFocused() const;
 
     private slots:
@@ -131,5 +145,7 @@ namespace AxiomGui {
         void triggerLibraryReload();
 
         void triggerLibraryReloadDebounce();
+
+        void triggerFreezeDebounce();
     };
 }
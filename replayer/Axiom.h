@@ -3,11 +3,8 @@
 
 #include "AxiomCommon.h"
 
-#define AXIOM_SAMPLERATE 44100
-#define AXIOM_BPM 60
-
-#define AXIOM_INPUT_PORTAL 0
-#define AXIOM_OUTPUT_PORTAL 1
+// Portal indexes, the sample rate and BPM of an exported project are defined in the header generated alongside its
+// object file.
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,6 +13,11 @@ void __cdecl axiom_init();
 void __cdecl axiom_packup();
 void __cdecl axiom_generate();
 
+// Runs `frames` samples. `buffers` is indexed by portal: audio portals point to `frames` AxiomNums that are read before
+// (inputs and automation) or written after (outputs) each sample, MIDI inputs point to a single AxiomMidi that is
+// consumed on the first sample. Null buffers are skipped.
+void __cdecl axiom_generate_block(uint32_t frames, void *const *buffers);
+
 void *__cdecl axiom_get_portal(uint32_t id);
 
 void __cdecl axiom_midi_push(AxiomMidi *midi, AxiomMidiEvent event);
@@ -27,7 +27,17 @@ typedef struct {
 
 typedef struct {
     uint8_t event_count;
-    AxiomMidiEvent events[16];
+    AxiomMidiEvent events[16]; // must match MIDI_EVENT_COUNT in the compiler
 } AxiomMidi;
 
+typedef enum : uint8_t { AXIOM_PORTAL_INPUT, AXIOM_PORTAL_OUTPUT, AXIOM_PORTAL_AUTOMATION } AxiomPortalType;
+
+typedef enum : uint8_t { AXIOM_PORTAL_AUDIO, AXIOM_PORTAL_MIDI } AxiomPortalValue;
+
+typedef struct {
+    const char *name;
+    AxiomPortalType type;
+    AxiomPortalValue value;
+} AxiomPortalInfo;
+
 #endif